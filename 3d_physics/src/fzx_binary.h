@@ -0,0 +1,72 @@
+#pragma once
+#ifndef FZX_BINARY_H
+#define FZX_BINARY_H
+
+#include <cstdint>
+
+//binary .fzxb layout, native (little) endian.
+//  every record is all 4 byte fields so there is no padding,
+//  and each block is contiguous so loads are just bulk copies.
+//
+//  FZXBHeader
+//  for each shape:
+//    FZXBShape
+//    FZXBParticle[num_p]
+//    FZXBConstraint[num_c]
+//    FZXBSpring[num_s]
+//    FZXBTriangle[num_t]
+//    FZXBEdge[num_e]
+//  for each joint:
+//    FZXBJoint
+//    int32_t ix_a[num_a]
+//    int32_t ix_b[num_b]
+
+static const char FZXB_MAGIC[4]={'F', 'Z', 'X', 'B'};
+static const std::uint32_t FZXB_VERSION=1;
+
+struct FZXBHeader {
+	char magic[4];
+	std::uint32_t version;
+	std::int32_t num_shapes, num_joints;
+	float bounds_min[3], bounds_max[3];
+	float gravity[3];
+};
+
+struct FZXBShape {
+	std::int32_t num_p, num_c, num_s, num_t, num_e;
+	std::uint8_t fill[4];
+};
+
+struct FZXBParticle {
+	float x, y, z, mass;
+	std::int32_t locked;
+};
+
+struct FZXBConstraint {
+	std::int32_t a, b;
+	float rest_len;
+};
+
+struct FZXBSpring {
+	std::int32_t a, b;
+	float rest_len, stiffness, damping;
+};
+
+struct FZXBTriangle {
+	std::int32_t a, b, c;
+};
+
+struct FZXBEdge {
+	std::int32_t a, b;
+};
+
+struct FZXBJoint {
+	std::int32_t shp_a, shp_b;
+	std::int32_t num_a, num_b;
+};
+
+static_assert(sizeof(FZXBHeader)==52, "unexpected fzxb header padding");
+static_assert(sizeof(FZXBShape)==24, "unexpected fzxb shape padding");
+static_assert(sizeof(FZXBParticle)==20, "unexpected fzxb particle padding");
+static_assert(sizeof(FZXBSpring)==20, "unexpected fzxb spring padding");
+#endif
\ No newline at end of file
@@ -201,12 +201,62 @@ struct Physics3DUI : cmn::Engine3D {
 			return true;
 		}
 
+		if(cmd=="bench") {
+			int num_steps=240;
+			line_str>>num_steps;
+			if(num_steps<=0) {
+				std::cout<<"  invalid step count\n";
+				return false;
+			}
+
+			//stack of soft voxel shapes
+			Scene bench;
+			for(int i=0; i<4; i++) {
+				float y=.05f+2.05f*i;
+				Shape softbody({{-1, y, -1}, {1, y+2, 1}}, .1f, sub_time_step);
+				bench.addShape(softbody);
+			}
+			Shape ground({{-4, -1, -4}, {4, 0, 4}});
+			for(int i=0; i<ground.getNum(); i++) {
+				ground.particles[i].locked=true;
+			}
+			bench.addShape(ground);
+			bench.shrinkWrap(3);
+
+			int num_ptc=0;
+			for(const auto& s:bench.shapes) num_ptc+=s.getNum();
+
+			//time each stage separately
+			cmn::Stopwatch collide_watch, step_watch;
+			long long collide_dur=0, step_dur=0;
+			for(int i=0; i<num_steps; i++) {
+				collide_watch.start();
+				bench.handleCollisions();
+				collide_watch.stop();
+				collide_dur+=collide_watch.getMicros();
+
+				step_watch.start();
+				bench.update(sub_time_step);
+				step_watch.stop();
+				step_dur+=step_watch.getMicros();
+			}
+
+			std::cout<<
+				"  particles: "<<num_ptc<<'\n'<<
+				"  collide: "<<(collide_dur/num_steps)<<"us/step\n"<<
+				"  update: "<<(step_dur/num_steps)<<"us/step\n";
+
+			return true;
+		}
+
 		if(cmd=="import") {
 			std::string filename;
 			line_str>>filename;
 
 			try {
-				Scene new_scene=Scene::loadFromFZX(filename);
+				Scene new_scene=Scene::isBinaryFZX(filename)?
+					Scene::loadFromFZXB(filename):
+					Scene::loadFromFZX(filename);
 				scene=new_scene;
 				std::cout<<"  success!\n";
 				return true;
@@ -221,7 +271,27 @@ struct Physics3DUI : cmn::Engine3D {
 			line_str>>filename;
 
 			try {
-				scene.saveToFZX(filename);
+				if(Scene::isBinaryFZX(filename)) scene.saveToFZXB(filename);
+				else scene.saveToFZX(filename);
+				std::cout<<"  success!\n";
+				return true;
+			} catch(const std::exception& e) {
+				std::cout<<"  error: "<<e.what()<<'\n';
+				return false;
+			}
+		}
+
+		//text <-> binary
+		if(cmd=="convert") {
+			std::string src, dst;
+			line_str>>src>>dst;
+
+			try {
+				Scene conv=Scene::isBinaryFZX(src)?
+					Scene::loadFromFZXB(src):
+					Scene::loadFromFZX(src);
+				if(Scene::isBinaryFZX(dst)) conv.saveToFZXB(dst);
+				else conv.saveToFZX(dst);
 				std::cout<<"  success!\n";
 				return true;
 			} catch(const std::exception& e) {
@@ -230,6 +300,47 @@ struct Physics3DUI : cmn::Engine3D {
 			}
 		}
 
+		if(cmd=="loadbench") {
+			//~100k particles of soft voxels
+			Scene bench;
+			for(int i=0; i<4; i++) {
+				float y=3.05f*i;
+				Shape softbody({{-1.5f, y, -1.5f}, {1.5f, y+3, 1.5f}}, .1f, sub_time_step);
+				bench.addShape(softbody);
+			}
+
+			int num_ptc=0;
+			for(const auto& s:bench.shapes) num_ptc+=s.getNum();
+
+			try {
+				bench.saveToFZX("loadbench.fzx");
+				bench.saveToFZXB("loadbench.fzxb");
+
+				cmn::Stopwatch text_watch, bin_watch;
+				text_watch.start();
+				Scene text=Scene::loadFromFZX("loadbench.fzx");
+				text_watch.stop();
+				bin_watch.start();
+				Scene bin=Scene::loadFromFZXB("loadbench.fzxb");
+				bin_watch.stop();
+
+				auto text_dur=text_watch.getMicros();
+				auto bin_dur=bin_watch.getMicros();
+				std::cout<<
+					"  particles: "<<num_ptc<<'\n'<<
+					"  text: "<<text_dur<<"us ("<<(text_dur/1000.f)<<"ms)\n"<<
+					"  binary: "<<bin_dur<<"us ("<<(bin_dur/1000.f)<<"ms)\n";
+			} catch(const std::exception& e) {
+				std::cout<<"  error: "<<e.what()<<'\n';
+				return false;
+			}
+
+			std::remove("loadbench.fzx");
+			std::remove("loadbench.fzxb");
+
+			return true;
+		}
+
 		if(cmd=="keybinds") {
 			std::cout<<
 				"  ARROWS   look up, down, left, right\n"
@@ -261,8 +372,11 @@ struct Physics3DUI : cmn::Engine3D {
 			std::cout<<
 				"  clear        clears the console\n"
 				"  time         get diagnostics for each stage of game loop\n"
-				"  import       imports scene from specified file\n"
-				"  export       exports scene to specified file\n"
+				"  bench        time collisions on a large soft voxel scene\n"
+				"  import       imports scene from specified file(.fzx or .fzxb)\n"
+				"  export       exports scene to specified file(.fzx or .fzxb)\n"
+				"  convert      converts scene file between text and binary\n"
+				"  loadbench    time text vs binary loads of a large scene\n"
 				"  keybinds     which keys to press for this program?\n"
 				"  mousebinds   which buttons to press for this program?\n";
 
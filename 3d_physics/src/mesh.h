@@ -8,6 +8,10 @@
 #include <sstream>
 #include <exception>
 
+#include "cmn/obj_loader.h"
+
+#include "cmn/math/mat4_batch.h"
+
 struct Mesh {
 	std::vector<vf3d> vertices;
 	std::vector<IndexTriangle> index_tris;
@@ -29,12 +33,8 @@ struct Mesh {
 	}
 
 	void updateTriangles(const olc::Pixel& col) {
-		std::vector<vf3d> new_verts;
-		new_verts.reserve(vertices.size());
-		for(const auto& v:vertices) {
-			float w=1;
-			new_verts.push_back(matMulVec(model, v, w));
-		}
+		std::vector<vf3d> new_verts(vertices.size());
+		cmn::transformPoints(model, vertices.data(), new_verts.data(), vertices.size());
 
 		tris.clear();
 		tris.reserve(index_tris.size());
@@ -49,44 +49,21 @@ struct Mesh {
 	}
 
 	static Mesh loadFromOBJ(const std::string& filename) {
-		Mesh m;
+		cmn::OBJMesh obj;
+		if(!cmn::loadOBJCached(obj, filename)) throw std::runtime_error("invalid filename");
 
-		std::ifstream file(filename);
-		if(file.fail()) throw std::runtime_error("invalid filename");
-
-		//parse file line by line
-		std::string line;
-		while(std::getline(file, line)) {
-			std::stringstream line_str(line);
-			std::string type; line_str>>type;
-			if(type=="v") {
-				vf3d v;
-				line_str>>v.x>>v.y>>v.z;
-				m.vertices.push_back(v);
-			} else if(type=="f") {
-				std::vector<int> v_ixs;
-
-				//parse v/t/n until fail
-				int num=0;
-				for(std::string vtn; line_str>>vtn; num++) {
-					std::stringstream vtn_str(vtn);
-					int v_ix;
-					if(vtn_str>>v_ix) v_ixs.push_back(v_ix-1);
-				}
+		Mesh m;
 
-				//triangulate
-				for(int i=2; i<num; i++) {
-					m.index_tris.push_back({
-						v_ixs[0],
-						v_ixs[i-1],
-						v_ixs[i]
-						});
-				}
-			}
+		m.vertices=std::move(obj.positions);
+		m.index_tris.reserve(obj.getNumTris());
+		for(int i=0; i<obj.corners.size(); i+=3) {
+			m.index_tris.push_back({
+				obj.corners[i].v,
+				obj.corners[i+1].v,
+				obj.corners[i+2].v
+				});
 		}
 
-		file.close();
-
 		return m;
 	}
 };
@@ -0,0 +1,180 @@
+#pragma once
+#ifndef BVH_CLASS_H
+#define BVH_CLASS_H
+
+#include <vector>
+
+//for nth_element
+#include <algorithm>
+
+//bounding volume hierarchy over primitive boxes.
+//  topology is built once, then refit every step
+//  so soft bodies dont need a full rebuild.
+class BVH {
+	struct Node {
+		cmn::AABBf3 box;
+		//children if inner, prim range if leaf
+		int left=-1, right=-1;
+		int start=0, num=0;
+
+		bool isLeaf() const { return num>0; }
+	};
+
+	static const int max_leaf_sz=4;
+
+	std::vector<Node> nodes;
+	std::vector<int> prims;
+
+	//reused traversal stack
+	mutable std::vector<int> stack;
+	mutable std::vector<std::pair<int, int>> pair_stack;
+
+	static cmn::AABBf3 emptyBox() {
+		const vf3d inf(1e30f, 1e30f, 1e30f);
+		return {inf, -inf};
+	}
+
+	static void enclose(cmn::AABBf3& a, const cmn::AABBf3& b) {
+		a.fitToEnclose(b.min);
+		a.fitToEnclose(b.max);
+	}
+
+	//top down median split on longest axis
+	int buildRecursive(const std::vector<cmn::AABBf3>& boxes, int start, int num) {
+		int ix=nodes.size();
+		nodes.push_back(Node());
+
+		cmn::AABBf3 box=emptyBox(), ctr_box=emptyBox();
+		for(int i=start; i<start+num; i++) {
+			const auto& b=boxes[prims[i]];
+			enclose(box, b);
+			ctr_box.fitToEnclose(b.getCenter());
+		}
+		nodes[ix].box=box;
+
+		if(num<=max_leaf_sz) {
+			nodes[ix].start=start;
+			nodes[ix].num=num;
+			return ix;
+		}
+
+		//choose axis
+		vf3d sz=ctr_box.max-ctr_box.min;
+		int axis=0;
+		if(sz.y>sz.x) axis=1;
+		if(sz.z>(axis?sz.y:sz.x)) axis=2;
+		auto key=[&] (int p) {
+			vf3d c=boxes[p].getCenter();
+			return axis==0?c.x:axis==1?c.y:c.z;
+		};
+
+		//partition about median
+		int mid=start+num/2;
+		std::nth_element(prims.begin()+start, prims.begin()+mid, prims.begin()+start+num,
+			[&] (int a, int b) { return key(a)<key(b); }
+		);
+
+		int left=buildRecursive(boxes, start, mid-start);
+		int right=buildRecursive(boxes, mid, start+num-mid);
+		nodes[ix].left=left;
+		nodes[ix].right=right;
+		return ix;
+	}
+
+public:
+	int getNum() const {
+		return prims.size();
+	}
+
+	bool empty() const {
+		return nodes.empty();
+	}
+
+	const cmn::AABBf3& getRoot() const {
+		return nodes.front().box;
+	}
+
+	void build(const std::vector<cmn::AABBf3>& boxes) {
+		nodes.clear();
+		prims.resize(boxes.size());
+		for(int i=0; i<prims.size(); i++) prims[i]=i;
+		if(boxes.empty()) return;
+
+		nodes.reserve(2*boxes.size()/max_leaf_sz+1);
+		buildRecursive(boxes, 0, boxes.size());
+	}
+
+	//children always come after parents,
+	//  so a reverse sweep updates bottom up.
+	void refit(const std::vector<cmn::AABBf3>& boxes) {
+		for(int i=nodes.size()-1; i>=0; i--) {
+			auto& n=nodes[i];
+			n.box=emptyBox();
+			if(n.isLeaf()) {
+				for(int j=n.start; j<n.start+n.num; j++) {
+					enclose(n.box, boxes[prims[j]]);
+				}
+			} else {
+				enclose(n.box, nodes[n.left].box);
+				enclose(n.box, nodes[n.right].box);
+			}
+		}
+	}
+
+	//calls fn(prim) for every prim overlapping box.
+	//  stops early if fn returns true.
+	template<typename Fn>
+	void query(const cmn::AABBf3& box, Fn fn) const {
+		if(nodes.empty()) return;
+
+		stack.clear();
+		stack.push_back(0);
+		while(!stack.empty()) {
+			const auto& n=nodes[stack.back()];
+			stack.pop_back();
+			if(!n.box.overlaps(box)) continue;
+
+			if(n.isLeaf()) {
+				for(int j=n.start; j<n.start+n.num; j++) {
+					if(fn(prims[j])) return;
+				}
+			} else {
+				stack.push_back(n.left);
+				stack.push_back(n.right);
+			}
+		}
+	}
+
+	//calls fn(mine, theirs) for every overlapping prim pair
+	template<typename Fn>
+	void queryPairs(const BVH& o, Fn fn) const {
+		if(nodes.empty()||o.nodes.empty()) return;
+
+		pair_stack.clear();
+		pair_stack.push_back({0, 0});
+		while(!pair_stack.empty()) {
+			auto ix=pair_stack.back();
+			pair_stack.pop_back();
+			const auto& a=nodes[ix.first];
+			const auto& b=o.nodes[ix.second];
+			if(!a.box.overlaps(b.box)) continue;
+
+			if(a.isLeaf()&&b.isLeaf()) {
+				for(int i=a.start; i<a.start+a.num; i++) {
+					for(int j=b.start; j<b.start+b.num; j++) {
+						fn(prims[i], o.prims[j]);
+					}
+				}
+			}
+			//descend the other side
+			else if(a.isLeaf()) {
+				pair_stack.push_back({ix.first, b.left});
+				pair_stack.push_back({ix.first, b.right});
+			} else {
+				pair_stack.push_back({a.left, ix.second});
+				pair_stack.push_back({a.right, ix.second});
+			}
+		}
+	}
+};
+#endif
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "constraint.h"
 #include "spring.h"
+#include "bvh.h"
 
 #include "../index_triangle.h"
 
@@ -47,6 +48,10 @@ public:
 	std::vector<IndexTriangle> tris;
 	std::vector<IndexEdge> edges;
 
+	//narrow phase acceleration
+	std::vector<cmn::AABBf3> tri_boxes, edge_boxes;
+	BVH tri_bvh, edge_bvh;
+
 	olc::Pixel fill=olc::WHITE;
 
 	int id=-1;
@@ -344,6 +349,39 @@ public:
 		return box;
 	}
 
+	//refit each step, rebuild if topology changed
+	void updateBVH() {
+		const float r=Particle::rad;
+		tri_boxes.resize(tris.size());
+		for(int i=0; i<tris.size(); i++) {
+			const auto& it=tris[i];
+			const vf3d& a=particles[it.a].pos;
+			const vf3d& b=particles[it.b].pos;
+			const vf3d& c=particles[it.c].pos;
+			cmn::AABBf3 box{a, a};
+			box.fitToEnclose(b);
+			box.fitToEnclose(c);
+			box.min-=r, box.max+=r;
+			tri_boxes[i]=box;
+		}
+		if(tri_bvh.getNum()!=tris.size()) tri_bvh.build(tri_boxes);
+		else tri_bvh.refit(tri_boxes);
+
+		//pad by half so edge pairs overlap at full radius
+		edge_boxes.resize(edges.size());
+		for(int i=0; i<edges.size(); i++) {
+			const auto& ie=edges[i];
+			const vf3d& a=particles[ie.a].pos;
+			const vf3d& b=particles[ie.b].pos;
+			cmn::AABBf3 box{a, a};
+			box.fitToEnclose(b);
+			box.min-=r/2, box.max+=r/2;
+			edge_boxes[i]=box;
+		}
+		if(edge_bvh.getNum()!=edges.size()) edge_bvh.build(edge_boxes);
+		else edge_bvh.refit(edge_boxes);
+	}
+
 	float intersectRay(const vf3d& orig, const vf3d& dir) const {
 		if(getAABB().intersectRay(orig, dir)<0) return -1;
 
@@ -5,10 +5,27 @@
 #include "phys/shape.h"
 #include "phys/joint.h"
 
+#include "fzx_binary.h"
+
+#include "cmn/obj_loader.h"
+
 #include <unordered_map>
 
+//for memcpy
+#include <cstring>
+
+//tris & edges are bulk copied
+static_assert(sizeof(IndexTriangle)==sizeof(FZXBTriangle), "IndexTriangle must match fzxb layout");
+static_assert(sizeof(IndexEdge)==sizeof(FZXBEdge), "IndexEdge must match fzxb layout");
+
 class Scene {
 	int curr_id=0;
+
+	//jointed particle masks for current pair
+	std::vector<bool> skip_a, skip_b;
+
+	//padded bounds per shape, in list order
+	std::vector<cmn::AABBf3> shape_boxes;
 	
 	void copyFrom(const Scene&), clear();
 
@@ -63,40 +80,42 @@ public:
 		bounds.max=box.max+margin;
 	}
 
-	//particle-triangle collisions
-	//keep a's particles out of b's tris
-	void triCollide(Shape& shp_a, Shape& shp_b) {
-		//find joint conflicts
-		const std::list<int>* skip_ix=nullptr;
+	//mark jointed particles of both shapes
+	void fillJointMasks(const Shape& shp_a, const Shape& shp_b) {
+		skip_a.assign(shp_a.getNum(), false);
+		skip_b.assign(shp_b.getNum(), false);
 		for(const auto& j:joints) {
 			if(j.shp_a==&shp_a&&j.shp_b==&shp_b) {
-				skip_ix=&j.ix_a;
+				for(const auto& i:j.ix_a) skip_a[i]=true;
+				for(const auto& i:j.ix_b) skip_b[i]=true;
 				break;
 			}
 			if(j.shp_a==&shp_b&&j.shp_b==&shp_a) {
-				skip_ix=&j.ix_b;
+				for(const auto& i:j.ix_b) skip_a[i]=true;
+				for(const auto& i:j.ix_a) skip_b[i]=true;
 				break;
 			}
 		}
+	}
+
+	//particle-triangle collisions
+	//keep a's particles out of b's tris
+	void triCollide(Shape& shp_a, const std::vector<bool>& skip, Shape& shp_b) {
+		const cmn::AABBf3& b_box=shp_b.tri_bvh.getRoot();
 
 		//for every particle in a
 		for(int i=0; i<shp_a.getNum(); i++) {
 			//skip jointed particles
-			if(skip_ix) {
-				bool to_skip=false;
-				for(const auto& j:*skip_ix) {
-					if(j==i) {
-						to_skip=true;
-						break;
-					}
-				}
-				if(to_skip) continue;
-			}
+			if(skip[i]) continue;
 
-			//check particle against all tris
+			//skip particles nowhere near b
 			auto& ap=shp_a.particles[i];
-			for(const auto& bit:shp_b.tris) {
+			if(!b_box.contains(ap.pos)) continue;
+
+			//check particle against nearby tris
+			shp_b.tri_bvh.query({ap.pos, ap.pos}, [&] (int t) {
 				//realize triangle
+				const auto& bit=shp_b.tris[t];
 				auto& bp0=shp_b.particles[bit.a];
 				auto& bp1=shp_b.particles[bit.b];
 				auto& bp2=shp_b.particles[bit.c];
@@ -107,141 +126,120 @@ public:
 
 				//is it too close to surface?
 				float mag2=(ap.pos-close_pt).mag_sq();
-				if(mag2<Particle::rad*Particle::rad) {
-					//where should it be?
-					vf3d norm=bt.getNorm();
-					vf3d new_pt=close_pt+Particle::rad*norm;
-					vf3d delta=new_pt-ap.pos;
-
-					//find contributions
-					float m1a=1/ap.mass;
-					float m1b0=1/bp0.mass;
-					float m1b1=1/bp1.mass;
-					float m1b2=1/bp2.mass;
-					float m1t=m1a+m1b0+m1b1+m1b2;
-
-					//push apart
-					if(!ap.locked) ap.pos+=m1a/m1t*delta;
-					//barycentric weights next?
-					if(!bp0.locked) bp0.pos-=m1b0/m1t*delta;
-					if(!bp1.locked) bp1.pos-=m1b1/m1t*delta;
-					if(!bp2.locked) bp2.pos-=m1b2/m1t*delta;
-					break;
-				}
-			}
+				if(mag2>=Particle::rad*Particle::rad) return false;
+
+				//where should it be?
+				vf3d norm=bt.getNorm();
+				vf3d new_pt=close_pt+Particle::rad*norm;
+				vf3d delta=new_pt-ap.pos;
+
+				//find contributions
+				float m1a=1/ap.mass;
+				float m1b0=1/bp0.mass;
+				float m1b1=1/bp1.mass;
+				float m1b2=1/bp2.mass;
+				float m1t=m1a+m1b0+m1b1+m1b2;
+
+				//push apart
+				if(!ap.locked) ap.pos+=m1a/m1t*delta;
+				//barycentric weights next?
+				if(!bp0.locked) bp0.pos-=m1b0/m1t*delta;
+				if(!bp1.locked) bp1.pos-=m1b1/m1t*delta;
+				if(!bp2.locked) bp2.pos-=m1b2/m1t*delta;
+				return true;
+			});
 		}
 	}
 
 	//edge-edge collisions
 	//push edges apart if too close
-	void edgeCollide(Shape& shp_a, Shape& shp_b) {
-		//find joint conflicts
-		const std::list<int>* skip_ix_a=nullptr, * skip_ix_b=nullptr;
-		for(const auto& j:joints) {
-			if(j.shp_a==&shp_a&&j.shp_b==&shp_b) {
-				skip_ix_a=&j.ix_a, skip_ix_b=&j.ix_b;
-				break;
-			}
-			if(j.shp_a==&shp_b&&j.shp_b==&shp_a) {
-				skip_ix_a=&j.ix_b, skip_ix_b=&j.ix_a;
-				break;
-			}
-		}
-
-		//for every edge of the one shape
-		for(const auto& ea:shp_a.edges) {
+	void edgeCollide(Shape& shp_a, const std::vector<bool>& skip_a, Shape& shp_b, const std::vector<bool>& skip_b) {
+		//for every pair of nearby edges
+		shp_a.edge_bvh.queryPairs(shp_b.edge_bvh, [&] (int i, int j) {
 			//skip jointed edges
-			if(skip_ix_a) {
-				bool to_skip=false;
-				for(const auto& i:*skip_ix_a) {
-					if(i==ea.a||i==ea.b) {
-						to_skip=true;
-						break;
-					}
-				}
-				if(to_skip) break;
-			}
+			const auto& ea=shp_a.edges[i];
+			if(skip_a[ea.a]||skip_a[ea.b]) return;
+			const auto& eb=shp_b.edges[j];
+			if(skip_b[eb.a]||skip_b[eb.b]) return;
 
 			auto& a1=shp_a.particles[ea.a];
 			auto& a2=shp_a.particles[ea.b];
+			auto& b1=shp_b.particles[eb.a];
+			auto& b2=shp_b.particles[eb.b];
+
+			//find close points on both edges
+			vf3d u=a2.pos-a1.pos;
+			vf3d v=b2.pos-b1.pos;
+			vf3d w=a1.pos-b1.pos;
+			float a=u.dot(u);
+			float b=u.dot(v);
+			float c=v.dot(v);
+			float d=u.dot(w);
+			float e=v.dot(w);
+			float D=a*c-b*b;
+			float s, t;
+			if(std::abs(D)<1e-6f) s=0, t=b>c?d/b:e/c;
+			else {
+				s=std::max(0.f, std::min(1.f, (b*e-c*d)/D));
+				t=std::max(0.f, std::min(1.f, (a*e-b*d)/D));
+			};
+			vf3d close_a=a1.pos+s*u;
+			vf3d close_b=b1.pos+t*v;
+
+			//are they too close to eachother?
+			vf3d sub=close_a-close_b;
+			float mag_sq=sub.mag_sq();
+			if(mag_sq<Particle::rad*Particle::rad) {
+				//find contributions based on inverse mass
+				float m1a1=1/a1.mass;
+				float m1a2=1/a2.mass;
+				float m1b1=1/b1.mass;
+				float m1b2=1/b2.mass;
+				float m1t=m1a1+m1a2+m1b1+m1b2;
+
+				//calculate resolution
+				float mag=std::sqrt(mag_sq);
+				vf3d norm=sub/mag;
+				float delta=Particle::rad-mag;
+				vf3d correct=delta*norm;
+
+				//push apart
+				if(!a1.locked) a1.pos+=(1-s)*m1a1/m1t*correct;
+				if(!a2.locked) a2.pos+=s*m1a2/m1t*correct;
+				if(!b1.locked) b1.pos-=(1-t)*m1b1/m1t*correct;
+				if(!b2.locked) b2.pos-=t*m1b2/m1t*correct;
+			}
+		});
+	}
 
-			//check every edge of the other shape
-			for(const auto& eb:shp_b.edges) {
-				//skip jointed edges
-				if(skip_ix_b) {
-					bool to_skip=false;
-					for(const auto& i:*skip_ix_b) {
-						if(i==eb.a||i==eb.b) {
-							to_skip=true;
-							break;
-						}
-					}
-					if(to_skip) break;
-				}
-
-				auto& b1=shp_b.particles[eb.a];
-				auto& b2=shp_b.particles[eb.b];
-
-				//find close points on both edges
-				vf3d u=a2.pos-a1.pos;
-				vf3d v=b2.pos-b1.pos;
-				vf3d w=a1.pos-b1.pos;
-				float a=u.dot(u);
-				float b=u.dot(v);
-				float c=v.dot(v);
-				float d=u.dot(w);
-				float e=v.dot(w);
-				float D=a*c-b*b;
-				float s, t;
-				if(std::abs(D)<1e-6f) s=0, t=b>c?d/b:e/c;
-				else {
-					s=std::max(0.f, std::min(1.f, (b*e-c*d)/D));
-					t=std::max(0.f, std::min(1.f, (a*e-b*d)/D));
-				};
-				vf3d close_a=a1.pos+s*u;
-				vf3d close_b=b1.pos+t*v;
-
-				//are they too close to eachother?
-				vf3d sub=close_a-close_b;
-				float mag_sq=sub.mag_sq();
-				if(mag_sq<Particle::rad*Particle::rad) {
-					//find contributions based on inverse mass
-					float m1a1=1/a1.mass;
-					float m1a2=1/a2.mass;
-					float m1b1=1/b1.mass;
-					float m1b2=1/b2.mass;
-					float m1t=m1a1+m1a2+m1b1+m1b2;
-
-					//calculate resolution
-					float mag=std::sqrt(mag_sq);
-					vf3d norm=sub/mag;
-					float delta=Particle::rad-mag;
-					vf3d correct=delta*norm;
-
-					//push apart
-					if(!a1.locked) a1.pos+=(1-s)*m1a1/m1t*correct;
-					if(!a2.locked) a2.pos+=s*m1a2/m1t*correct;
-					if(!b1.locked) b1.pos-=(1-t)*m1b1/m1t*correct;
-					if(!b2.locked) b2.pos-=t*m1b2/m1t*correct;
-				}
+	void handleCollisions() {
+		//refit hierarchies, & take bounds from them.
+		//  shapes w/o tris still need bounds for their edges.
+		shape_boxes.clear();
+		for(auto& s:shapes) {
+			s.updateBVH();
+			if(!s.tri_bvh.empty()) shape_boxes.push_back(s.tri_bvh.getRoot());
+			else {
+				cmn::AABBf3 box=s.getAABB();
+				box.min-=Particle::rad, box.max+=Particle::rad;
+				shape_boxes.push_back(box);
 			}
 		}
-	}
 
-	void handleCollisions() {  
 		//find potential matches
-		for(auto ait=shapes.begin(); ait!=shapes.end(); ait++) {
-			for(auto bit=std::next(ait); bit!=shapes.end(); bit++) {
+		int a=0;
+		for(auto ait=shapes.begin(); ait!=shapes.end(); ait++, a++) {
+			int b=a+1;
+			for(auto bit=std::next(ait); bit!=shapes.end(); bit++, b++) {
 				//predicated by bounding box
-				cmn::AABBf3 a_box=ait->getAABB();
-				a_box.min-=Particle::rad, a_box.max+=Particle::rad;
-				cmn::AABBf3 b_box=bit->getAABB();
-				b_box.min-=Particle::rad, b_box.max+=Particle::rad;
-				if(a_box.overlaps(b_box)) {
-					triCollide(*ait, *bit);
-					triCollide(*bit, *ait);
-					edgeCollide(*ait, *bit);
-				}
+				if(!shape_boxes[a].overlaps(shape_boxes[b])) continue;
+
+				fillJointMasks(*ait, *bit);
+
+				//only the tri pass needs tris
+				if(!bit->tri_bvh.empty()) triCollide(*ait, skip_a, *bit);
+				if(!ait->tri_bvh.empty()) triCollide(*bit, skip_b, *ait);
+				edgeCollide(*ait, skip_a, *bit, skip_b);
 			}
 		}
 	}
@@ -568,105 +566,302 @@ public:
 		return scene;
 	}
 
-	static Scene loadFromOBJ(const std::string& filename) {
-		std::ifstream file(filename);
-		if(file.fail()) throw std::runtime_error("invalid filename");
+	//binary variant of saveToFZX
+	void saveToFZXB(const std::string& filename) const {
+		if(filename.empty()) throw std::runtime_error("no filename");
 
-		//parse obj file line by line
-		std::vector<Particle> particles;
-		std::vector<IndexTriangle> tris;
-		for(std::string line; std::getline(file, line);) {
-			std::stringstream line_str(line);
-			std::string type; line_str>>type;
+		//shape -> index
+		std::unordered_map<const Shape*, int> ids;
 
-			if(type=="v") {
-				//add particles
-				vf3d v;
-				line_str>>v.x>>v.y>>v.z;
-				particles.emplace_back(v);
-			} else if(type=="f") {
-				//parse v/t/n until fail
-				std::vector<int> v_ixs;
-				int num=0;
-				for(std::string vtn; line_str>>vtn; num++) {
-					std::stringstream vtn_str(vtn);
-					int v_ix;
-					if(vtn_str>>v_ix) v_ixs.push_back(v_ix-1);
-				}
+		//size everything up front
+		std::size_t total=sizeof(FZXBHeader);
+		int id=0;
+		for(const auto& shp:shapes) {
+			total+=sizeof(FZXBShape)+
+				sizeof(FZXBParticle)*shp.getNum()+
+				sizeof(FZXBConstraint)*shp.constraints.size()+
+				sizeof(FZXBSpring)*shp.springs.size()+
+				sizeof(FZXBTriangle)*shp.tris.size()+
+				sizeof(FZXBEdge)*shp.edges.size();
+			ids[&shp]=id++;
+		}
+		for(const auto& j:joints) {
+			total+=sizeof(FZXBJoint)+sizeof(std::int32_t)*(j.ix_a.size()+j.ix_b.size());
+		}
 
-				//triangulate
-				for(int i=2; i<num; i++) {
-					tris.push_back({v_ixs[0], v_ixs[i-1], v_ixs[i]});
-				}
+		std::vector<char> buffer(total);
+		char* curr=buffer.data();
+		auto write=[&] (const auto& rec) {
+			std::memcpy(curr, &rec, sizeof(rec));
+			curr+=sizeof(rec);
+		};
+
+		FZXBHeader header;
+		std::memcpy(header.magic, FZXB_MAGIC, 4);
+		header.version=FZXB_VERSION;
+		header.num_shapes=shapes.size();
+		header.num_joints=joints.size();
+		header.bounds_min[0]=bounds.min.x, header.bounds_min[1]=bounds.min.y, header.bounds_min[2]=bounds.min.z;
+		header.bounds_max[0]=bounds.max.x, header.bounds_max[1]=bounds.max.y, header.bounds_max[2]=bounds.max.z;
+		header.gravity[0]=gravity.x, header.gravity[1]=gravity.y, header.gravity[2]=gravity.z;
+		write(header);
+
+		for(const auto& shp:shapes) {
+			FZXBShape sh{
+				shp.getNum(),
+				int(shp.constraints.size()),
+				int(shp.springs.size()),
+				int(shp.tris.size()),
+				int(shp.edges.size()),
+				{shp.fill.r, shp.fill.g, shp.fill.b, 255}
+			};
+			write(sh);
+
+			for(int i=0; i<shp.getNum(); i++) {
+				const auto& p=shp.particles[i];
+				write(FZXBParticle{p.pos.x, p.pos.y, p.pos.z, p.mass, p.locked});
+			}
+			for(const auto& c:shp.constraints) {
+				write(FZXBConstraint{int(c.a-shp.particles), int(c.b-shp.particles), c.rest_len});
 			}
+			for(const auto& s:shp.springs) {
+				write(FZXBSpring{int(s.a-shp.particles), int(s.b-shp.particles), s.rest_len, s.stiffness, s.damping});
+			}
+
+			//index blocks match in memory layout
+			std::memcpy(curr, shp.tris.data(), sizeof(FZXBTriangle)*shp.tris.size());
+			curr+=sizeof(FZXBTriangle)*shp.tris.size();
+			std::memcpy(curr, shp.edges.data(), sizeof(FZXBEdge)*shp.edges.size());
+			curr+=sizeof(FZXBEdge)*shp.edges.size();
 		}
 
-		//find neighbors(adjacency list)
-		std::vector<std::unordered_set<int>> adjacency(particles.size());
-		for(const auto& t:tris) {
-			adjacency[t.a].insert(t.b), adjacency[t.a].insert(t.c);
-			adjacency[t.b].insert(t.c), adjacency[t.b].insert(t.a);
-			adjacency[t.c].insert(t.a), adjacency[t.c].insert(t.b);
+		for(const auto& j:joints) {
+			write(FZXBJoint{ids[j.shp_a], ids[j.shp_b], int(j.ix_a.size()), int(j.ix_b.size())});
+			for(const auto& ia:j.ix_a) write(std::int32_t(ia));
+			for(const auto& ib:j.ix_b) write(std::int32_t(ib));
 		}
 
-		//floodfill to find connected particle groups
-		std::vector<bool> visited(particles.size(), false);
-		std::vector<std::vector<int>> particle_groups;
-		for(int i=0; i<particles.size(); i++) {
-			if(visited[i]) continue;
+		std::ofstream file(filename, std::ios::binary);
+		if(file.fail()) throw std::runtime_error("invalid filename");
+
+		file.write(buffer.data(), buffer.size());
+		file.close();
+	}
+
+	static Scene loadFromFZXB(const std::string& filename) {
+		std::ifstream file(filename, std::ios::binary|std::ios::ate);
+		if(file.fail()) throw std::runtime_error("invalid filename");
+
+		//slurp whole file in one read
+		std::vector<char> buffer(file.tellg());
+		file.seekg(0);
+		if(!file.read(buffer.data(), buffer.size())) throw std::runtime_error("couldnt read file");
+		file.close();
+
+		//bounds checked block cursor
+		const char* curr=buffer.data();
+		const char* end=curr+buffer.size();
+		auto take=[&] (std::size_t sz) {
+			if(sz>std::size_t(end-curr)) throw std::runtime_error("unexpected end of file");
+			const char* block=curr;
+			curr+=sz;
+			return block;
+		};
+
+		FZXBHeader header;
+		std::memcpy(&header, take(sizeof(header)), sizeof(header));
+		if(std::memcmp(header.magic, FZXB_MAGIC, 4)) throw std::runtime_error("not a binary fzx file");
+		if(header.version!=FZXB_VERSION) throw std::runtime_error("unsupported fzxb version");
+		if(header.num_shapes<0) throw std::runtime_error("invalid shape count");
+		if(header.num_joints<0) throw std::runtime_error("invalid joint count");
 
-			std::vector<int> group;
-			std::stack<int> stack;
-			stack.push(i);
+		Scene scene;
+		scene.bounds.min=vf3d(header.bounds_min[0], header.bounds_min[1], header.bounds_min[2]);
+		scene.bounds.max=vf3d(header.bounds_max[0], header.bounds_max[1], header.bounds_max[2]);
+		scene.gravity=vf3d(header.gravity[0], header.gravity[1], header.gravity[2]);
 
-			while(!stack.empty()) {
-				int v=stack.top(); stack.pop();
-				if(visited[v]) continue;
+		//index -> shape
+		std::vector<Shape*> shape_ptrs;
+		for(int id=0; id<header.num_shapes; id++) {
+			FZXBShape sh;
+			std::memcpy(&sh, take(sizeof(sh)), sizeof(sh));
+
+			//check counts
+			if(sh.num_p<=0) throw std::runtime_error("invalid particle count");
+			if(sh.num_c<0) throw std::runtime_error("invalid constraint count");
+			if(sh.num_s<0) throw std::runtime_error("invalid spring count");
+			if(sh.num_t<0) throw std::runtime_error("invalid triangle count");
+			if(sh.num_e<0) throw std::runtime_error("invalid edge count");
+
+			//construct in place to avoid copying
+			scene.shapes.emplace_back(sh.num_p);
+			Shape& shp=scene.shapes.back();
+			auto valid=[&] (int i) { return i>=0&&i<sh.num_p; };
+
+			//particles
+			const auto* ps=reinterpret_cast<const FZXBParticle*>(take(sizeof(FZXBParticle)*sh.num_p));
+			for(int i=0; i<sh.num_p; i++) {
+				FZXBParticle fp;
+				std::memcpy(&fp, ps+i, sizeof(fp));
+				Particle& p=shp.particles[i];
+				p.pos=vf3d(fp.x, fp.y, fp.z);
+				p.old_pos=p.pos;
+				p.mass=fp.mass;
+				p.locked=fp.locked;
+			}
+
+			//constraints
+			const auto* cs=reinterpret_cast<const FZXBConstraint*>(take(sizeof(FZXBConstraint)*sh.num_c));
+			shp.constraints.resize(sh.num_c);
+			for(int i=0; i<sh.num_c; i++) {
+				FZXBConstraint fc;
+				std::memcpy(&fc, cs+i, sizeof(fc));
+				if(!valid(fc.a)||!valid(fc.b)) throw std::runtime_error("invalid particle index");
+				auto& c=shp.constraints[i];
+				c.a=shp.particles+fc.a;
+				c.b=shp.particles+fc.b;
+				c.rest_len=fc.rest_len;
+			}
+
+			//springs
+			const auto* ss=reinterpret_cast<const FZXBSpring*>(take(sizeof(FZXBSpring)*sh.num_s));
+			shp.springs.resize(sh.num_s);
+			for(int i=0; i<sh.num_s; i++) {
+				FZXBSpring fs;
+				std::memcpy(&fs, ss+i, sizeof(fs));
+				if(!valid(fs.a)||!valid(fs.b)) throw std::runtime_error("invalid particle index");
+				auto& s=shp.springs[i];
+				s.a=shp.particles+fs.a;
+				s.b=shp.particles+fs.b;
+				s.rest_len=fs.rest_len;
+				s.stiffness=fs.stiffness;
+				s.damping=fs.damping;
+			}
+
+			//index blocks are bulk copied, then validated
+			shp.tris.resize(sh.num_t);
+			std::memcpy(shp.tris.data(), take(sizeof(FZXBTriangle)*sh.num_t), sizeof(FZXBTriangle)*sh.num_t);
+			for(const auto& it:shp.tris) {
+				if(!valid(it.a)||!valid(it.b)||!valid(it.c)) throw std::runtime_error("invalid particle index");
+			}
+			shp.edges.resize(sh.num_e);
+			std::memcpy(shp.edges.data(), take(sizeof(FZXBEdge)*sh.num_e), sizeof(FZXBEdge)*sh.num_e);
+			for(const auto& ie:shp.edges) {
+				if(!valid(ie.a)||!valid(ie.b)) throw std::runtime_error("invalid particle index");
+			}
 
-				visited[v]=true;
-				group.push_back(v);
+			shp.fill.r=sh.fill[0];
+			shp.fill.g=sh.fill[1];
+			shp.fill.b=sh.fill[2];
 
-				for(const auto& neighbor:adjacency[v]) {
-					if(!visited[neighbor]) {
-						stack.push(neighbor);
-					}
+			shp.id=id;
+			shape_ptrs.push_back(&shp);
+		}
+		scene.curr_id=header.num_shapes;
+
+		for(int i=0; i<header.num_joints; i++) {
+			FZXBJoint fj;
+			std::memcpy(&fj, take(sizeof(fj)), sizeof(fj));
+			if(fj.shp_a<0||fj.shp_a>=header.num_shapes) throw std::runtime_error("invalid shape index");
+			if(fj.shp_b<0||fj.shp_b>=header.num_shapes) throw std::runtime_error("invalid shape index");
+			if(fj.num_a<0||fj.num_b<0) throw std::runtime_error("invalid joint count");
+
+			Joint j;
+			j.shp_a=shape_ptrs[fj.shp_a];
+			j.shp_b=shape_ptrs[fj.shp_b];
+
+			auto readIndexes=[&] (int num, const Shape* s, std::list<int>& ixs) {
+				const char* block=take(sizeof(std::int32_t)*num);
+				for(int k=0; k<num; k++) {
+					std::int32_t ix;
+					std::memcpy(&ix, block+sizeof(ix)*k, sizeof(ix));
+					if(ix<0||ix>=s->getNum()) throw std::runtime_error("invalid particle index");
+					ixs.push_back(ix);
 				}
+			};
+			readIndexes(fj.num_a, j.shp_a, j.ix_a);
+			readIndexes(fj.num_b, j.shp_b, j.ix_b);
+
+			scene.joints.push_back(j);
+		}
+
+		return scene;
+	}
+
+	//pick format by file extension
+	static bool isBinaryFZX(const std::string& filename) {
+		const std::string ext=".fzxb";
+		if(filename.size()<ext.size()) return false;
+		return filename.compare(filename.size()-ext.size(), ext.size(), ext)==0;
+	}
+
+	static Scene loadFromOBJ(const std::string& filename) {
+		cmn::OBJMesh obj;
+		if(!cmn::loadOBJCached(obj, filename)) throw std::runtime_error("invalid obj file");
+
+		std::vector<Particle> particles;
+		particles.reserve(obj.positions.size());
+		for(const auto& v:obj.positions) particles.emplace_back(v);
+		std::vector<IndexTriangle> tris;
+		tris.reserve(obj.getNumTris());
+		for(int i=0; i<obj.corners.size(); i+=3) {
+			tris.push_back({obj.corners[i].v, obj.corners[i+1].v, obj.corners[i+2].v});
+		}
+
+		//union-find to find connected particle groups
+		std::vector<int> parent(particles.size());
+		for(int i=0; i<parent.size(); i++) parent[i]=i;
+		auto find=[&] (int i) {
+			while(parent[i]!=i) {
+				//path halving
+				parent[i]=parent[parent[i]];
+				i=parent[i];
 			}
+			return i;
+		};
+		for(const auto& t:tris) {
+			int ra=find(t.a), rb=find(t.b), rc=find(t.c);
+			parent[rb]=ra;
+			parent[find(rc)]=ra;
+		}
+
+		//label groups & local indexes in one pass
+		std::vector<int> root_group(particles.size(), -1);
+		std::vector<int> group(particles.size()), local_ix(particles.size());
+		std::vector<int> group_sizes;
+		for(int i=0; i<particles.size(); i++) {
+			int r=find(i);
+			if(root_group[r]<0) {
+				root_group[r]=group_sizes.size();
+				group_sizes.push_back(0);
+			}
+			group[i]=root_group[r];
+			local_ix[i]=group_sizes[group[i]]++;
+		}
 
-			particle_groups.push_back(group);
+		//all corners share a group
+		std::vector<std::vector<IndexTriangle>> group_tris(group_sizes.size());
+		for(const auto& t:tris) {
+			group_tris[group[t.a]].push_back({local_ix[t.a], local_ix[t.b], local_ix[t.c]});
 		}
 
 		//construct shapes
 		Scene scene;
-		int id=0;
-		for(const auto& group:particle_groups) {
-			//index mapping
-			std::unordered_map<int, int> global_to_local;
-			for(int j=0; j<group.size(); j++) {
-				global_to_local[group[j]]=j;
-			}
+		std::vector<Shape> group_shapes;
+		group_shapes.reserve(group_sizes.size());
+		for(int g=0; g<group_sizes.size(); g++) group_shapes.emplace_back(group_sizes[g]);
 
-			//extract particles
-			Shape shape(group.size());
-			int i=0;
-			for(const auto& idx:group) {
-				shape.particles[i++]=particles[idx];
-			}
+		//extract particles
+		for(int i=0; i<particles.size(); i++) {
+			group_shapes[group[i]].particles[local_ix[i]]=particles[i];
+		}
+
+		for(int g=0; g<group_shapes.size(); g++) {
+			auto& shape=group_shapes[g];
 
 			shape.initConstraints();
 
-			//extract relevant tris and remap indexes
-			for(const auto& tri:tris) {
-				if(global_to_local.count(tri.a)&&
-					global_to_local.count(tri.b)&&
-					global_to_local.count(tri.c)) {
-					shape.tris.push_back({
-						global_to_local[tri.a],
-						global_to_local[tri.b],
-						global_to_local[tri.c]
-						});
-				}
-			}
+			shape.tris=std::move(group_tris[g]);
 
 			shape.initEdges();
 
@@ -675,10 +870,11 @@ public:
 			shape.fill.r=std::rand()%256;
 			shape.fill.g=std::rand()%256;
 			shape.fill.b=std::rand()%256;
-			shape.id=id++;
+			shape.id=g;
 
 			scene.shapes.push_back(shape);
 		}
+		scene.curr_id=group_shapes.size();
 
 		return scene;
 	}
@@ -8,6 +8,10 @@
 #include <fstream>
 #include <sstream>
 
+#include "cmn/obj_loader.h"
+
+#include "cmn/math/mat4_batch.h"
+
 struct IndexTriangle {
 	int a=0, b=0, c=0;
 };
@@ -33,11 +37,8 @@ struct Mesh {
 	}
 
 	void updateTriangles(const olc::Pixel& col) {
-		std::vector<vf3d> transformed;
-		for(const auto& v:vertexes) {
-			float w=1;
-			transformed.push_back(matMulVec(model, v, w));
-		}
+		std::vector<vf3d> transformed(vertexes.size());
+		cmn::transformPoints(model, vertexes.data(), transformed.data(), vertexes.size());
 		tris.clear();
 		for(const auto& it:index_tris) {
 			cmn::Triangle t{transformed[it.a], transformed[it.b], transformed[it.c]};
@@ -57,10 +58,9 @@ struct Mesh {
 	cmn::AABBf3 getAABB() const {
 		const vf3d inf(1e300, 1e300, 1e300);
 		cmn::AABBf3 box{inf, -inf};
-		for(const auto& v:vertexes) {
-			float w=1;
-			box.fitToEnclose(matMulVec(model, v, w));
-		}
+		cmn::forEachTransformedPoint(model, vertexes.data(), vertexes.size(), [&] (const vf3d& v) {
+			box.fitToEnclose(v);
+		});
 		return box;
 	}
 
@@ -78,11 +78,9 @@ struct Mesh {
 	}
 
 	bool contains(const vf3d& pt) const {
-		vf3d dir=vf3d(
-			.5f-cmn::randFloat(),
-			.5f-cmn::randFloat(),
-			.5f-cmn::randFloat()
-		).norm();
+		float r[3];
+		cmn::Random::local().fill(r, 3, .5f, -.5f);
+		vf3d dir=vf3d(r[0], r[1], r[2]).norm();
 		int num=0;
 		for(const auto& t:tris) {
 			float dist=t.intersectSeg(pt, pt+dir);
@@ -92,45 +90,24 @@ struct Mesh {
 	}
 
 	static bool loadFromOBJ(Mesh& m, const std::string& filename) {
+		cmn::OBJMesh obj;
+		if(!cmn::loadOBJCached(obj, filename)) return false;
+
 		m={};
-		
-		std::ifstream file(filename);
-		if(file.fail()) return false;
-
-		std::string line;
-		while(std::getline(file, line)) {
-			std::stringstream line_str(line);
-			std::string type; line_str>>type;
-			if(type=="v") {
-				vf3d v;
-				line_str>>v.x>>v.y>>v.z;
-				m.vertexes.push_back(v);
-			} else if(type=="f") {
-				std::vector<int> v_ixs;
-
-				//parse v/t/n until fail
-				for(std::string vtn; line_str>>vtn;) {
-					std::stringstream vtn_str(vtn);
-					int v_ix;
-					if(vtn_str>>v_ix) v_ixs.push_back(v_ix-1);
-				}
 
-				//triangulate
-				for(int i=2; i<v_ixs.size(); i++) {
-					m.index_tris.push_back({
-						v_ixs[0],
-						v_ixs[i-1],
-						v_ixs[i]
-						});
-				}
-			}
+		m.vertexes=std::move(obj.positions);
+		m.index_tris.reserve(obj.getNumTris());
+		for(int i=0; i<obj.corners.size(); i+=3) {
+			m.index_tris.push_back({
+				obj.corners[i].v,
+				obj.corners[i+1].v,
+				obj.corners[i+2].v
+				});
 		}
 
 		m.updateMatrix();
 		m.updateTriangles(olc::WHITE);
 
-		file.close();
-
 		return true;
 	}
 };
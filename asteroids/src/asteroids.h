@@ -4,6 +4,7 @@
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -61,7 +62,7 @@ class Asteroids : public cmn::SokolEngine {
 	cmn::AABBf2 screen_bounds;
 	std::vector<Asteroid> asteroids;
 	std::vector<Bullet> bullets;
-	std::vector<Particle> particles;
+	cmn::ParticlePool particles{4096};
 
 	int score=0, level=0;
 	enum State {
@@ -93,7 +94,7 @@ class Asteroids : public cmn::SokolEngine {
 		sg_pipeline_desc pip_desc{};
 		pip_desc.layout.attrs[ATTR_ascii_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
 		pip_desc.layout.attrs[ATTR_ascii_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(ascii_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(ascii_shader_desc(getBackend()));
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 		ascii_pip=sg_make_pipeline(pip_desc);
 	}
@@ -102,7 +103,7 @@ class Asteroids : public cmn::SokolEngine {
 		sg_pipeline_desc pip_desc{};
 		pip_desc.layout.attrs[ATTR_crt_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
 		pip_desc.layout.attrs[ATTR_crt_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(crt_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(crt_shader_desc(getBackend()));
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 		crt_pip=sg_make_pipeline(pip_desc);
 	}
@@ -167,7 +168,7 @@ class Asteroids : public cmn::SokolEngine {
 			//limit number of particles spawned
 			while(particle_timer<0) {
 				particle_timer+=.006f;
-				if(boosting) particles.push_back(ship.emitParticle());
+				if(boosting) ship.emitParticle(particles);
 			}
 			particle_timer-=dt;
 
@@ -230,7 +231,7 @@ class Asteroids : public cmn::SokolEngine {
 
 				//spawn particles
 				for(int k=0; k<num_ptc; k++) {
-					particles.push_back(Particle::makeRandom(pos, .7f, .7f, .7f));
+					spawnRandomParticle(particles, pos, .7f, .7f, .7f);
 				}
 
 				//finally, remove it
@@ -270,7 +271,7 @@ class Asteroids : public cmn::SokolEngine {
 					state=Lost;
 					int num_ptc=cmn::randInt(56, 84);
 					for(int i=0; i<num_ptc; i++) {
-						particles.push_back(Particle::makeRandom(ship.pos, 1, 0, 0));
+						spawnRandomParticle(particles, ship.pos, 1, 0, 0);
 					}
 				}
 			}
@@ -282,16 +283,9 @@ class Asteroids : public cmn::SokolEngine {
 		ship.update(dt);
 		ship.checkAABB(screen_bounds);
 
-		//update particles
-		for(auto it=particles.begin(); it!=particles.end(); ) {
-			auto& p=*it;
-			p.update(dt);
-
-			//"dynamically" clear those too old
-			if(p.isDead()) {
-				it=particles.erase(it);
-			} else it++;
-		}
+		//update particles & clear those too old
+		particles.integrate(dt);
+		particles.updateAges(dt);
 
 		//update bullets
 		for(auto it=bullets.begin(); it!=bullets.end(); ) {
@@ -487,11 +481,12 @@ class Asteroids : public cmn::SokolEngine {
 		static const std::string ascii=" .:-=+*#%@";
 		static const int ascii_size=ascii.length();
 
-		for(const auto& p:particles) {
+		for(int i=0; i<particles.getNum(); i++) {
 			//ramp to show how "young" or "vibrant"
-			float pct=1-p.age/p.lifespan;
+			float pct=particles.getFade(i);
 			int asi=cmn::clamp(int(ascii_size*pct), 0, ascii_size-1);
-			draw_pixel(p.pos, {p.r, p.g, p.b, ascii[asi]});
+			vf2d pos(particles.pos_x[i], particles.pos_y[i]);
+			draw_pixel(pos, {particles.r[i], particles.g[i], particles.b[i], ascii[asi]});
 		}
 	}
 
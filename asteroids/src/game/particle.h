@@ -4,37 +4,26 @@
 
 #include "cmn/math/v2d.h"
 
-#include "cmn/utils.h"
-
-struct Particle {
-	cmn::vf2d pos, vel;
-	float lifespan=0, age=0;
-
-	float r=1, g=1, b=1;
+#include "cmn/particle_pool.h"
 
-	void update(float dt) {
-		pos+=vel*dt;
-
-		age+=dt;
-	}
-
-	//is too old?
-	bool isDead() const {
-		return age>lifespan;
-	}
+#include "cmn/utils.h"
 
-	static Particle makeRandom(const cmn::vf2d& pos, float r, float g, float b) {
-		Particle p;
-		p.pos=pos;
-		float speed=cmn::randFloat(1, 6);
-		float angle=cmn::randFloat(2*cmn::Pi);
-		p.vel=cmn::vf2d::polar({speed, angle});
-		p.lifespan=cmn::randFloat(1.6f, 3.8f);
-		//randomize color
-		p.r=cmn::clamp(r+.15f*cmn::randFloat(-1, 1), 0.f, 1.f);
-		p.g=cmn::clamp(g+.15f*cmn::randFloat(-1, 1), 0.f, 1.f);
-		p.b=cmn::clamp(b+.15f*cmn::randFloat(-1, 1), 0.f, 1.f);
-		return p;
-	}
-};
+//spark w/ color jittered by spread, -1 when the pool is full
+inline int spawnParticle(cmn::ParticlePool& pool, const cmn::vf2d& pos, const cmn::vf2d& vel, float r, float g, float b, float spread) {
+	int i=pool.spawn(pos.x, pos.y, vel.x, vel.y, cmn::randFloat(1.6f, 3.8f));
+	if(i==-1) return -1;
+
+	//randomize color
+	pool.r[i]=cmn::clamp(r+spread*cmn::randFloat(-1, 1), 0.f, 1.f);
+	pool.g[i]=cmn::clamp(g+spread*cmn::randFloat(-1, 1), 0.f, 1.f);
+	pool.b[i]=cmn::clamp(b+spread*cmn::randFloat(-1, 1), 0.f, 1.f);
+	return i;
+}
+
+//spark in a random direction
+inline int spawnRandomParticle(cmn::ParticlePool& pool, const cmn::vf2d& pos, float r, float g, float b) {
+	float speed=cmn::randFloat(1, 6);
+	float angle=cmn::randFloat(2*cmn::Pi);
+	return spawnParticle(pool, pos, cmn::vf2d::polar({speed, angle}), r, g, b, .15f);
+}
 #endif
\ No newline at end of file
@@ -27,19 +27,13 @@ struct Ship {
 	}
 
 	//random particle at end of ship
-	Particle emitParticle() const {
-		Particle p;
+	void emitParticle(cmn::ParticlePool& pool) const {
 		float noise=.33f*cmn::Pi*cmn::randFloat(-1, 1);
-		p.pos=pos-cmn::vf2d::polar({rad, rot+noise/2});
+		cmn::vf2d p=pos-cmn::vf2d::polar({rad, rot+noise/2});
 		float speed=cmn::randFloat(3, 6);
-		p.vel=-cmn::vf2d::polar({speed, rot+noise});
-		p.lifespan=cmn::randFloat(1.6f, 3.8f);
-		float r=1, g=.35f, b=0;//orangeish
-		//randomize color
-		p.r=cmn::clamp(r+.25f*cmn::randFloat(-1, 1), 0.f, 1.f);
-		p.g=cmn::clamp(g+.25f*cmn::randFloat(-1, 1), 0.f, 1.f);
-		p.b=cmn::clamp(b+.25f*cmn::randFloat(-1, 1), 0.f, 1.f);
-		return p;
+		cmn::vf2d v=-cmn::vf2d::polar({speed, rot+noise});
+		//orangeish
+		spawnParticle(pool, p, v, 1, .35f, 0, .25f);
 	}
 
 	void getOutline(cmn::vf2d& a, cmn::vf2d& b, cmn::vf2d& c) const {
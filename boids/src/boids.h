@@ -5,6 +5,7 @@
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -194,7 +195,7 @@ public:
 	bool user_create() override {
 		app_title="Boids";
 
-		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		setupSGL();
 
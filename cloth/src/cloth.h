@@ -4,6 +4,7 @@
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -14,16 +15,13 @@
 #include "cmn/math/v3d.h"
 #include "cmn/math/mat4.h"
 
-#include "phys/particle.h"
-#include "phys/spring.h"
+#include "phys/cloth_solver.h"
 
 #include <string>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb/include/stb_image.h"
 
-#include <list>
-
 #include <vector>
 
 //for pi
@@ -36,9 +34,9 @@
 
 #include "cmn/geom/aabb3.h"
 
-struct IndexTriangle {
-	Particle* a=0, * b=0, * c=0;
-};
+#include "cmn/stopwatch.h"
+
+#include <iostream>
 
 void compressiveGradient(float t, float* r, float* g, float* b) {
 	static const float cols[][3]{
@@ -79,9 +77,7 @@ using cmn::mat4;
 
 class Cloth : public cmn::SokolEngine {
 	//physics stuff
-	std::list<Particle> particles;
-	std::vector<Spring> springs;
-	std::vector<IndexTriangle> triangles;
+	ClothSolver solver;
 
 	const vf3d gravity{0, -9.8f, 0};
 
@@ -110,7 +106,7 @@ class Cloth : public cmn::SokolEngine {
 
 	const float select_rad=5;
 
-	Particle* grab_ptc=nullptr;
+	int grab_ix=-1;
 	vf3d grab_st;
 	vf3d grab_norm;
 	vf3d grab_pt;
@@ -130,21 +126,17 @@ class Cloth : public cmn::SokolEngine {
 
 public:
 #pragma CREATE_HELPERS
-	void setupCloth() {
-		//sizing
-		float width=cmn::randFloat(2.75f, 3.25f);
-		float height=cmn::randFloat(1.75f, 2.25f);
-		float area_sqm=width*height;
-
+	//flag on the xy plane, held by its left edge
+	static void buildCloth(ClothSolver& s, float width, float height, float cell_sz) {
 		//allocate grid
-		float cell_sz=cmn::randFloat(.075f, .1f);
 		int num_x=1+width/cell_sz;
 		int num_y=1+height/cell_sz;
 		int num=num_x*num_y;
-		Particle** grid=new Particle*[num];
+		int* grid=new int[num];
 		auto ix=[&] (int i, int j) { return i+num_x*j; };
 
 		//mass properties given common flag size
+		float area_sqm=width*height;
 		float dens_lb_sqft=.75f/(3*5);
 		float dens_kg_sqft=dens_lb_sqft/2.205f;
 		float dens_kg_sqm=dens_kg_sqft*10.76f;
@@ -158,25 +150,21 @@ public:
 			for(int j=0; j<num_y; j++) {
 				float y01=j/(num_y-1.f);
 				float y=height*(y01-.5f);
-				Particle p({x, y, 0}, mass_per);
-				if(i==0) p.locked=true;
-				p.tex_u=x01;
-				p.tex_v=1-y01;
-				particles.push_back(p);
-				grid[ix(i, j)]=&particles.back();
+				grid[ix(i, j)]=s.addParticle({x, y, 0}, mass_per, i==0, x01, 1-y01);
 			}
 		}
 
 		//connect springs adjacently
 		const float k=18.27f;
-		const float d=.7653f;
+		//xpbd damping is implicit, so much less is needed
+		const float d=.02f;
 		for(int i=0; i<num_x; i++) {
 			for(int j=0; j<num_y; j++) {
-				if(i>0) springs.push_back(Spring(grid[ix(i, j)], grid[ix(i-1, j)], k, d));
-				if(j>0) springs.push_back(Spring(grid[ix(i, j)], grid[ix(i, j-1)], k, d));
+				if(i>0) s.addConstraint(grid[ix(i, j)], grid[ix(i-1, j)], k, d);
+				if(j>0) s.addConstraint(grid[ix(i, j)], grid[ix(i, j-1)], k, d);
 				if(i>0&&j>0) {
-					springs.push_back(Spring(grid[ix(i-1, j-1)], grid[ix(i, j)], k, d));
-					springs.push_back(Spring(grid[ix(i-1, j)], grid[ix(i, j-1)], k, d));
+					s.addConstraint(grid[ix(i-1, j-1)], grid[ix(i, j)], k, d);
+					s.addConstraint(grid[ix(i-1, j)], grid[ix(i, j-1)], k, d);
 				}
 			}
 		}
@@ -184,16 +172,27 @@ public:
 		//tesselate surface
 		for(int i=1; i<num_x; i++) {
 			for(int j=1; j<num_y; j++) {
-				const auto& k00=grid[ix(i-1, j-1)];
-				const auto& k01=grid[ix(i-1, j)];
-				const auto& k10=grid[ix(i, j-1)];
-				const auto& k11=grid[ix(i, j)];
-				triangles.push_back({k00, k01, k10});
-				triangles.push_back({k01, k11, k10});
+				int k00=grid[ix(i-1, j-1)];
+				int k01=grid[ix(i-1, j)];
+				int k10=grid[ix(i, j-1)];
+				int k11=grid[ix(i, j)];
+				s.addTriangle(k00, k01, k10);
+				s.addTriangle(k01, k11, k10);
 			}
 		}
 
 		delete[] grid;
+
+		//about the spacing, so the surface has no gaps
+		s.thickness=cell_sz;
+	}
+
+	void setupCloth() {
+		//sizing
+		float width=cmn::randFloat(2.75f, 3.25f);
+		float height=cmn::randFloat(1.75f, 2.25f);
+		float cell_sz=cmn::randFloat(.075f, .1f);
+		buildCloth(solver, width, height, cell_sz);
 	}
 
 	void setupSGL() {
@@ -256,6 +255,7 @@ public:
 
 		auto now=std::time(0);
 		std::srand(now);
+		cmn::seedRandom(now);
 
 		setupCloth();
 
@@ -282,7 +282,7 @@ public:
 #pragma region UPDATE_HELPERS
 	void handleCameraMovement(float dt) {
 		//dont move while grabbing
-		if(grab_ptc) return;
+		if(grab_ix!=-1) return;
 		
 		//forward/backward
 		vf3d fwd=normalize(vf3d(1, 0, 1)*cam.dir);
@@ -301,7 +301,7 @@ public:
 
 	void handleCameraLooking(float dt) {
 		//dont look while grabbing
-		if(grab_ptc) return;
+		if(grab_ix!=-1) return;
 
 		//up/down
 		if(GetKey(SAPP_KEYCODE_UP).held) cam.pitch+=dt;
@@ -316,7 +316,7 @@ public:
 	void handleGrabAction() {
 		const auto grab_action=GetMouse(SAPP_MOUSEBUTTON_LEFT);
 		if(grab_action.pressed) {
-			grab_ptc=nullptr;
+			grab_ix=-1;
 
 			//angular size of radius pixels
 			float fov_rad=cam.fov_deg/180*cmn::Pi;
@@ -324,34 +324,34 @@ public:
 			float pix2wld=select_rad*h_view/sapp_heightf();
 
 			float record;
-			for(auto& p:particles) {
+			for(int i=0; i<solver.num_particles; i++) {
 				//parallel & perp dist
-				vf3d cp=p.pos-cam.pos;
+				vf3d cp=solver.getPos(i)-cam.pos;
 				float l=std::abs(dot(mouse_dir, cp));
 				float r=length(cross(mouse_dir, cp));
 
 				float max_r=l*pix2wld;
 				if(r<max_r) {
-					if(!grab_ptc||r<record) {
+					if(grab_ix==-1||r<record) {
 						record=r;
-						grab_ptc=&p;
+						grab_ix=i;
 					}
 				}
 			}
-			if(grab_ptc) {
-				grab_st=grab_ptc->pos;
+			if(grab_ix!=-1) {
+				grab_st=solver.getPos(grab_ix);
 				grab_norm=cam.dir;
 			}
 		}
 		if(grab_action.held) {
-			if(grab_ptc) {
+			if(grab_ix!=-1) {
 				grab_pt=rayIntersectPlane(
 					cam.pos, mouse_dir,
 					grab_st, grab_norm
 				);
 			}
 		}
-		if(grab_action.released) grab_ptc=nullptr;
+		if(grab_action.released) grab_ix=-1;
 	}
 
 	void handleUserInput(float dt) {
@@ -374,6 +374,8 @@ public:
 		if(GetKey(SAPP_KEYCODE_P).pressed) update_phys^=true;
 		if(GetKey(SAPP_KEYCODE_O).pressed) render_outlines^=true;
 		if(GetKey(SAPP_KEYCODE_B).pressed) render_bounds^=true;
+
+		if(GetKey(SAPP_KEYCODE_K).pressed) benchmarkSolver();
 	}
 
 	void updateCamera() {
@@ -423,82 +425,66 @@ public:
 		return strength*wind;
 	}
 
+	void stepCloth(ClothSolver& s, float time) {
+		s.applyAerodynamics(time_step, [&] (const vf3d& ctr) {
+			return getWind(ctr, time);
+		});
+
+		s.step(time_step, gravity);
+
+		s.solveSelfCollisions();
+	}
+
 	void handlePhysics(float dt) {
 		//ensure similar update across multiple framerates?
 		update_timer+=dt;
 		while(update_timer>time_step) {
-			//update springs
-			for(auto& s:springs) {
-				s.update();
-			}
-
-			//apply wind & drag
-			for(auto& t:triangles) {
-				auto& a=*t.a;
-				auto& b=*t.b;
-				auto& c=*t.c;
-
-				vf3d ab=b.pos-a.pos;
-				vf3d ac=c.pos-a.pos;
-
-				vf3d norm=cross(ab, ac);
-				float mag=length(norm);
-				if(mag<1e-6f) continue;
-
-				float area=.5f*mag;
-				norm/=mag;
-
-				//particle velocities
-				vf3d vel_a=(a.pos-a.old_pos)/time_step;
-				vf3d vel_b=(b.pos-b.old_pos)/time_step;
-				vf3d vel_c=(c.pos-c.old_pos)/time_step;
-
-				vf3d ctr=(a.pos+b.pos+c.pos)/3;
-				vf3d wind=getWind(ctr, .2f*total_dt);
-
-				//relative wind vel
-				vf3d vel=(vel_a+vel_b+vel_c)/3;
-				vf3d rel_vel=wind-vel;
-
-				float rel_spd=length(rel_vel);
-				if(rel_spd<1e-6f) continue;
-
-				vf3d rel_dir=rel_vel/rel_spd;
-
-				float exposure=std::abs(dot(norm, rel_dir));
-
-				//aerodynamic pressure
-				const float air_dens=1.225f;
-				float pressure=.5f*air_dens*rel_spd*rel_spd;
-
-				const float drag_coeff=1.2f;
-				vf3d force=pressure*drag_coeff*exposure*area*rel_dir;
-
-				vf3d per_vertex=force/3;
-
-				a.applyForce(per_vertex);
-				b.applyForce(per_vertex);
-				c.applyForce(per_vertex);
-			}
-
 			//spring towards grab point
-			if(grab_ptc) {
-				Particle p_temp(grab_pt, 1);
-				p_temp.locked=true;
-				Spring s_temp(grab_ptc, &p_temp, 25, 0);
-				s_temp.rest_len=0;
-				s_temp.update();
+			if(grab_ix!=-1) {
+				const float k=25;
+				solver.applyForce(grab_ix, k*(grab_pt-solver.getPos(grab_ix)));
 			}
 
-			//update particles
-			for(auto& p:particles) {
+			stepCloth(solver, .2f*total_dt);
 
-				p.applyForce(p.mass*gravity);
+			update_timer-=time_step;
+		}
+	}
 
-				p.update(time_step);
+	//times substeps of bigger & bigger flags w/ 1, 2, 4... threads
+	void benchmarkSolver() {
+		const int num_steps=60;
+		int max_threads=std::thread::hardware_concurrency();
+		if(max_threads<1) max_threads=1;
+
+		std::cout<<"cloth: "<<num_steps<<" substeps of "<<time_step<<"s\n";
+		for(const int res:{64, 128, 256, 384}) {
+			ClothSolver base;
+			buildCloth(base, 3, 2, 3.f/res);
+
+			for(int n=1; n<=max_threads; n*=2) {
+				cmn::ThreadPool p(n);
+				ClothSolver test=base;
+				test.pool=&p;
+
+				cmn::Stopwatch watch;
+				watch.start();
+				for(int i=0; i<num_steps; i++) stepCloth(test, .2f*i*time_step);
+				watch.stop();
+
+				double sec=watch.getMicros()/1e6;
+
+				//share of that spent on self collision
+				watch.start();
+				for(int i=0; i<num_steps; i++) test.solveSelfCollisions();
+				watch.stop();
+				double col_sec=watch.getMicros()/1e6;
+
+				std::cout<<"  "<<test.num_particles<<" verts, "<<test.getNumColors()<<" colors, "
+					<<n<<" threads: "<<1000*sec<<" ms, "
+					<<test.num_particles*num_steps/sec/1e6<<" Mverts/s, "
+					<<"self collision "<<100*col_sec/sec<<"%\n";
 			}
-
-			update_timer-=time_step;
 		}
 	}
 #pragma endregion
@@ -524,20 +510,23 @@ public:
 		
 		//simple shading
 		sgl_begin_triangles();
-		for(const auto& t:triangles) {
-			vf3d ab=t.b->pos-t.a->pos;
-			vf3d ac=t.c->pos-t.a->pos;
+		for(const auto& t:solver.triangles) {
+			vf3d pa=solver.getPos(t.a);
+			vf3d pb=solver.getPos(t.b);
+			vf3d pc=solver.getPos(t.c);
+			vf3d ab=pb-pa;
+			vf3d ac=pc-pa;
 			vf3d norm=normalize(cross(ab, ac));
-			vf3d ctr=(t.a->pos+t.b->pos+t.c->pos)/3;
+			vf3d ctr=(pa+pb+pc)/3;
 
 			//if pointing away from cam, use flipped normal
 			if(dot(norm, cam.pos-ctr)<0) norm*=-1;
 
 			vf3d light_dir=normalize(light_pos-ctr);
 			float dp=cmn::clamp(dot(norm, light_dir), .5f, 1.f);
-			sgl_v3f_t2f_c3f(t.a->pos.x, t.a->pos.y, t.a->pos.z, t.a->tex_u, t.a->tex_v, dp, dp, dp);
-			sgl_v3f_t2f_c3f(t.b->pos.x, t.b->pos.y, t.b->pos.z, t.b->tex_u, t.b->tex_v, dp, dp, dp);
-			sgl_v3f_t2f_c3f(t.c->pos.x, t.c->pos.y, t.c->pos.z, t.c->tex_u, t.c->tex_v, dp, dp, dp);
+			sgl_v3f_t2f_c3f(pa.x, pa.y, pa.z, solver.tex_u[t.a], solver.tex_v[t.a], dp, dp, dp);
+			sgl_v3f_t2f_c3f(pb.x, pb.y, pb.z, solver.tex_u[t.b], solver.tex_v[t.b], dp, dp, dp);
+			sgl_v3f_t2f_c3f(pc.x, pc.y, pc.z, solver.tex_u[t.c], solver.tex_v[t.c], dp, dp, dp);
 		}
 		sgl_end();
 
@@ -545,11 +534,12 @@ public:
 	}
 
 	void renderGrabbing(float r, float g, float b) {
-		if(!grab_ptc) return;
+		if(grab_ix==-1) return;
 
+		vf3d grab_pos=solver.getPos(grab_ix);
 		sgl_begin_lines();
 		sgl_c3f(r, g, b);
-		sgl_v3f(grab_ptc->pos.x, grab_ptc->pos.y, grab_ptc->pos.z);
+		sgl_v3f(grab_pos.x, grab_pos.y, grab_pos.z);
 		sgl_v3f(grab_pt.x, grab_pt.y, grab_pt.z);
 		sgl_end();
 	}
@@ -557,8 +547,8 @@ public:
 	void renderBounds(float r, float g, float b) {
 		const vf3d inf(1e300,1e300,1e300);
 		cmn::AABBf3 box{inf, -inf};
-		for(const auto& p:particles) {
-			box.fitToEnclose(p.pos);
+		for(int i=0; i<solver.num_particles; i++) {
+			box.fitToEnclose(solver.getPos(i));
 		}
 		sgl_begin_lines();
 		sgl_c3f(r, g, b);
@@ -581,21 +571,24 @@ public:
 	}
 
 	void renderSprings() {
+		solver.updateStrain();
+
 		//find max stresses(mag)
 		float max_tens=1e-6f, max_comp=1e-6f;
-		for(const auto& s:springs) {
-			if(s.strain>max_tens) max_tens=s.strain;
-			if(-s.strain>max_comp) max_comp=-s.strain;
+		for(const auto& s:solver.strain) {
+			if(s>max_tens) max_tens=s;
+			if(-s>max_comp) max_comp=-s;
 		}
 
 		sgl_begin_lines();
-		for(const auto& s:springs) {
-			const auto& pa=s.a->pos;
-			const auto& pb=s.b->pos;
+		for(int c=0; c<solver.num_constraints; c++) {
+			vf3d pa=solver.getPos(solver.cst_a[c]);
+			vf3d pb=solver.getPos(solver.cst_b[c]);
 
 			float r, g, b;
-			if(s.strain>0) tensileGradient(s.strain/max_tens, &r, &g, &b);
-			else compressiveGradient(-s.strain/max_comp, &r, &g, &b);
+			float s=solver.strain[c];
+			if(s>0) tensileGradient(s/max_tens, &r, &g, &b);
+			else compressiveGradient(-s/max_comp, &r, &g, &b);
 
 			sgl_v3f_c3f(pa.x, pa.y, pa.z, r, g, b);
 			sgl_v3f_c3f(pb.x, pb.y, pb.z, r, g, b);
@@ -0,0 +1,586 @@
+#pragma once
+#ifndef CLOTH_SOLVER_CLASS_H
+#define CLOTH_SOLVER_CLASS_H
+
+//xpbd cloth w/ particles in flat arrays.
+//  distance constraints are graph colored so no two in
+//  a color share a particle, then each color is solved
+//  across threads & 4 sse lanes at once w/o locking.
+//  self collision uses a spatial hash rebuilt every step.
+
+#include "cmn/math/v3d.h"
+
+#include "cmn/thread_pool.h"
+
+#include "cmn/edge_coloring.h"
+
+#include <vector>
+
+//for fill, max, sort, & unique
+#include <algorithm>
+
+//for uint32_t
+#include <cstdint>
+
+//for sqrt, abs, & floor
+#include <cmath>
+
+#if defined(__SSE2__)||defined(_M_X64)||(defined(_M_IX86_FP)&&_M_IX86_FP>=2)
+#define CLOTH_SOLVER_SSE2
+#include <emmintrin.h>
+#endif
+
+struct IndexTriangle {
+	int a=0, b=0, c=0;
+};
+
+class ClothSolver {
+	//constraints waiting to be colored
+	bool needs_coloring=false;
+
+	//aerodynamic force per triangle
+	std::vector<cmn::vf3d> tri_force;
+
+	//particles sharing a triangle w/ i are
+	//  adj_ids[adj_start[i], adj_start[i+1])
+	bool needs_adjacency=false;
+	std::vector<int> adj_start, adj_ids;
+
+	//particles in bucket h are
+	//  hash_ids[hash_start[h], hash_start[h+1])
+	std::vector<int> hash_start, hash_slot;
+	std::vector<int> particle_hash;
+	std::vector<int> hash_ids;
+
+	//copied in bucket order so scans stay in cache.
+	//  4 extra, so sse can read past the last run.
+	std::vector<float> hash_x, hash_y, hash_z;
+	std::vector<int> hash_bucket;
+
+	//overlapping pair, w/ i pushed by inv_mass[i]*push
+	//  & j by -inv_mass[j]*push
+	struct SelfPair {
+		int i, j;
+		float x, y, z;
+	};
+
+	//found per chunk, then applied in chunk order
+	std::vector<std::vector<SelfPair>> chunk_pairs;
+
+	cmn::ThreadPool& getPool() const {
+		return pool?*pool:cmn::ThreadPool::shared();
+	}
+
+	void colorConstraints();
+
+	void buildAdjacency();
+
+	bool isAdjacent(int i, int j) const {
+		for(int k=adj_start[i]; k<adj_start[i+1]; k++) {
+			if(adj_ids[k]==j) return true;
+		}
+		return false;
+	}
+
+	//linear in i, so cells i & i+1 land in buckets h & h+1 mod size.
+	//  size is a power of 2, so 32 bit wrapping keeps that true
+	//  across negative cells. w/ at least min_buckets, the 27 cells
+	//  around a particle never share a bucket.
+	static int hashCell(int i, int j, int k, int size) {
+		std::uint32_t h=std::uint32_t(i)+1619u*std::uint32_t(j)+31337u*std::uint32_t(k);
+		return h&(size-1);
+	}
+
+	static const int min_buckets=3+2*1619+2*31337;
+
+	void fillHash();
+
+	void solveConstraint(int, float, float);
+#ifdef CLOTH_SOLVER_SSE2
+	void solveConstraints4(int, float, float);
+#endif
+
+public:
+	int num_particles=0;
+	std::vector<float> pos_x, pos_y, pos_z;
+	std::vector<float> old_x, old_y, old_z;
+	std::vector<float> frc_x, frc_y, frc_z;
+	std::vector<float> mass, inv_mass;
+	std::vector<float> tex_u, tex_v;
+
+	//sorted by color once solved
+	int num_constraints=0;
+	std::vector<int> cst_a, cst_b;
+	std::vector<float> rest_len;
+	std::vector<float> compliance;
+	std::vector<float> damping;
+	std::vector<float> lambda;
+	std::vector<float> strain;
+
+	//color c spans [color_start[c], color_start[c+1])
+	std::vector<int> color_start;
+
+	std::vector<IndexTriangle> triangles;
+
+	int num_iterations=1;
+
+	//min distance between particles that
+	//  dont share a triangle, 0=no self collision
+	float thickness=0;
+
+	//null uses the shared pool
+	cmn::ThreadPool* pool=nullptr;
+
+	static const int particle_grain=1024;
+	static const int constraint_grain=512;
+	static const int triangle_grain=256;
+
+	int getNumColors() const { return color_start.size()?color_start.size()-1:0; }
+
+	cmn::vf3d getPos(int i) const { return {pos_x[i], pos_y[i], pos_z[i]}; }
+
+	void setPos(int i, const cmn::vf3d& p) {
+		pos_x[i]=p.x, pos_y[i]=p.y, pos_z[i]=p.z;
+	}
+
+	//displacement over the last step
+	cmn::vf3d getMotion(int i) const {
+		return {pos_x[i]-old_x[i], pos_y[i]-old_y[i], pos_z[i]-old_z[i]};
+	}
+
+	bool isLocked(int i) const { return inv_mass[i]==0; }
+
+	//index of insertion
+	int addParticle(const cmn::vf3d& p, float m, bool locked=false, float u=0, float v=0) {
+		pos_x.push_back(p.x), pos_y.push_back(p.y), pos_z.push_back(p.z);
+		old_x.push_back(p.x), old_y.push_back(p.y), old_z.push_back(p.z);
+		frc_x.push_back(0), frc_y.push_back(0), frc_z.push_back(0);
+		mass.push_back(m);
+		inv_mass.push_back(locked?0:1/m);
+		tex_u.push_back(u), tex_v.push_back(v);
+
+		return num_particles++;
+	}
+
+	//stiffness in N/m & damping in Ns/m,
+	//  rest length from current positions
+	void addConstraint(int a, int b, float stiffness, float damp) {
+		cst_a.push_back(a), cst_b.push_back(b);
+		rest_len.push_back(length(getPos(b)-getPos(a)));
+		compliance.push_back(1/stiffness);
+		damping.push_back(damp);
+		lambda.push_back(0);
+		strain.push_back(0);
+		num_constraints++;
+
+		needs_coloring=true;
+	}
+
+	void addTriangle(int a, int b, int c) {
+		triangles.push_back({a, b, c});
+
+		needs_adjacency=true;
+	}
+
+	void applyForce(int i, const cmn::vf3d& f) {
+		frc_x[i]+=f.x, frc_y[i]+=f.y, frc_z[i]+=f.z;
+	}
+
+	//drag from wind(ctr) on each triangle,
+	//  computed in parallel then summed in order.
+	template<typename Func>
+	void applyAerodynamics(float dt, Func wind) {
+		const int num_tris=triangles.size();
+		tri_force.resize(num_tris);
+		getPool().parallelFor(0, num_tris, triangle_grain, [&] (int t0, int t1) {
+			for(int t=t0; t<t1; t++) {
+				const auto& tri=triangles[t];
+				tri_force[t]={0, 0, 0};
+
+				cmn::vf3d a=getPos(tri.a);
+				cmn::vf3d ab=getPos(tri.b)-a;
+				cmn::vf3d ac=getPos(tri.c)-a;
+
+				cmn::vf3d norm=cross(ab, ac);
+				float mag=length(norm);
+				if(mag<1e-6f) continue;
+
+				float area=.5f*mag;
+				norm/=mag;
+
+				//relative wind vel
+				cmn::vf3d ctr=a+(ab+ac)/3;
+				cmn::vf3d vel=(getMotion(tri.a)+getMotion(tri.b)+getMotion(tri.c))/(3*dt);
+				cmn::vf3d rel_vel=wind(ctr)-vel;
+
+				float rel_spd=length(rel_vel);
+				if(rel_spd<1e-6f) continue;
+
+				cmn::vf3d rel_dir=rel_vel/rel_spd;
+
+				float exposure=std::abs(dot(norm, rel_dir));
+
+				//aerodynamic pressure
+				const float air_dens=1.225f;
+				float pressure=.5f*air_dens*rel_spd*rel_spd;
+
+				const float drag_coeff=1.2f;
+				tri_force[t]=pressure*drag_coeff*exposure*area*rel_dir;
+			}
+		});
+
+		for(int t=0; t<num_tris; t++) {
+			const auto& tri=triangles[t];
+			cmn::vf3d per_vertex=tri_force[t]/3;
+			applyForce(tri.a, per_vertex);
+			applyForce(tri.b, per_vertex);
+			applyForce(tri.c, per_vertex);
+		}
+	}
+
+	//verlet predict, then project constraints
+	void step(float dt, const cmn::vf3d& gravity) {
+		if(needs_coloring) colorConstraints();
+
+		cmn::ThreadPool& p=getPool();
+
+		const float dt2=dt*dt;
+		p.parallelFor(0, num_particles, particle_grain, [&] (int i0, int i1) {
+			for(int i=i0; i<i1; i++) {
+				float vx=pos_x[i]-old_x[i];
+				float vy=pos_y[i]-old_y[i];
+				float vz=pos_z[i]-old_z[i];
+				old_x[i]=pos_x[i], old_y[i]=pos_y[i], old_z[i]=pos_z[i];
+
+				if(inv_mass[i]!=0) {
+					pos_x[i]+=vx+(gravity.x+inv_mass[i]*frc_x[i])*dt2;
+					pos_y[i]+=vy+(gravity.y+inv_mass[i]*frc_y[i])*dt2;
+					pos_z[i]+=vz+(gravity.z+inv_mass[i]*frc_z[i])*dt2;
+				}
+
+				//reset forces
+				frc_x[i]=0, frc_y[i]=0, frc_z[i]=0;
+			}
+		});
+
+		std::fill(lambda.begin(), lambda.end(), 0.f);
+		for(int it=0; it<num_iterations; it++) {
+			//damp once, on the last pass
+			const float damp_dt=it==num_iterations-1?dt:0;
+
+			//colors in order, each one in parallel
+			for(int c=0; c<getNumColors(); c++) {
+				p.parallelFor(color_start[c], color_start[c+1], constraint_grain, [&] (int c0, int c1) {
+					int k=c0;
+#ifdef CLOTH_SOLVER_SSE2
+					for(; k+4<=c1; k+=4) solveConstraints4(k, dt, damp_dt);
+#endif
+					for(; k<c1; k++) solveConstraint(k, dt, damp_dt);
+				});
+			}
+		}
+	}
+
+	//pushes apart particles closer than thickness.
+	//  each pair is found once by the particle that comes first,
+	//  so only half the cells around it are scanned.
+	void solveSelfCollisions() {
+		if(thickness<=0||!num_particles) return;
+
+		//particles may have been added since
+		if(needs_adjacency||int(adj_start.size())!=num_particles+1) buildAdjacency();
+
+		fillHash();
+
+		const int size=hash_start.size()-1;
+		const float thick_sq=thickness*thickness;
+
+		//hash is linear, so the rows are at fixed offsets
+		//  from the bucket: cx-1 & cy+1, then cy-1 to cy+1 at cz+1
+		int row_offset[4];
+		for(int c=0; c<4; c++) {
+			row_offset[c]=hashCell(-1, c?c-2:1, c?1:0, size);
+		}
+
+		chunk_pairs.resize((num_particles+particle_grain-1)/particle_grain);
+
+		//in bucket order, so particles in a bucket can skip the ones before
+		getPool().parallelFor(0, num_particles, particle_grain, [&] (int n0, int n1) {
+			auto& pairs=chunk_pairs[n0/particle_grain];
+			pairs.clear();
+			for(int n=n0; n<n1; n++) {
+				const int i=hash_ids[n];
+				const float xi=hash_x[n], yi=hash_y[n], zi=hash_z[n];
+
+				//k is known to be closer than thickness
+				auto collide=[&] (int k) {
+					const int j=hash_ids[k];
+					if(isAdjacent(i, j)) return;
+
+					const float w=inv_mass[i]+inv_mass[j];
+					if(w==0) return;
+
+					//split overlap by inverse mass
+					float dx=xi-hash_x[k];
+					float dy=yi-hash_y[k];
+					float dz=zi-hash_z[k];
+					float dist=std::sqrt(dx*dx+dy*dy+dz*dz);
+					float s=(thickness-dist)/(w*dist);
+					pairs.push_back({i, j, s*dx, s*dy, s*dz});
+				};
+#ifdef CLOTH_SOLVER_SSE2
+				const __m128 xi4=_mm_set1_ps(xi), yi4=_mm_set1_ps(yi), zi4=_mm_set1_ps(zi);
+				const __m128 thick_sq4=_mm_set1_ps(thick_sq);
+				const __m128 zero=_mm_setzero_ps();
+#endif
+				auto scan=[&] (int k0, int k1) {
+					int k=k0;
+#ifdef CLOTH_SOLVER_SSE2
+					//runs are short & often empty, so always 4 at a time
+					//  w/ the extra masked off, which keeps it w/o branches
+					do {
+						__m128 dx=_mm_sub_ps(xi4, _mm_loadu_ps(&hash_x[k]));
+						__m128 dy=_mm_sub_ps(yi4, _mm_loadu_ps(&hash_y[k]));
+						__m128 dz=_mm_sub_ps(zi4, _mm_loadu_ps(&hash_z[k]));
+						__m128 dist_sq=_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+						__m128 near=_mm_and_ps(_mm_cmplt_ps(dist_sq, thick_sq4), _mm_cmpneq_ps(dist_sq, zero));
+						int mask=_mm_movemask_ps(near)&((1<<std::min(k1-k, 4))-1);
+						for(int l=0; mask; l++, mask>>=1) {
+							if(mask&1) collide(k+l);
+						}
+						k+=4;
+					} while(k<k1);
+					k=k1;
+#endif
+					for(; k<k1; k++) {
+						float dx=xi-hash_x[k];
+						float dy=yi-hash_y[k];
+						float dz=zi-hash_z[k];
+						float dist_sq=dx*dx+dy*dy+dz*dz;
+
+						//other cells in a bucket are too far anyways
+						if(dist_sq<thick_sq&&dist_sq!=0) collide(k);
+					}
+				};
+
+				//cells are thickness wide, so the 27 around cover it.
+				//  rest of this bucket, & cell cx+1
+				const int h=hash_bucket[n];
+				if(h+1<size) scan(n+1, hash_start[h+2]);
+				else {
+					scan(n+1, hash_start[h+1]);
+					scan(hash_start[0], hash_start[1]);
+				}
+
+				//cells cx-1 to cx+1 in the 4 rows ahead
+				for(int c=0; c<4; c++) {
+					const int r=(h+row_offset[c])&(size-1);
+					if(r+2<size) scan(hash_start[r], hash_start[r+3]);
+					else {
+						for(int b=r; b<r+3; b++) {
+							scan(hash_start[b&(size-1)], hash_start[1+(b&(size-1))]);
+						}
+					}
+				}
+			}
+		});
+
+		//few pairs, so w/o threads, but in order
+		for(const auto& pairs:chunk_pairs) {
+			for(const auto& pr:pairs) {
+				const float wi=inv_mass[pr.i], wj=inv_mass[pr.j];
+				pos_x[pr.i]+=wi*pr.x, pos_y[pr.i]+=wi*pr.y, pos_z[pr.i]+=wi*pr.z;
+				pos_x[pr.j]-=wj*pr.x, pos_y[pr.j]-=wj*pr.y, pos_z[pr.j]-=wj*pr.z;
+			}
+		}
+	}
+
+	//only needed for display
+	void updateStrain() {
+		for(int c=0; c<num_constraints; c++) {
+			float curr=length(getPos(cst_b[c])-getPos(cst_a[c]));
+			strain[c]=(curr-rest_len[c])/rest_len[c];
+		}
+	}
+};
+
+//greedy coloring, then a stable sort by color
+void ClothSolver::colorConstraints() {
+	needs_coloring=false;
+
+	std::vector<int> order;
+	cmn::colorEdges(num_particles, num_constraints, [&] (int c) {
+		return std::make_pair(cst_a[c], cst_b[c]);
+	}, order, color_start);
+
+	auto permute=[&] (auto& vec) {
+		auto old=vec;
+		for(int i=0; i<num_constraints; i++) vec[i]=old[order[i]];
+	};
+	permute(cst_a), permute(cst_b);
+	permute(rest_len), permute(compliance), permute(damping);
+	permute(lambda), permute(strain);
+}
+
+void ClothSolver::buildAdjacency() {
+	needs_adjacency=false;
+
+	//both ways for each triangle edge
+	std::vector<std::vector<int>> adj(num_particles);
+	for(const auto& t:triangles) {
+		const int v[3]{t.a, t.b, t.c};
+		for(int i=0; i<3; i++) {
+			for(int j=0; j<3; j++) {
+				if(i!=j) adj[v[i]].push_back(v[j]);
+			}
+		}
+	}
+
+	adj_start.assign(num_particles+1, 0);
+	adj_ids.clear();
+	for(int i=0; i<num_particles; i++) {
+		auto& a=adj[i];
+		std::sort(a.begin(), a.end());
+		a.erase(std::unique(a.begin(), a.end()), a.end());
+		adj_ids.insert(adj_ids.end(), a.begin(), a.end());
+		adj_start[i+1]=adj_ids.size();
+	}
+}
+
+//counting sort of particles by hashed cell
+void ClothSolver::fillHash() {
+	int size=1;
+	while(size<std::max(2*num_particles, int(min_buckets))) size*=2;
+	const float inv_cell=1/thickness;
+	cmn::ThreadPool& p=getPool();
+	particle_hash.resize(num_particles);
+	p.parallelFor(0, num_particles, particle_grain, [&] (int i0, int i1) {
+		for(int i=i0; i<i1; i++) {
+			int cx=std::floor(inv_cell*pos_x[i]);
+			int cy=std::floor(inv_cell*pos_y[i]);
+			int cz=std::floor(inv_cell*pos_z[i]);
+			particle_hash[i]=hashCell(cx, cy, cz, size);
+		}
+	});
+
+	hash_start.assign(size+1, 0);
+	for(int i=0; i<num_particles; i++) hash_start[1+particle_hash[i]]++;
+	for(int h=0; h<size; h++) hash_start[h+1]+=hash_start[h];
+
+	//only ids serially, the rest gathered in parallel
+	hash_ids.resize(num_particles);
+	hash_slot.assign(hash_start.begin(), hash_start.end()-1);
+	for(int i=0; i<num_particles; i++) {
+		hash_ids[hash_slot[particle_hash[i]]++]=i;
+	}
+
+	hash_x.resize(num_particles+4);
+	hash_y.resize(num_particles+4);
+	hash_z.resize(num_particles+4);
+	hash_bucket.resize(num_particles);
+	p.parallelFor(0, num_particles, particle_grain, [&] (int k0, int k1) {
+		for(int k=k0; k<k1; k++) {
+			const int i=hash_ids[k];
+			hash_x[k]=pos_x[i], hash_y[k]=pos_y[i], hash_z[k]=pos_z[i];
+			hash_bucket[k]=particle_hash[i];
+		}
+	});
+}
+
+//xpbd distance constraint, then an implicit damper
+//  on the relative motion along it if damp_dt>0.
+void ClothSolver::solveConstraint(int c, float dt, float damp_dt) {
+	const int a=cst_a[c], b=cst_b[c];
+	const float wa=inv_mass[a], wb=inv_mass[b];
+	const float w=wa+wb;
+	if(w==0) return;
+
+	float dx=pos_x[b]-pos_x[a];
+	float dy=pos_y[b]-pos_y[a];
+	float dz=pos_z[b]-pos_z[a];
+	float len=std::sqrt(dx*dx+dy*dy+dz*dz);
+	if(len<1e-6f) return;
+
+	float nx=dx/len, ny=dy/len, nz=dz/len;
+
+	//relative motion along constraint this step
+	float mx=(pos_x[b]-old_x[b])-(pos_x[a]-old_x[a]);
+	float my=(pos_y[b]-old_y[b])-(pos_y[a]-old_y[a]);
+	float mz=(pos_z[b]-old_z[b])-(pos_z[a]-old_z[a]);
+	float rel=nx*mx+ny*my+nz*mz;
+
+	float alpha=compliance[c]/(dt*dt);
+	float d_lambda=(len-rest_len[c]+alpha*lambda[c])/(w+alpha);
+	lambda[c]-=d_lambda;
+
+	//correction changes rel by -w*d_lambda
+	float k=damping[c]*damp_dt*w;
+	float damp=(rel-w*d_lambda)*k/((1+k)*w);
+
+	float t=d_lambda+damp;
+	pos_x[a]+=wa*t*nx, pos_y[a]+=wa*t*ny, pos_z[a]+=wa*t*nz;
+	pos_x[b]-=wb*t*nx, pos_y[b]-=wb*t*ny, pos_z[b]-=wb*t*nz;
+}
+
+#ifdef CLOTH_SOLVER_SSE2
+//same as solveConstraint on c..c+3 in sse lanes.
+//  they share a color, so the scatter cant collide.
+void ClothSolver::solveConstraints4(int c, float dt, float damp_dt) {
+	const int* ia=&cst_a[c];
+	const int* ib=&cst_b[c];
+	auto gather=[] (const std::vector<float>& v, const int* ix) {
+		return _mm_setr_ps(v[ix[0]], v[ix[1]], v[ix[2]], v[ix[3]]);
+	};
+	auto select=[] (__m128 mask, __m128 a, __m128 b) {
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	};
+
+	const __m128 one=_mm_set1_ps(1);
+	const __m128 wa=gather(inv_mass, ia), wb=gather(inv_mass, ib);
+	const __m128 w=_mm_add_ps(wa, wb);
+
+	__m128 ax=gather(pos_x, ia), ay=gather(pos_y, ia), az=gather(pos_z, ia);
+	__m128 bx=gather(pos_x, ib), by=gather(pos_y, ib), bz=gather(pos_z, ib);
+	__m128 dx=_mm_sub_ps(bx, ax), dy=_mm_sub_ps(by, ay), dz=_mm_sub_ps(bz, az);
+	__m128 len=_mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+
+	//lanes solveConstraint would skip
+	const __m128 valid=_mm_and_ps(_mm_cmpneq_ps(w, _mm_setzero_ps()), _mm_cmpge_ps(len, _mm_set1_ps(1e-6f)));
+	const __m128 safe_w=select(valid, w, one);
+	len=select(valid, len, one);
+
+	__m128 nx=_mm_div_ps(dx, len), ny=_mm_div_ps(dy, len), nz=_mm_div_ps(dz, len);
+
+	//relative motion along constraint this step
+	__m128 mx=_mm_sub_ps(_mm_sub_ps(bx, gather(old_x, ib)), _mm_sub_ps(ax, gather(old_x, ia)));
+	__m128 my=_mm_sub_ps(_mm_sub_ps(by, gather(old_y, ib)), _mm_sub_ps(ay, gather(old_y, ia)));
+	__m128 mz=_mm_sub_ps(_mm_sub_ps(bz, gather(old_z, ib)), _mm_sub_ps(az, gather(old_z, ia)));
+	__m128 rel=_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, mx), _mm_mul_ps(ny, my)), _mm_mul_ps(nz, mz));
+
+	__m128 alpha=_mm_div_ps(_mm_loadu_ps(&compliance[c]), _mm_set1_ps(dt*dt));
+	__m128 lam=_mm_loadu_ps(&lambda[c]);
+	__m128 num=_mm_add_ps(_mm_sub_ps(len, _mm_loadu_ps(&rest_len[c])), _mm_mul_ps(alpha, lam));
+	__m128 d_lambda=_mm_and_ps(valid, _mm_div_ps(num, _mm_add_ps(safe_w, alpha)));
+	_mm_storeu_ps(&lambda[c], _mm_sub_ps(lam, d_lambda));
+
+	//correction changes rel by -w*d_lambda
+	__m128 k=_mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&damping[c]), _mm_set1_ps(damp_dt)), w);
+	__m128 damp=_mm_div_ps(_mm_mul_ps(_mm_sub_ps(rel, _mm_mul_ps(w, d_lambda)), k), _mm_mul_ps(_mm_add_ps(one, k), safe_w));
+	damp=_mm_and_ps(valid, damp);
+
+	__m128 t=_mm_add_ps(d_lambda, damp);
+	__m128 sa=_mm_mul_ps(wa, t), sb=_mm_mul_ps(wb, t);
+	alignas(16) float out[6][4];
+	_mm_store_ps(out[0], _mm_add_ps(ax, _mm_mul_ps(sa, nx)));
+	_mm_store_ps(out[1], _mm_add_ps(ay, _mm_mul_ps(sa, ny)));
+	_mm_store_ps(out[2], _mm_add_ps(az, _mm_mul_ps(sa, nz)));
+	_mm_store_ps(out[3], _mm_sub_ps(bx, _mm_mul_ps(sb, nx)));
+	_mm_store_ps(out[4], _mm_sub_ps(by, _mm_mul_ps(sb, ny)));
+	_mm_store_ps(out[5], _mm_sub_ps(bz, _mm_mul_ps(sb, nz)));
+	for(int l=0; l<4; l++) {
+		pos_x[ia[l]]=out[0][l], pos_y[ia[l]]=out[1][l], pos_z[ia[l]]=out[2][l];
+		pos_x[ib[l]]=out[3][l], pos_y[ib[l]]=out[4][l], pos_z[ib[l]]=out[5][l];
+	}
+}
+#endif
+#endif
\ No newline at end of file
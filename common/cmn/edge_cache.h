@@ -0,0 +1,87 @@
+#pragma once
+#ifndef COMMON_EDGE_CACHE_H
+#define COMMON_EDGE_CACHE_H
+
+//flat open addressing map from an undirected edge to a T.
+//  used to share the vertex made where a cut crosses an edge
+//  between the faces on either side of it. reset is O(1)
+//  by bumping a generation, so one cache can be reused.
+
+#include <vector>
+
+//for swap
+#include <utility>
+
+//for uint32_t & uint64_t
+#include <cstdint>
+
+//for size_t
+#include <cstddef>
+
+namespace cmn {
+	template<typename T>
+	class EdgeCache {
+		struct Slot {
+			std::uint64_t key=0;
+			T val{};
+			std::uint32_t gen=0;
+		};
+		std::vector<Slot> slots;
+		std::uint32_t gen=0;
+		std::size_t mask=0;
+
+		//sorted, so a-b & b-a match
+		static std::uint64_t toKey(int a, int b) {
+			if(a>b) std::swap(a, b);
+			return std::uint64_t(std::uint32_t(a))<<32|std::uint32_t(b);
+		}
+
+		//murmur finalizer
+		static std::uint64_t hash(std::uint64_t k) {
+			k^=k>>33;
+			k*=0xff51afd7ed558ccdULL;
+			k^=k>>33;
+			return k;
+		}
+
+	public:
+		//at most num edges until next reset
+		void reset(int num) {
+			//keep load under half
+			std::size_t cap=16;
+			while(cap<2*std::size_t(num)) cap*=2;
+			if(cap>slots.size()) {
+				slots.assign(cap, Slot());
+				gen=0;
+			}
+			mask=slots.size()-1;
+
+			gen++;
+			//wrapped around, stale gens could match
+			if(gen==0) {
+				for(auto& s:slots) s.gen=0;
+				gen=1;
+			}
+		}
+
+		//returns whether edge a-b was already there.
+		//  if not, val must be filled in.
+		bool findOrInsert(int a, int b, T*& val) {
+			std::uint64_t key=toKey(a, b);
+			for(std::size_t i=hash(key)&mask; ; i=(i+1)&mask) {
+				auto& s=slots[i];
+				if(s.gen!=gen) {
+					s.gen=gen;
+					s.key=key;
+					val=&s.val;
+					return false;
+				}
+				if(s.key==key) {
+					val=&s.val;
+					return true;
+				}
+			}
+		}
+	};
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef COMMON_EDGE_COLORING_H
+#define COMMON_EDGE_COLORING_H
+
+//greedy edge coloring, so no two edges in a color share a node.
+//  used to batch constraints between 2 points, since
+//  a whole color can then be solved in parallel w/o locking.
+
+#include <vector>
+
+//for max
+#include <algorithm>
+
+//for pair
+#include <utility>
+
+//for uint64_t
+#include <cstdint>
+
+namespace cmn {
+	//ends(e) gives the node pair of edge e as a std::pair.
+	//  order gets edge ids grouped by color, w/ color c spanning
+	//  [color_start[c], color_start[c+1]) in insertion order.
+	template<typename Ends>
+	void colorEdges(int num_nodes, int num_edges, Ends ends, std::vector<int>& order, std::vector<int>& color_start) {
+		//at most 2*deg-1 colors are needed
+		std::vector<int> degree(num_nodes, 0);
+		int max_deg=0;
+		for(int e=0; e<num_edges; e++) {
+			const auto ab=ends(e);
+			max_deg=std::max(max_deg, ++degree[ab.first]);
+			max_deg=std::max(max_deg, ++degree[ab.second]);
+		}
+		const int num_words=(2*max_deg+63)/64;
+
+		//which colors touch each node
+		std::vector<std::uint64_t> used(num_nodes*num_words, 0);
+		std::vector<int> color(num_edges);
+		int num_colors=0;
+		for(int e=0; e<num_edges; e++) {
+			const auto ab=ends(e);
+			std::uint64_t* ua=&used[num_words*ab.first];
+			std::uint64_t* ub=&used[num_words*ab.second];
+			int col=0;
+			for(int w=0; w<num_words; w++) {
+				std::uint64_t free=~(ua[w]|ub[w]);
+				if(!free) continue;
+
+				int bit=0;
+				while(!(free&(1ull<<bit))) bit++;
+				col=64*w+bit;
+				ua[w]|=1ull<<bit;
+				ub[w]|=1ull<<bit;
+				break;
+			}
+			color[e]=col;
+			num_colors=std::max(num_colors, 1+col);
+		}
+
+		//counting sort keeps insertion order within a color
+		color_start.assign(num_colors+1, 0);
+		for(int e=0; e<num_edges; e++) color_start[1+color[e]]++;
+		for(int i=0; i<num_colors; i++) color_start[i+1]+=color_start[i];
+
+		order.resize(num_edges);
+		std::vector<int> slot(color_start.begin(), color_start.end()-1);
+		for(int e=0; e<num_edges; e++) order[slot[color[e]]++]=e;
+	}
+}
+#endif
\ No newline at end of file
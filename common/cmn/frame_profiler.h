@@ -0,0 +1,178 @@
+#pragma once
+#ifndef COMMON_FRAME_PROFILER_CLASS_H
+#define COMMON_FRAME_PROFILER_CLASS_H
+
+#include <string>
+
+//for uint32_t, uint64_t
+#include <cstdint>
+
+//for file io
+#include <fstream>
+
+namespace cmn {
+	//log-linear bucketed times, so memory stays fixed
+	//  no matter how many frames go in.
+	class FrameHistogram {
+		//exact below this many us, then this many per doubling.
+		//  worst case bucket error is ~1.5%
+		static const int _linear=128;
+		static const int _sub=64;
+		static const int _num_buckets=_linear+_sub*32;
+
+		std::uint32_t _counts[_num_buckets]{};
+		std::uint64_t _count=0;
+		double _sum_us=0;
+		std::uint32_t _min_us=0, _max_us=0;
+
+		static int toBucket(std::uint32_t us) {
+			if(us<_linear) return us;
+
+			//which power of two, then where inside it
+			int e=0;
+			for(std::uint32_t v=us; v>=2*_linear; v>>=1) e++;
+			int sub=(us>>e)-_linear;
+			return _linear+_sub*e+sub*_sub/_linear;
+		}
+
+	public:
+		static std::uint32_t bucketLow(int b) {
+			if(b<_linear) return b;
+
+			int e=(b-_linear)/_sub;
+			int sub=(b-_linear)%_sub;
+			return std::uint32_t(_linear+sub*_linear/_sub)<<e;
+		}
+
+		static int getNumBuckets() { return _num_buckets; }
+
+		void add(float ms) {
+			double us_d=1000.0*ms;
+			if(us_d<0) us_d=0;
+			if(us_d>4e9) us_d=4e9;
+			std::uint32_t us=us_d;
+
+			_counts[toBucket(us)]++;
+			if(!_count||us<_min_us) _min_us=us;
+			if(!_count||us>_max_us) _max_us=us;
+			_count++;
+			_sum_us+=us_d;
+		}
+
+		void clear() {
+			*this=FrameHistogram();
+		}
+
+		std::uint64_t getCount() const { return _count; }
+		std::uint32_t getBucketCount(int b) const { return _counts[b]; }
+
+		float getMeanMillis() const { return _count?_sum_us/_count/1000:0; }
+		float getMinMillis() const { return _min_us/1000.f; }
+		float getMaxMillis() const { return _max_us/1000.f; }
+
+		//p in [0, 1]
+		float getPercentileMillis(float p) const {
+			if(!_count) return 0;
+
+			//first bucket that reaches the rank
+			std::uint64_t rank=1+std::uint64_t(p*(_count-1));
+			std::uint64_t sum=0;
+			for(int b=0; b<_num_buckets; b++) {
+				sum+=_counts[b];
+				if(sum>=rank) {
+					//bucket low end, but never past what was seen
+					std::uint32_t us=bucketLow(b);
+					if(us<_min_us) us=_min_us;
+					if(us>_max_us) us=_max_us;
+					return us/1000.f;
+				}
+			}
+			return getMaxMillis();
+		}
+	};
+
+	//per frame update & render times.
+	//  a .json path gets a summary, anything else a csv of the buckets.
+	class FrameProfiler {
+		bool writeCSV(const std::string& filename) const {
+			std::ofstream file(filename);
+			if(file.fail()) return false;
+
+			file<<"bucket_us,update_frames,render_frames\n";
+			for(int b=0; b<FrameHistogram::getNumBuckets(); b++) {
+				std::uint32_t u=update.getBucketCount(b);
+				std::uint32_t r=render.getBucketCount(b);
+				if(u||r) file<<FrameHistogram::bucketLow(b)<<','<<u<<','<<r<<'\n';
+			}
+
+			return true;
+		}
+
+		static void writeSummaryJSON(std::ofstream& file, const FrameHistogram& h) {
+			file<<"{"
+				<<"\"frames\": "<<h.getCount()
+				<<", \"mean_ms\": "<<h.getMeanMillis()
+				<<", \"min_ms\": "<<h.getMinMillis()
+				<<", \"p50_ms\": "<<h.getPercentileMillis(.5f)
+				<<", \"p95_ms\": "<<h.getPercentileMillis(.95f)
+				<<", \"p99_ms\": "<<h.getPercentileMillis(.99f)
+				<<", \"max_ms\": "<<h.getMaxMillis()
+				<<"}";
+		}
+
+		bool writeJSON(const std::string& filename) const {
+			std::ofstream file(filename);
+			if(file.fail()) return false;
+
+			file<<"{\n  \"update\": ";
+			writeSummaryJSON(file, update);
+			file<<",\n  \"render\": ";
+			writeSummaryJSON(file, render);
+			file<<"\n}\n";
+
+			return true;
+		}
+
+	public:
+		FrameHistogram update, render;
+
+		void addFrame(float update_ms, float render_ms) {
+			update.add(update_ms);
+			render.add(render_ms);
+		}
+
+		//headless runs dont render
+		void addFrame(float update_ms) {
+			update.add(update_ms);
+		}
+
+		void clear() {
+			update.clear();
+			render.clear();
+		}
+
+		bool save(const std::string& filename) const {
+			std::size_t dot=filename.find_last_of('.');
+			if(dot!=std::string::npos&&filename.substr(dot)==".json") return writeJSON(filename);
+
+			return writeCSV(filename);
+		}
+
+		template<typename Stream>
+		void print(Stream& out) const {
+			auto line=[&] (const char* name, const FrameHistogram& h) {
+				if(!h.getCount()) return;
+
+				out<<"  "<<name<<": "<<h.getCount()<<" frames, "
+					<<"mean "<<h.getMeanMillis()<<" ms, "
+					<<"p50 "<<h.getPercentileMillis(.5f)<<" ms, "
+					<<"p95 "<<h.getPercentileMillis(.95f)<<" ms, "
+					<<"p99 "<<h.getPercentileMillis(.99f)<<" ms, "
+					<<"max "<<h.getMaxMillis()<<" ms\n";
+			};
+			line("update", update);
+			line("render", render);
+		}
+	};
+}
+#endif
\ No newline at end of file
@@ -3,7 +3,7 @@
 #define CMN_MAT4_STRUCT_H
 
 //for memset
-#include <string>
+#include <cstring>
 
 //for sqrt & trig
 #include <cmath>
@@ -0,0 +1,214 @@
+#pragma once
+#ifndef CMN_MAT4_BATCH_H
+#define CMN_MAT4_BATCH_H
+
+//matMulVec over whole arrays.
+//  vf3d arrays get swizzled into x, y & z lanes 4 at a time w/ sse,
+//  or 8 at a time w/ avx, & the leftovers go through the scalar path.
+//  out may be the same array as in.
+
+#include "mat4.h"
+
+#if defined(__SSE2__)||defined(_M_X64)||(defined(_M_IX86_FP)&&_M_IX86_FP>=2)
+#define CMN_MAT4_BATCH_SSE
+#include <emmintrin.h>
+#endif
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+namespace cmn {
+	static_assert(sizeof(vf3d)==3*sizeof(float), "batch transforms need packed vf3d");
+
+	//how the 4th coordinate is handled
+	struct Mat4BatchMode {
+		//w per point, or w_const if null
+		const float* w_in=nullptr;
+		float w_const=1;
+
+		//divide xyz by the new w
+		bool divide=false;
+
+		//new w per point, if not null
+		float* w_out=nullptr;
+	};
+
+#ifdef CMN_MAT4_BATCH_SSE
+#define CMN_SHUF(a, b, c, d) _MM_SHUFFLE(d, c, b, a)
+	//12 floats of xyzxyz... into x, y, z lanes
+	inline void mat4BatchLoad4(const float* f, __m128& x, __m128& y, __m128& z) {
+		__m128 a=_mm_loadu_ps(f);//x0 y0 z0 x1
+		__m128 b=_mm_loadu_ps(f+4);//y1 z1 x2 y2
+		__m128 c=_mm_loadu_ps(f+8);//z2 x3 y3 z3
+		__m128 q1=_mm_shuffle_ps(b, c, CMN_SHUF(2, 3, 0, 1));//x2 y2 z2 x3
+		__m128 q0=_mm_shuffle_ps(a, b, CMN_SHUF(1, 2, 0, 1));//y0 z0 y1 z1
+		__m128 q2=_mm_shuffle_ps(q1, c, CMN_SHUF(1, 2, 2, 3));//y2 z2 y3 z3
+		x=_mm_shuffle_ps(a, q1, CMN_SHUF(0, 3, 0, 3));
+		y=_mm_shuffle_ps(q0, q2, CMN_SHUF(0, 2, 0, 2));
+		z=_mm_shuffle_ps(q0, q2, CMN_SHUF(1, 3, 1, 3));
+	}
+
+	//x, y, z lanes back to xyzxyz...
+	inline void mat4BatchStore4(float* f, __m128 x, __m128 y, __m128 z) {
+		__m128 xy01=_mm_unpacklo_ps(x, y);//x0 y0 x1 y1
+		__m128 xy23=_mm_unpackhi_ps(x, y);//x2 y2 x3 y3
+		__m128 t=_mm_shuffle_ps(z, xy01, CMN_SHUF(0, 0, 2, 0));//z0 z0 x1 x0
+		__m128 u=_mm_shuffle_ps(xy01, z, CMN_SHUF(3, 3, 1, 1));//y1 y1 z1 z1
+		__m128 v=_mm_shuffle_ps(z, xy23, CMN_SHUF(2, 2, 2, 2));//z2 z2 x3 x3
+		__m128 s=_mm_shuffle_ps(xy23, z, CMN_SHUF(3, 3, 3, 3));//y3 y3 z3 z3
+		_mm_storeu_ps(f, _mm_shuffle_ps(xy01, t, CMN_SHUF(0, 1, 0, 2)));
+		_mm_storeu_ps(f+4, _mm_shuffle_ps(u, xy23, CMN_SHUF(0, 2, 0, 1)));
+		_mm_storeu_ps(f+8, _mm_shuffle_ps(v, s, CMN_SHUF(0, 2, 0, 2)));
+	}
+#undef CMN_SHUF
+#endif
+
+	//the general kernel, see the wrappers below
+	inline void mat4Batch(const mat4& m, const vf3d* in, vf3d* out, int num, const Mat4BatchMode& mode) {
+		int i=0;
+#ifdef __AVX__
+		{
+			__m256 c[16];
+			for(int j=0; j<16; j++) c[j]=_mm256_set1_ps(m.m[j]);
+			for(; i+8<=num; i+=8) {
+				__m128 xl, yl, zl, xh, yh, zh;
+				mat4BatchLoad4(&in[i].x, xl, yl, zl);
+				mat4BatchLoad4(&in[i+4].x, xh, yh, zh);
+				__m256 x=_mm256_insertf128_ps(_mm256_castps128_ps256(xl), xh, 1);
+				__m256 y=_mm256_insertf128_ps(_mm256_castps128_ps256(yl), yh, 1);
+				__m256 z=_mm256_insertf128_ps(_mm256_castps128_ps256(zl), zh, 1);
+				__m256 w=mode.w_in?_mm256_loadu_ps(mode.w_in+i):_mm256_set1_ps(mode.w_const);
+
+				//column major, so c[r+4*col]
+				__m256 rx=_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c[0], x), _mm256_mul_ps(c[4], y)), _mm256_add_ps(_mm256_mul_ps(c[8], z), _mm256_mul_ps(c[12], w)));
+				__m256 ry=_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c[1], x), _mm256_mul_ps(c[5], y)), _mm256_add_ps(_mm256_mul_ps(c[9], z), _mm256_mul_ps(c[13], w)));
+				__m256 rz=_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c[2], x), _mm256_mul_ps(c[6], y)), _mm256_add_ps(_mm256_mul_ps(c[10], z), _mm256_mul_ps(c[14], w)));
+				if(mode.divide||mode.w_out) {
+					__m256 rw=_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c[3], x), _mm256_mul_ps(c[7], y)), _mm256_add_ps(_mm256_mul_ps(c[11], z), _mm256_mul_ps(c[15], w)));
+					if(mode.w_out) _mm256_storeu_ps(mode.w_out+i, rw);
+					if(mode.divide) {
+						rx=_mm256_div_ps(rx, rw);
+						ry=_mm256_div_ps(ry, rw);
+						rz=_mm256_div_ps(rz, rw);
+					}
+				}
+
+				mat4BatchStore4(&out[i].x, _mm256_castps256_ps128(rx), _mm256_castps256_ps128(ry), _mm256_castps256_ps128(rz));
+				mat4BatchStore4(&out[i+4].x, _mm256_extractf128_ps(rx, 1), _mm256_extractf128_ps(ry, 1), _mm256_extractf128_ps(rz, 1));
+			}
+		}
+#endif
+#ifdef CMN_MAT4_BATCH_SSE
+		{
+			__m128 c[16];
+			for(int j=0; j<16; j++) c[j]=_mm_set1_ps(m.m[j]);
+			for(; i+4<=num; i+=4) {
+				__m128 x, y, z;
+				mat4BatchLoad4(&in[i].x, x, y, z);
+				__m128 w=mode.w_in?_mm_loadu_ps(mode.w_in+i):_mm_set1_ps(mode.w_const);
+
+				__m128 rx=_mm_add_ps(_mm_add_ps(_mm_mul_ps(c[0], x), _mm_mul_ps(c[4], y)), _mm_add_ps(_mm_mul_ps(c[8], z), _mm_mul_ps(c[12], w)));
+				__m128 ry=_mm_add_ps(_mm_add_ps(_mm_mul_ps(c[1], x), _mm_mul_ps(c[5], y)), _mm_add_ps(_mm_mul_ps(c[9], z), _mm_mul_ps(c[13], w)));
+				__m128 rz=_mm_add_ps(_mm_add_ps(_mm_mul_ps(c[2], x), _mm_mul_ps(c[6], y)), _mm_add_ps(_mm_mul_ps(c[10], z), _mm_mul_ps(c[14], w)));
+				if(mode.divide||mode.w_out) {
+					__m128 rw=_mm_add_ps(_mm_add_ps(_mm_mul_ps(c[3], x), _mm_mul_ps(c[7], y)), _mm_add_ps(_mm_mul_ps(c[11], z), _mm_mul_ps(c[15], w)));
+					if(mode.w_out) _mm_storeu_ps(mode.w_out+i, rw);
+					if(mode.divide) {
+						rx=_mm_div_ps(rx, rw);
+						ry=_mm_div_ps(ry, rw);
+						rz=_mm_div_ps(rz, rw);
+					}
+				}
+
+				mat4BatchStore4(&out[i].x, rx, ry, rz);
+			}
+		}
+#endif
+		//leftovers
+		for(; i<num; i++) {
+			float w=mode.w_in?mode.w_in[i]:mode.w_const;
+			vf3d v=matMulVec(m, in[i], w);
+			if(mode.w_out) mode.w_out[i]=w;
+			out[i]=mode.divide?v/w:v;
+		}
+	}
+
+	//w=1
+	inline void transformPoints(const mat4& m, const vf3d* in, vf3d* out, int num) {
+		mat4Batch(m, in, out, num, {});
+	}
+
+	//w=0, so no translation
+	inline void transformDirs(const mat4& m, const vf3d* in, vf3d* out, int num) {
+		Mat4BatchMode mode;
+		mode.w_const=0;
+		mat4Batch(m, in, out, num, mode);
+	}
+
+	//w=1, then the perspective divide. w_out keeps each w
+	inline void transformProject(const mat4& m, const vf3d* in, vf3d* out, int num, float* w_out=nullptr) {
+		Mat4BatchMode mode;
+		mode.divide=true;
+		mode.w_out=w_out;
+		mat4Batch(m, in, out, num, mode);
+	}
+
+	//xyzw in, xyzw out. w_in & w_out may be the same array
+	inline void transformHomogeneous(const mat4& m, const vf3d* in, const float* w_in, vf3d* out, float* w_out, int num) {
+		Mat4BatchMode mode;
+		mode.w_in=w_in;
+		mode.w_out=w_out;
+		mat4Batch(m, in, out, num, mode);
+	}
+
+	//w=1, in chunks on the stack for
+	//  results that are only looked at once
+	template<typename Func>
+	void forEachTransformedPoint(const mat4& m, const vf3d* in, int num, Func f) {
+		vf3d buf[256];
+		for(int i=0; i<num; i+=256) {
+			int n=num-i<256?num-i:256;
+			transformPoints(m, in+i, buf, n);
+			for(int j=0; j<n; j++) f(buf[j]);
+		}
+	}
+
+	//structure of arrays, w=1. no swizzling needed
+	inline void transformPointsSoA(
+		const mat4& m,
+		const float* x, const float* y, const float* z,
+		float* ox, float* oy, float* oz, int num
+	) {
+		int i=0;
+#ifdef __AVX__
+		{
+			__m256 c[16];
+			for(int j=0; j<16; j++) c[j]=_mm256_set1_ps(m.m[j]);
+			for(; i+8<=num; i+=8) {
+				__m256 vx=_mm256_loadu_ps(x+i), vy=_mm256_loadu_ps(y+i), vz=_mm256_loadu_ps(z+i);
+				_mm256_storeu_ps(ox+i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c[0], vx), _mm256_mul_ps(c[4], vy)), _mm256_add_ps(_mm256_mul_ps(c[8], vz), c[12])));
+				_mm256_storeu_ps(oy+i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c[1], vx), _mm256_mul_ps(c[5], vy)), _mm256_add_ps(_mm256_mul_ps(c[9], vz), c[13])));
+				_mm256_storeu_ps(oz+i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c[2], vx), _mm256_mul_ps(c[6], vy)), _mm256_add_ps(_mm256_mul_ps(c[10], vz), c[14])));
+			}
+		}
+#endif
+#ifdef CMN_MAT4_BATCH_SSE
+		{
+			__m128 c[16];
+			for(int j=0; j<16; j++) c[j]=_mm_set1_ps(m.m[j]);
+			for(; i+4<=num; i+=4) {
+				__m128 vx=_mm_loadu_ps(x+i), vy=_mm_loadu_ps(y+i), vz=_mm_loadu_ps(z+i);
+				_mm_storeu_ps(ox+i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(c[0], vx), _mm_mul_ps(c[4], vy)), _mm_add_ps(_mm_mul_ps(c[8], vz), c[12])));
+				_mm_storeu_ps(oy+i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(c[1], vx), _mm_mul_ps(c[5], vy)), _mm_add_ps(_mm_mul_ps(c[9], vz), c[13])));
+				_mm_storeu_ps(oz+i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(c[2], vx), _mm_mul_ps(c[6], vy)), _mm_add_ps(_mm_mul_ps(c[10], vz), c[14])));
+			}
+		}
+#endif
+		for(; i<num; i++) {
+			float w=1;
+			vf3d v=matMulVec(m, {x[i], y[i], z[i]}, w);
+			ox[i]=v.x, oy[i]=v.y, oz[i]=v.z;
+		}
+	}
+}
+#endif
\ No newline at end of file
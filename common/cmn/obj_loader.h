@@ -0,0 +1,562 @@
+#pragma once
+#ifndef CMN_OBJ_LOADER_H
+#define CMN_OBJ_LOADER_H
+
+#include "math/v3d.h"
+
+#include <vector>
+
+#include <string>
+
+//for memcpy
+#include <cstring>
+
+#include <cstdint>
+
+//for file_size & last_write_time
+#include <filesystem>
+
+#include <fstream>
+
+#ifndef __EMSCRIPTEN__
+#include <thread>
+#endif
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace cmn {
+	//read only view of a whole file.
+	//  memory mapped on desktop, read into a buffer on the web.
+	class MappedFile {
+		const char* m_data=nullptr;
+		std::size_t m_size=0;
+
+#ifdef _WIN32
+		HANDLE m_file=INVALID_HANDLE_VALUE, m_mapping=nullptr;
+#elif defined(__EMSCRIPTEN__)
+		std::vector<char> m_buffer;
+#else
+		void* m_map=nullptr;
+#endif
+
+	public:
+		MappedFile() {}
+
+		MappedFile(const MappedFile&)=delete;
+		MappedFile& operator=(const MappedFile&)=delete;
+
+		~MappedFile() {
+			close();
+		}
+
+		bool open(const std::string& filename) {
+			close();
+#ifdef _WIN32
+			m_file=CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if(m_file==INVALID_HANDLE_VALUE) return false;
+			LARGE_INTEGER sz;
+			if(!GetFileSizeEx(m_file, &sz)) return close(), false;
+			m_size=sz.QuadPart;
+			//cant map empty files
+			if(m_size==0) return true;
+			m_mapping=CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if(!m_mapping) return close(), false;
+			m_data=static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+			if(!m_data) return close(), false;
+#elif defined(__EMSCRIPTEN__)
+			std::ifstream file(filename, std::ios::binary|std::ios::ate);
+			if(file.fail()) return false;
+			m_buffer.resize(file.tellg());
+			file.seekg(0);
+			if(!file.read(m_buffer.data(), m_buffer.size())) return close(), false;
+			m_data=m_buffer.data();
+			m_size=m_buffer.size();
+#else
+			int fd=::open(filename.c_str(), O_RDONLY);
+			if(fd<0) return false;
+			struct stat st;
+			if(fstat(fd, &st)!=0) {
+				::close(fd);
+				return false;
+			}
+			m_size=st.st_size;
+			if(m_size) {
+				m_map=mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if(m_map==MAP_FAILED) m_map=nullptr;
+				else madvise(m_map, m_size, MADV_SEQUENTIAL);
+			}
+			//mapping outlives descriptor
+			::close(fd);
+			if(m_size&&!m_map) return close(), false;
+			m_data=static_cast<const char*>(m_map);
+#endif
+			return true;
+		}
+
+		void close() {
+#ifdef _WIN32
+			if(m_data) UnmapViewOfFile(m_data);
+			if(m_mapping) CloseHandle(m_mapping);
+			if(m_file!=INVALID_HANDLE_VALUE) CloseHandle(m_file);
+			m_mapping=nullptr;
+			m_file=INVALID_HANDLE_VALUE;
+#elif defined(__EMSCRIPTEN__)
+			m_buffer.clear();
+#else
+			if(m_map) munmap(m_map, m_size);
+			m_map=nullptr;
+#endif
+			m_data=nullptr;
+			m_size=0;
+		}
+
+		const char* data() const { return m_data; }
+		std::size_t size() const { return m_size; }
+	};
+
+	//flat obj contents, fan triangulated
+	struct OBJMesh {
+		std::vector<vf3d> positions, normals;
+		//u, v pairs
+		std::vector<float> texcoords;
+
+		//0 based, -1 if not specified
+		struct Corner {
+			int v=-1, t=-1, n=-1;
+		};
+		//3 per triangle
+		std::vector<Corner> corners;
+
+		int getNumTris() const {
+			return corners.size()/3;
+		}
+	};
+
+	//how a load went
+	enum struct OBJStatus {
+		Ok,
+		Filename,
+		Vertex,
+		Texture,
+		Normal
+	};
+
+	namespace obj_detail {
+		//face corner before triangulation
+		struct PolyCorner {
+			OBJMesh::Corner c;
+			//was component negative(relative)?
+			bool rel_v=false, rel_t=false, rel_n=false;
+		};
+
+		//one chunk of the file worth of output
+		struct Chunk {
+			OBJMesh mesh;
+			//corners with relative components, local to this chunk.
+			//  these need the previous chunks counts added.
+			std::vector<int> rel_v, rel_t, rel_n;
+			std::vector<PolyCorner> poly;
+			//face corner w/o a vertex index
+			bool bad_corner=false;
+		};
+
+		inline bool isSpace(char c) {
+			return c==' '||c=='\t'||c=='\r';
+		}
+
+		inline const char* skipSpace(const char* p, const char* end) {
+			while(p<end&&isSpace(*p)) p++;
+			return p;
+		}
+
+		inline const char* skipLine(const char* p, const char* end) {
+			while(p<end&&*p!='\n') p++;
+			return p<end?p+1:end;
+		}
+
+		//returns nullptr if no digits
+		inline const char* parseInt(const char* p, const char* end, int& out) {
+			bool neg=false;
+			if(p<end&&(*p=='-'||*p=='+')) neg=*p++=='-';
+			const char* start=p;
+			int val=0;
+			for(; p<end&&*p>='0'&&*p<='9'; p++) val=10*val+(*p-'0');
+			if(p==start) return nullptr;
+			out=neg?-val:val;
+			return p;
+		}
+
+		//no locale, no allocation. plenty accurate for mesh data
+		inline const char* parseFloat(const char* p, const char* end, float& out) {
+			static const double pow10[]={
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+				1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+				1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+			};
+
+			bool neg=false;
+			if(p<end&&(*p=='-'||*p=='+')) neg=*p++=='-';
+
+			//mantissa, keeping 18 significant digits
+			const char* start=p;
+			unsigned long long mant=0;
+			int exp=0, sig=0;
+			for(; p<end&&*p>='0'&&*p<='9'; p++) {
+				if(sig<18) mant=10*mant+(*p-'0'), sig+=mant>0;
+				else exp++;
+			}
+			if(p<end&&*p=='.') {
+				for(p++; p<end&&*p>='0'&&*p<='9'; p++) {
+					if(sig<18) mant=10*mant+(*p-'0'), sig+=mant>0, exp--;
+				}
+			}
+			if(p==start) return nullptr;
+
+			//exponent
+			if(p<end&&(*p=='e'||*p=='E')) {
+				int e=0;
+				const char* q=parseInt(p+1, end, e);
+				if(q) exp+=e, p=q;
+			}
+
+			double val=mant;
+			while(exp<-22) val/=1e22, exp+=22;
+			while(exp>22) val*=1e22, exp-=22;
+			if(exp<0) val/=pow10[-exp];
+			else val*=pow10[exp];
+			out=neg?-val:val;
+			return p;
+		}
+
+		//fill up to n floats, missing ones stay 0
+		inline const char* parseFloats(const char* p, const char* end, float* f, int n) {
+			for(int i=0; i<n; i++) {
+				p=skipSpace(p, end);
+				const char* q=parseFloat(p, end, f[i]);
+				if(!q) break;
+				p=q;
+			}
+			return p;
+		}
+
+		//1 based or negative obj index into 0 based.
+		//  negative ones are local to this chunk for now.
+		inline int resolve(int ix, int num, bool& rel) {
+			rel=ix<0;
+			return rel?num+ix:ix-1;
+		}
+
+		inline void emitCorner(Chunk& ch, const PolyCorner& pc) {
+			int slot=ch.mesh.corners.size();
+			if(pc.rel_v) ch.rel_v.push_back(slot);
+			if(pc.rel_t) ch.rel_t.push_back(slot);
+			if(pc.rel_n) ch.rel_n.push_back(slot);
+			ch.mesh.corners.push_back(pc.c);
+		}
+
+		inline void parseChunk(const char* p, const char* end, Chunk& ch) {
+			auto& m=ch.mesh;
+			while(p<end) {
+				p=skipSpace(p, end);
+				if(p+1>=end) break;
+
+				char c0=p[0], c1=p[1];
+				if(c0=='v'&&isSpace(c1)) {
+					float f[3]{0, 0, 0};
+					p=parseFloats(p+2, end, f, 3);
+					m.positions.emplace_back(f[0], f[1], f[2]);
+				} else if(c0=='v'&&c1=='n'&&p+2<end&&isSpace(p[2])) {
+					float f[3]{0, 0, 0};
+					p=parseFloats(p+3, end, f, 3);
+					m.normals.emplace_back(f[0], f[1], f[2]);
+				} else if(c0=='v'&&c1=='t'&&p+2<end&&isSpace(p[2])) {
+					float f[2]{0, 0};
+					p=parseFloats(p+3, end, f, 2);
+					m.texcoords.push_back(f[0]);
+					m.texcoords.push_back(f[1]);
+				} else if(c0=='f'&&isSpace(c1)) {
+					//parse v/t/n until end of line
+					ch.poly.clear();
+					p+=2;
+					while(true) {
+						p=skipSpace(p, end);
+						if(p>=end||*p=='\n') break;
+
+						PolyCorner pc;
+						int ix=0;
+						const char* q=parseInt(p, end, ix);
+						if(!q) {
+							ch.bad_corner=true;
+							break;
+						}
+						p=q;
+						pc.c.v=resolve(ix, m.positions.size(), pc.rel_v);
+						if(p<end&&*p=='/') {
+							q=parseInt(++p, end, ix);
+							if(q) p=q, pc.c.t=resolve(ix, m.texcoords.size()/2, pc.rel_t);
+							if(p<end&&*p=='/') {
+								q=parseInt(++p, end, ix);
+								if(q) p=q, pc.c.n=resolve(ix, m.normals.size(), pc.rel_n);
+							}
+						}
+						ch.poly.push_back(pc);
+
+						//skip anything odd left in token
+						while(p<end&&!isSpace(*p)&&*p!='\n') p++;
+					}
+
+					//triangulate
+					const int num_poly=ch.poly.size();
+					for(int i=2; i<num_poly; i++) {
+						emitCorner(ch, ch.poly[0]);
+						emitCorner(ch, ch.poly[i-1]);
+						emitCorner(ch, ch.poly[i]);
+					}
+				}
+
+				p=skipLine(p, end);
+			}
+		}
+
+		template<typename T>
+		void append(std::vector<T>& dst, const std::vector<T>& src) {
+			dst.insert(dst.end(), src.begin(), src.end());
+		}
+
+		//source file stamp to validate cache with
+		inline bool getStamp(const std::string& filename, unsigned long long& size, long long& time) {
+			std::error_code ec;
+			size=std::filesystem::file_size(filename, ec);
+			if(ec) return false;
+			auto wt=std::filesystem::last_write_time(filename, ec);
+			if(ec) return false;
+			time=wt.time_since_epoch().count();
+			return true;
+		}
+
+		struct CacheHeader {
+			char magic[4];
+			std::uint32_t version;
+			unsigned long long src_size;
+			long long src_time;
+			std::uint32_t num_pos, num_norm, num_tex, num_corner;
+		};
+
+		static const char cache_magic[4]={'O', 'B', 'J', 'C'};
+		static const std::uint32_t cache_version=1;
+
+		//smaller files arent worth splitting or caching
+		static const std::size_t min_chunk_size=1<<20;
+	}
+
+	//hand written obj parser over a memory mapped file.
+	//  large files are split at line breaks and parsed in parallel.
+	//  num_threads=0 picks hardware concurrency.
+	//  only v, vt, vn & f are read, everything else is skipped.
+	inline bool loadOBJ(OBJMesh& m, const std::string& filename, OBJStatus& status, int num_threads=0) {
+		m=OBJMesh{};
+		status=OBJStatus::Filename;
+
+		MappedFile file;
+		if(!file.open(filename)) return false;
+		const char* data=file.data();
+		const std::size_t size=file.size();
+
+#ifdef __EMSCRIPTEN__
+		num_threads=1;
+#else
+		//small files arent worth the threads
+		if(num_threads<=0) {
+			const std::size_t min_sz=obj_detail::min_chunk_size;
+			num_threads=std::thread::hardware_concurrency();
+			if(num_threads<=0) num_threads=1;
+			if(size/num_threads<min_sz) num_threads=1+size/min_sz;
+		}
+#endif
+
+		//split at line boundaries
+		std::vector<const char*> bounds{data};
+		for(int i=1; i<num_threads; i++) {
+			const char* p=data+size*i/num_threads;
+			if(p<bounds.back()) p=bounds.back();
+			p=obj_detail::skipLine(p, data+size);
+			bounds.push_back(p);
+		}
+		bounds.push_back(data+size);
+
+		std::vector<obj_detail::Chunk> chunks(num_threads);
+#ifdef __EMSCRIPTEN__
+		obj_detail::parseChunk(bounds[0], bounds[1], chunks[0]);
+#else
+		if(num_threads==1) obj_detail::parseChunk(bounds[0], bounds[1], chunks[0]);
+		else {
+			std::vector<std::thread> workers;
+			for(int i=0; i<num_threads; i++) {
+				workers.emplace_back(obj_detail::parseChunk, bounds[i], bounds[i+1], std::ref(chunks[i]));
+			}
+			for(auto& w:workers) w.join();
+		}
+#endif
+
+		status=OBJStatus::Vertex;
+		for(const auto& ch:chunks) {
+			if(ch.bad_corner) return false;
+		}
+
+		//just move if only one
+		if(num_threads==1) {
+			m=std::move(chunks[0].mesh);
+		} else {
+			std::size_t num_pos=0, num_norm=0, num_tex=0, num_corner=0;
+			for(const auto& ch:chunks) {
+				num_pos+=ch.mesh.positions.size();
+				num_norm+=ch.mesh.normals.size();
+				num_tex+=ch.mesh.texcoords.size();
+				num_corner+=ch.mesh.corners.size();
+			}
+			m.positions.reserve(num_pos);
+			m.normals.reserve(num_norm);
+			m.texcoords.reserve(num_tex);
+			m.corners.reserve(num_corner);
+
+			//concatenate, offsetting relative indexes
+			for(const auto& ch:chunks) {
+				int off_v=m.positions.size();
+				int off_t=m.texcoords.size()/2;
+				int off_n=m.normals.size();
+				int off_c=m.corners.size();
+				obj_detail::append(m.positions, ch.mesh.positions);
+				obj_detail::append(m.normals, ch.mesh.normals);
+				obj_detail::append(m.texcoords, ch.mesh.texcoords);
+				obj_detail::append(m.corners, ch.mesh.corners);
+				for(const auto& s:ch.rel_v) m.corners[off_c+s].v+=off_v;
+				for(const auto& s:ch.rel_t) m.corners[off_c+s].t+=off_t;
+				for(const auto& s:ch.rel_n) m.corners[off_c+s].n+=off_n;
+			}
+		}
+
+		//check ranges
+		const int num_pos=m.positions.size();
+		const int num_tex=m.texcoords.size()/2;
+		const int num_norm=m.normals.size();
+		for(const auto& c:m.corners) {
+			if(c.v<0||c.v>=num_pos) return status=OBJStatus::Vertex, false;
+			if(c.t<-1||c.t>=num_tex) return status=OBJStatus::Texture, false;
+			if(c.n<-1||c.n>=num_norm) return status=OBJStatus::Normal, false;
+		}
+
+		status=OBJStatus::Ok;
+		return true;
+	}
+
+	inline bool loadOBJ(OBJMesh& m, const std::string& filename, int num_threads=0) {
+		OBJStatus status;
+		return loadOBJ(m, filename, status, num_threads);
+	}
+
+	//binary cache next to the obj
+	inline std::string getOBJCacheName(const std::string& filename) {
+		return filename+".cache";
+	}
+
+	inline bool saveOBJCache(const OBJMesh& m, const std::string& filename) {
+		obj_detail::CacheHeader header;
+		std::memcpy(header.magic, obj_detail::cache_magic, 4);
+		header.version=obj_detail::cache_version;
+		if(!obj_detail::getStamp(filename, header.src_size, header.src_time)) return false;
+		header.num_pos=m.positions.size();
+		header.num_norm=m.normals.size();
+		header.num_tex=m.texcoords.size();
+		header.num_corner=m.corners.size();
+
+		std::ofstream file(getOBJCacheName(filename), std::ios::binary);
+		if(file.fail()) return false;
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(m.positions.data()), sizeof(vf3d)*m.positions.size());
+		file.write(reinterpret_cast<const char*>(m.normals.data()), sizeof(vf3d)*m.normals.size());
+		file.write(reinterpret_cast<const char*>(m.texcoords.data()), sizeof(float)*m.texcoords.size());
+		file.write(reinterpret_cast<const char*>(m.corners.data()), sizeof(OBJMesh::Corner)*m.corners.size());
+
+		return !file.fail();
+	}
+
+	//fails if missing or stale
+	inline bool loadOBJCache(OBJMesh& m, const std::string& filename) {
+		m=OBJMesh{};
+
+		obj_detail::CacheHeader expected;
+		if(!obj_detail::getStamp(filename, expected.src_size, expected.src_time)) return false;
+
+		MappedFile file;
+		if(!file.open(getOBJCacheName(filename))) return false;
+		const char* curr=file.data();
+		const char* end=curr+file.size();
+
+		obj_detail::CacheHeader header;
+		if(file.size()<sizeof(header)) return false;
+		std::memcpy(&header, curr, sizeof(header));
+		curr+=sizeof(header);
+		if(std::memcmp(header.magic, obj_detail::cache_magic, 4)) return false;
+		if(header.version!=obj_detail::cache_version) return false;
+		if(header.src_size!=expected.src_size||header.src_time!=expected.src_time) return false;
+
+		std::size_t total=
+			sizeof(vf3d)*(std::size_t(header.num_pos)+header.num_norm)+
+			sizeof(float)*header.num_tex+
+			sizeof(OBJMesh::Corner)*header.num_corner;
+		if(total!=std::size_t(end-curr)) return false;
+
+		auto read=[&] (auto& vec, std::size_t num) {
+			vec.resize(num);
+			std::size_t sz=sizeof(vec[0])*num;
+			if(sz) std::memcpy(static_cast<void*>(vec.data()), curr, sz);
+			curr+=sz;
+		};
+		read(m.positions, header.num_pos);
+		read(m.normals, header.num_norm);
+		read(m.texcoords, header.num_tex);
+		read(m.corners, header.num_corner);
+
+		return true;
+	}
+
+	//use cache if fresh, otherwise parse and write it.
+	//  small files & the web just parse.
+	inline bool loadOBJCached(OBJMesh& m, const std::string& filename, OBJStatus& status, int num_threads=0) {
+#ifndef __EMSCRIPTEN__
+		unsigned long long size=0;
+		long long time=0;
+		if(obj_detail::getStamp(filename, size, time)&&size>=obj_detail::min_chunk_size) {
+			if(loadOBJCache(m, filename)) return status=OBJStatus::Ok, true;
+
+			if(!loadOBJ(m, filename, status, num_threads)) return false;
+
+			//not fatal if this fails
+			saveOBJCache(m, filename);
+
+			return true;
+		}
+#endif
+		return loadOBJ(m, filename, status, num_threads);
+	}
+
+	inline bool loadOBJCached(OBJMesh& m, const std::string& filename, int num_threads=0) {
+		OBJStatus status;
+		return loadOBJCached(m, filename, status, num_threads);
+	}
+}
+#endif
\ No newline at end of file
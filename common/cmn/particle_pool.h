@@ -0,0 +1,219 @@
+#pragma once
+#ifndef COMMON_PARTICLE_POOL_CLASS_H
+#define COMMON_PARTICLE_POOL_CLASS_H
+
+//fixed capacity 2d particle storage.
+//  every field is its own array, so the kernels below run
+//  4 particles at a time w/ sse. dead particles are swapped
+//  w/ the last live one, & nothing allocates after construction.
+
+//for unique_ptr
+#include <memory>
+
+#include <cmath>
+
+#if defined(__SSE2__)||defined(_M_X64)||(defined(_M_IX86_FP)&&_M_IX86_FP>=2)
+#define CMN_PARTICLE_POOL_SSE
+#include <emmintrin.h>
+#endif
+
+namespace cmn {
+	//one corner of a particle quad
+	struct ParticleVertex {
+		float x, y;
+		float u, v;
+		float r, g, b, a;
+	};
+
+	class ParticlePool {
+		int _capacity=0;
+		int _num=0;
+
+		static const int _num_fields=14;
+		std::unique_ptr<float[]> _fields;
+		std::unique_ptr<int[]> _tags;
+
+		//4 per particle
+		std::unique_ptr<ParticleVertex[]> _vertices;
+
+		float* field(int f) const {
+			return _fields.get()+f*_capacity;
+		}
+
+		void copyParticle(int from, int to) {
+			for(int f=0; f<_num_fields; f++) {
+				float* arr=field(f);
+				arr[to]=arr[from];
+			}
+			_tags[to]=_tags[from];
+		}
+
+	public:
+		float* const pos_x, * const pos_y;
+		float* const vel_x, * const vel_y;
+		float* const rot, * const rot_vel;
+		float* const size, * const size_vel;
+		float* const age, * const lifespan;
+		float* const r, * const g, * const b, * const a;
+
+		//whatever the app wants, like a kind or an index
+		int* const tag;
+
+		//applied to every particle by integrate
+		float acc_x=0, acc_y=0;
+
+		//fraction lost per second
+		float drag=0, rot_drag=0, size_drag=0;
+
+		ParticlePool(int capacity) :
+			_capacity(capacity),
+			_fields(new float[_num_fields*capacity]()),
+			_tags(new int[capacity]()),
+			_vertices(new ParticleVertex[4*capacity]),
+			pos_x(field(0)), pos_y(field(1)),
+			vel_x(field(2)), vel_y(field(3)),
+			rot(field(4)), rot_vel(field(5)),
+			size(field(6)), size_vel(field(7)),
+			age(field(8)), lifespan(field(9)),
+			r(field(10)), g(field(11)), b(field(12)), a(field(13)),
+			tag(_tags.get()) {}
+
+		ParticlePool(const ParticlePool&)=delete;
+		ParticlePool& operator=(const ParticlePool&)=delete;
+
+		int getNum() const { return _num; }
+		int getCapacity() const { return _capacity; }
+		bool isFull() const { return _num==_capacity; }
+
+		void clear() { _num=0; }
+
+		//index of the new particle, or -1 when full.
+		//  everything but pos, vel & lifespan starts at 0,
+		//  except color which starts white.
+		int spawn(float x, float y, float vx, float vy, float life) {
+			if(_num==_capacity) return -1;
+
+			const int i=_num++;
+			for(int f=0; f<_num_fields; f++) field(f)[i]=0;
+			pos_x[i]=x, pos_y[i]=y;
+			vel_x[i]=vx, vel_y[i]=vy;
+			lifespan[i]=life;
+			r[i]=g[i]=b[i]=a[i]=1;
+			tag[i]=0;
+			return i;
+		}
+
+		//1 when born to 0 when dead
+		float getFade(int i) const {
+			float t=1-age[i]/lifespan[i];
+			return t<0?0:t;
+		}
+
+		//swaps in the last particle, so order is not kept
+		void remove(int i) {
+			_num--;
+			if(i!=_num) copyParticle(_num, i);
+		}
+
+		//drag, then acceleration, then movement
+		void integrate(float dt) {
+			const float k_vel=1-drag*dt;
+			const float k_rot=1-rot_drag*dt;
+			const float k_size=1-size_drag*dt;
+			const float dvx=acc_x*dt, dvy=acc_y*dt;
+
+			int i=0;
+#ifdef CMN_PARTICLE_POOL_SSE
+			{
+				const __m128 dt4=_mm_set1_ps(dt);
+				const __m128 k_vel4=_mm_set1_ps(k_vel);
+				const __m128 k_rot4=_mm_set1_ps(k_rot);
+				const __m128 k_size4=_mm_set1_ps(k_size);
+				const __m128 dvx4=_mm_set1_ps(dvx), dvy4=_mm_set1_ps(dvy);
+				for(; i+4<=_num; i+=4) {
+					__m128 vx=_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vel_x+i), k_vel4), dvx4);
+					__m128 vy=_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vel_y+i), k_vel4), dvy4);
+					_mm_storeu_ps(vel_x+i, vx);
+					_mm_storeu_ps(vel_y+i, vy);
+					_mm_storeu_ps(pos_x+i, _mm_add_ps(_mm_loadu_ps(pos_x+i), _mm_mul_ps(vx, dt4)));
+					_mm_storeu_ps(pos_y+i, _mm_add_ps(_mm_loadu_ps(pos_y+i), _mm_mul_ps(vy, dt4)));
+
+					__m128 rv=_mm_mul_ps(_mm_loadu_ps(rot_vel+i), k_rot4);
+					_mm_storeu_ps(rot_vel+i, rv);
+					_mm_storeu_ps(rot+i, _mm_add_ps(_mm_loadu_ps(rot+i), _mm_mul_ps(rv, dt4)));
+
+					__m128 sv=_mm_mul_ps(_mm_loadu_ps(size_vel+i), k_size4);
+					_mm_storeu_ps(size_vel+i, sv);
+					_mm_storeu_ps(size+i, _mm_add_ps(_mm_loadu_ps(size+i), _mm_mul_ps(sv, dt4)));
+				}
+			}
+#endif
+			for(; i<_num; i++) {
+				vel_x[i]=vel_x[i]*k_vel+dvx;
+				vel_y[i]=vel_y[i]*k_vel+dvy;
+				pos_x[i]+=vel_x[i]*dt;
+				pos_y[i]+=vel_y[i]*dt;
+
+				rot_vel[i]*=k_rot;
+				rot[i]+=rot_vel[i]*dt;
+
+				size_vel[i]*=k_size;
+				size[i]+=size_vel[i]*dt;
+			}
+		}
+
+		//ages everything, then removes the dead
+		void updateAges(float dt) {
+			int i=0;
+#ifdef CMN_PARTICLE_POOL_SSE
+			{
+				const __m128 dt4=_mm_set1_ps(dt);
+				for(; i+4<=_num; i+=4) {
+					_mm_storeu_ps(age+i, _mm_add_ps(_mm_loadu_ps(age+i), dt4));
+				}
+			}
+#endif
+			for(; i<_num; i++) age[i]+=dt;
+
+			removeIf([this] (int j) { return age[j]>lifespan[j]; });
+		}
+
+		//pred(i) picks which to remove
+		template<typename Pred>
+		void removeIf(Pred pred) {
+			for(int i=0; i<_num;) {
+				if(pred(i)) remove(i);
+				else i++;
+			}
+		}
+
+		//rotated & scaled quads, 4 corners each w/ alpha faded by age.
+		//  returns the number of vertices, see getVertices.
+		int fillQuads() {
+			static const float cx[4]{-1, 1, 1, -1}, cy[4]{-1, -1, 1, 1};
+			static const float cu[4]{0, 1, 1, 0}, cv[4]{0, 0, 1, 1};
+
+			for(int i=0; i<_num; i++) {
+				//half size rotation
+				float hs=size[i]/2;
+				float c=hs*std::cos(rot[i]), s=hs*std::sin(rot[i]);
+				float alpha=a[i]*getFade(i);
+				ParticleVertex* v=&_vertices[4*i];
+				for(int j=0; j<4; j++) {
+					v[j].x=pos_x[i]+c*cx[j]-s*cy[j];
+					v[j].y=pos_y[i]+s*cx[j]+c*cy[j];
+					v[j].u=cu[j], v[j].v=cv[j];
+					v[j].r=r[i], v[j].g=g[i], v[j].b=b[i];
+					v[j].a=alpha;
+				}
+			}
+			return 4*_num;
+		}
+
+		//only valid after fillQuads
+		const ParticleVertex* getVertices() const {
+			return _vertices.get();
+		}
+	};
+}
+#endif
\ No newline at end of file
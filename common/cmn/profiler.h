@@ -0,0 +1,331 @@
+#pragma once
+#ifndef COMMON_PROFILER_CLASS_H
+#define COMMON_PROFILER_CLASS_H
+
+//scoped zone profiler.
+//  CMN_PROFILE_ZONE("name") times the rest of its scope.
+//  nested zones form a tree, each thread logs into its own
+//  ring of events, & each call site keeps rolling stats.
+//  only compiled in w/ CMN_PROFILE defined, otherwise
+//  the macros below expand to nothing.
+
+#define CMN_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CMN_PROFILE_CONCAT(a, b) CMN_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef CMN_PROFILE
+#include "stopwatch.h"
+
+#include <string>
+
+#include <vector>
+
+//for unique_ptr
+#include <memory>
+
+#include <atomic>
+#include <mutex>
+
+//for int64_t, uint64_t
+#include <cstdint>
+
+//for nth_element
+#include <algorithm>
+
+#include <fstream>
+#include <iostream>
+
+namespace cmn {
+	class ProfileZoneInfo;
+
+	//one finished zone
+	struct ProfileEvent {
+		const ProfileZoneInfo* zone=nullptr;
+		std::int64_t start_ns=0, dur_ns=0;
+	};
+
+	//only its owner thread writes, so no locks.
+	//  keeps the most recent events once full.
+	class ProfileThreadBuffer {
+		std::unique_ptr<ProfileEvent[]> _events;
+		std::atomic<std::uint64_t> _written{0};
+
+	public:
+		static const int capacity=1<<15;
+
+		const int tid;
+		std::atomic<bool> in_use{false};
+
+		ProfileThreadBuffer(int t) : tid(t) {
+			_events=std::make_unique<ProfileEvent[]>(capacity);
+		}
+
+		void push(const ProfileEvent& e) {
+			std::uint64_t w=_written.load(std::memory_order_relaxed);
+			_events[w&(capacity-1)]=e;
+			_written.store(w+1, std::memory_order_release);
+		}
+
+		//oldest to newest
+		template<typename Func>
+		void forEach(Func f) const {
+			std::uint64_t w=_written.load(std::memory_order_acquire);
+			std::uint64_t first=w>capacity?w-capacity:0;
+			for(std::uint64_t i=first; i<w; i++) f(_events[i&(capacity-1)]);
+		}
+
+		void clear() {
+			_written.store(0, std::memory_order_release);
+		}
+	};
+
+	struct ProfileZoneStats {
+		std::uint64_t count=0;
+		double total_ms=0, max_ms=0;
+
+		//over the last window calls
+		int window=0;
+		double mean_ms=0, min_ms=0, p95_ms=0;
+	};
+
+	//one per call site, shared by every thread.
+	class ProfileZoneInfo {
+		static const int _window=128;
+
+		std::atomic<std::int64_t> _recent[_window]{};
+		std::atomic<std::uint64_t> _count{0};
+		std::atomic<std::int64_t> _total_ns{0}, _max_ns{0};
+
+	public:
+		const char* const name;
+
+		//enclosing zone when first entered
+		const ProfileZoneInfo* const parent;
+
+		ProfileZoneInfo(const char*);
+
+		void add(std::int64_t ns) {
+			std::uint64_t i=_count.fetch_add(1, std::memory_order_relaxed);
+			_recent[i%_window].store(ns, std::memory_order_relaxed);
+			_total_ns.fetch_add(ns, std::memory_order_relaxed);
+
+			std::int64_t m=_max_ns.load(std::memory_order_relaxed);
+			while(ns>m&&!_max_ns.compare_exchange_weak(m, ns, std::memory_order_relaxed));
+		}
+
+		ProfileZoneStats getStats() const {
+			ProfileZoneStats s;
+			s.count=_count.load(std::memory_order_relaxed);
+			s.total_ms=_total_ns.load(std::memory_order_relaxed)/1e6;
+			s.max_ms=_max_ns.load(std::memory_order_relaxed)/1e6;
+
+			s.window=s.count<_window?s.count:_window;
+			if(!s.window) return s;
+
+			std::int64_t recent[_window];
+			std::int64_t sum=0, min=0;
+			for(int i=0; i<s.window; i++) {
+				recent[i]=_recent[i].load(std::memory_order_relaxed);
+				sum+=recent[i];
+				if(!i||recent[i]<min) min=recent[i];
+			}
+			s.mean_ms=sum/1e6/s.window;
+			s.min_ms=min/1e6;
+
+			int k=(s.window-1)*95/100;
+			std::nth_element(recent, recent+k, recent+s.window);
+			s.p95_ms=recent[k]/1e6;
+
+			return s;
+		}
+
+		void clear() {
+			for(int i=0; i<_window; i++) _recent[i].store(0, std::memory_order_relaxed);
+			_count.store(0, std::memory_order_relaxed);
+			_total_ns.store(0, std::memory_order_relaxed);
+			_max_ns.store(0, std::memory_order_relaxed);
+		}
+	};
+
+	class Profiler {
+		//what the current thread is doing
+		struct ThreadState {
+			ProfileThreadBuffer* buffer=nullptr;
+			const ProfileZoneInfo* current=nullptr;
+
+			//hand the buffer to the next thread,
+			//  but keep its events around for export.
+			~ThreadState() {
+				if(buffer) buffer->in_use=false;
+			}
+		};
+
+		Stopwatch _epoch;
+
+		std::mutex _mutex;
+		std::vector<std::unique_ptr<ProfileThreadBuffer>> _buffers;
+		std::vector<const ProfileZoneInfo*> _zones;
+
+		Profiler() {
+			_epoch.start();
+		}
+
+		ProfileThreadBuffer* acquireBuffer() {
+			std::lock_guard<std::mutex> lock(_mutex);
+			for(auto& b:_buffers) {
+				bool free=false;
+				if(b->in_use.compare_exchange_strong(free, true)) return b.get();
+			}
+
+			_buffers.push_back(std::make_unique<ProfileThreadBuffer>(_buffers.size()));
+			_buffers.back()->in_use=true;
+			return _buffers.back().get();
+		}
+
+		static void writeEscaped(std::ostream& out, const char* str) {
+			for(const char* c=str; *c; c++) {
+				if(*c=='"'||*c=='\\') out<<'\\';
+				out<<*c;
+			}
+		}
+
+		template<typename Stream>
+		void printZone(Stream& out, const ProfileZoneInfo* z, int depth) const {
+			ProfileZoneStats s=z->getStats();
+			out<<std::string(2+2*depth, ' ')<<z->name<<": "
+				<<s.count<<" calls, "
+				<<"mean "<<s.mean_ms<<" ms, "
+				<<"min "<<s.min_ms<<" ms, "
+				<<"p95 "<<s.p95_ms<<" ms (last "<<s.window<<"), "
+				<<"max "<<s.max_ms<<" ms, "
+				<<"total "<<s.total_ms<<" ms\n";
+
+			for(const auto& c:_zones) {
+				if(c->parent==z) printZone(out, c, depth+1);
+			}
+		}
+
+	public:
+		Profiler(const Profiler&)=delete;
+		Profiler& operator=(const Profiler&)=delete;
+
+		static Profiler& get() {
+			static Profiler instance;
+			return instance;
+		}
+
+		static ThreadState& getThreadState() {
+			thread_local ThreadState state;
+			return state;
+		}
+
+		void registerZone(const ProfileZoneInfo* z) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			_zones.push_back(z);
+		}
+
+		void record(const ProfileZoneInfo& z, const Stopwatch& watch) {
+			ThreadState& state=getThreadState();
+			if(!state.buffer) state.buffer=acquireBuffer();
+
+			state.buffer->push({&z, watch.getNanosSince(_epoch), watch.getNanos()});
+		}
+
+		//only while no other thread is inside a zone
+		void clear() {
+			std::lock_guard<std::mutex> lock(_mutex);
+			for(auto& b:_buffers) b->clear();
+			for(auto& z:_zones) const_cast<ProfileZoneInfo*>(z)->clear();
+		}
+
+		//chrome://tracing or ui.perfetto.dev
+		bool saveChromeTrace(const std::string& filename) {
+			std::ofstream file(filename);
+			if(file.fail()) return false;
+
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			file<<"{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+			bool first=true;
+			for(const auto& b:_buffers) {
+				if(!first) file<<",\n";
+				first=false;
+				file<<"{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "<<b->tid
+					<<", \"args\": {\"name\": \"thread "<<b->tid<<"\"}}";
+
+				b->forEach([&] (const ProfileEvent& e) {
+					file<<",\n{\"name\": \"";
+					writeEscaped(file, e.zone->name);
+					file<<"\", \"ph\": \"X\", \"pid\": 1, \"tid\": "<<b->tid
+						<<", \"ts\": "<<e.start_ns/1e3
+						<<", \"dur\": "<<e.dur_ns/1e3<<"}";
+				});
+			}
+			file<<"\n]}\n";
+
+			return true;
+		}
+
+		//zone tree w/ rolling stats
+		template<typename Stream>
+		void print(Stream& out) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			for(const auto& z:_zones) {
+				if(!z->parent) printZone(out, z, 0);
+			}
+		}
+
+		void dump(const std::string& filename) {
+			std::cout<<"profiler zones:\n";
+			print(std::cout);
+			if(!saveChromeTrace(filename)) {
+				std::cout<<"unable to save trace to "<<filename<<'\n';
+			}
+		}
+	};
+
+	ProfileZoneInfo::ProfileZoneInfo(const char* n) :
+		name(n),
+		parent(Profiler::getThreadState().current) {
+		Profiler::get().registerZone(this);
+	}
+
+	//times its own lifetime
+	class ProfileZone {
+		ProfileZoneInfo& _info;
+		const ProfileZoneInfo* _prev;
+		Stopwatch _watch;
+
+	public:
+		ProfileZone(ProfileZoneInfo& i) : _info(i) {
+			auto& state=Profiler::getThreadState();
+			_prev=state.current;
+			state.current=&_info;
+
+			_watch.start();
+		}
+
+		ProfileZone(const ProfileZone&)=delete;
+		ProfileZone& operator=(const ProfileZone&)=delete;
+
+		~ProfileZone() {
+			_watch.stop();
+
+			Profiler::getThreadState().current=_prev;
+
+			_info.add(_watch.getNanos());
+			Profiler::get().record(_info, _watch);
+		}
+	};
+}
+
+#define CMN_PROFILE_ZONE(name)\
+	static cmn::ProfileZoneInfo CMN_PROFILE_CONCAT(_cmn_zone_info_, __LINE__)(name);\
+	cmn::ProfileZone CMN_PROFILE_CONCAT(_cmn_zone_, __LINE__)(CMN_PROFILE_CONCAT(_cmn_zone_info_, __LINE__))
+
+//print zone tree & save chrome trace
+#define CMN_PROFILE_DUMP(filename) cmn::Profiler::get().dump(filename)
+#else
+#define CMN_PROFILE_ZONE(name)
+#define CMN_PROFILE_DUMP(filename) ((void)0)
+#endif
+#endif
\ No newline at end of file
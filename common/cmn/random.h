@@ -0,0 +1,209 @@
+#pragma once
+#ifndef COMMON_RANDOM_CLASS_H
+#define COMMON_RANDOM_CLASS_H
+
+//seedable xoshiro128 generator.
+//  same seed & stream = same numbers, on any thread.
+//  Random::local() is a per thread instance, so no locking
+//  like std::rand, & fill() makes floats 8 at a time.
+
+//for uint32_t, uint64_t
+#include <cstdint>
+
+#include <atomic>
+
+//for swap
+#include <utility>
+
+#if defined(__SSE2__)||defined(_M_X64)||(defined(_M_IX86_FP)&&_M_IX86_FP>=2)
+#define CMN_RANDOM_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace cmn {
+	class Random {
+		//xoshiro128** for single draws
+		std::uint32_t _s[4];
+
+		//4 xoshiro128+ streams side by side for fill,
+		//  _lanes[w][l] is word w of lane l
+		alignas(16) std::uint32_t _lanes[4][4];
+
+		static std::uint32_t rotl(std::uint32_t x, int k) {
+			return (x<<k)|(x>>(32-k));
+		}
+
+		//expands seeds into state
+		static std::uint64_t splitMix(std::uint64_t& x) {
+			std::uint64_t z=(x+=0x9E3779B97F4A7C15ull);
+			z=(z^(z>>30))*0xBF58476D1CE4E5B9ull;
+			z=(z^(z>>27))*0x94D049BB133111EBull;
+			return z^(z>>31);
+		}
+
+		static std::atomic<std::uint64_t>& sharedSeed() {
+			static std::atomic<std::uint64_t> seed{default_seed};
+			return seed;
+		}
+
+		static std::atomic<std::uint64_t>& nextStream() {
+			static std::atomic<std::uint64_t> stream{0};
+			return stream;
+		}
+
+		//8 floats in [0, 1)*scale+offset
+		void fillBlock(float* out, float scale, float offset) {
+#ifdef CMN_RANDOM_SSE2
+			__m128i s0=_mm_load_si128((const __m128i*)_lanes[0]);
+			__m128i s1=_mm_load_si128((const __m128i*)_lanes[1]);
+			__m128i s2=_mm_load_si128((const __m128i*)_lanes[2]);
+			__m128i s3=_mm_load_si128((const __m128i*)_lanes[3]);
+			const __m128 unit=_mm_set1_ps(scale/16777216.f);
+			const __m128 off=_mm_set1_ps(offset);
+			for(int h=0; h<2; h++) {
+				//top 24 bits convert exactly
+				__m128i r=_mm_srli_epi32(_mm_add_epi32(s0, s3), 8);
+				_mm_storeu_ps(out+4*h, _mm_add_ps(off, _mm_mul_ps(unit, _mm_cvtepi32_ps(r))));
+
+				__m128i t=_mm_slli_epi32(s1, 9);
+				s2=_mm_xor_si128(s2, s0);
+				s3=_mm_xor_si128(s3, s1);
+				s1=_mm_xor_si128(s1, s2);
+				s0=_mm_xor_si128(s0, s3);
+				s2=_mm_xor_si128(s2, t);
+				s3=_mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+			}
+			_mm_store_si128((__m128i*)_lanes[0], s0);
+			_mm_store_si128((__m128i*)_lanes[1], s1);
+			_mm_store_si128((__m128i*)_lanes[2], s2);
+			_mm_store_si128((__m128i*)_lanes[3], s3);
+#else
+			const float unit=scale/16777216.f;
+			for(int l=0; l<4; l++) {
+				std::uint32_t s0=_lanes[0][l], s1=_lanes[1][l];
+				std::uint32_t s2=_lanes[2][l], s3=_lanes[3][l];
+				for(int h=0; h<2; h++) {
+					out[4*h+l]=offset+unit*float(int((s0+s3)>>8));
+
+					std::uint32_t t=s1<<9;
+					s2^=s0;
+					s3^=s1;
+					s1^=s2;
+					s0^=s3;
+					s2^=t;
+					s3=rotl(s3, 11);
+				}
+				_lanes[0][l]=s0, _lanes[1][l]=s1;
+				_lanes[2][l]=s2, _lanes[3][l]=s3;
+			}
+#endif
+		}
+
+	public:
+		static constexpr std::uint64_t default_seed=1;
+
+		Random(std::uint64_t seed=default_seed, std::uint64_t stream=0) {
+			setSeed(seed, stream);
+		}
+
+		//streams of one seed dont overlap in practice
+		void setSeed(std::uint64_t seed, std::uint64_t stream=0) {
+			std::uint64_t x=seed^(0xD1B54A32D192ED03ull*(1+stream));
+			for(int i=0; i<4; i+=2) {
+				std::uint64_t z=splitMix(x);
+				_s[i]=z, _s[i+1]=z>>32;
+			}
+			for(int w=0; w<4; w++) {
+				for(int l=0; l<4; l+=2) {
+					std::uint64_t z=splitMix(x);
+					_lanes[w][l]=z, _lanes[w][l+1]=z>>32;
+				}
+			}
+		}
+
+		std::uint32_t next() {
+			std::uint32_t r=rotl(5*_s[1], 7)*9;
+
+			std::uint32_t t=_s[1]<<9;
+			_s[2]^=_s[0];
+			_s[3]^=_s[1];
+			_s[1]^=_s[2];
+			_s[0]^=_s[3];
+			_s[2]^=t;
+			_s[3]=rotl(_s[3], 11);
+
+			return r;
+		}
+
+		//[0, 1)
+		float nextFloat() {
+			return (next()>>8)/16777216.f;
+		}
+
+		//[0, 1)
+		double nextDouble() {
+			std::uint64_t hi=next(), lo=next();
+			return (((hi<<32)|lo)>>11)/9007199254740992.;
+		}
+
+		//inclusive [a, b], w/o modulo bias.
+		//  multiply & shift, then lemire's rejection
+		//  on the low word, which rarely loops.
+		int nextInt(int a, int b) {
+			std::uint32_t range=std::uint32_t(b)-std::uint32_t(a)+1;
+			if(!range) return next();
+
+			std::uint64_t m=std::uint64_t(next())*range;
+			if(std::uint32_t(m)<range) {
+				//2^32 mod range
+				const std::uint32_t t=(0u-range)%range;
+				while(std::uint32_t(m)<t) m=std::uint64_t(next())*range;
+			}
+			return int(std::uint32_t(a)+std::uint32_t(m>>32));
+		}
+
+		//num floats in [a, b), made 8 at a time
+		void fill(float* out, int num, float b=1, float a=0) {
+			float scale=b-a;
+			int i=0;
+			for(; i+8<=num; i+=8) fillBlock(out+i, scale, a);
+
+			if(i<num) {
+				float rest[8];
+				fillBlock(rest, scale, a);
+				for(int j=0; i<num; i++, j++) out[i]=rest[j];
+			}
+		}
+
+		//fisher-yates
+		template<typename T>
+		void shuffle(T* arr, int num) {
+			for(int i=num-1; i>=1; i--) {
+				std::swap(arr[i], arr[nextInt(0, i)]);
+			}
+		}
+
+		//this thread's generator. threads get streams
+		//  of the shared seed in order of first use.
+		static Random& local() {
+			thread_local Random rng(sharedSeed().load(), nextStream().fetch_add(1));
+			return rng;
+		}
+
+		//reseeds this thread as the given stream of the
+		//  shared seed, for threads w/ a fixed role like pool workers
+		static void seedLocal(std::uint64_t stream) {
+			local().setSeed(sharedSeed().load(), stream);
+		}
+
+		//reseeds this thread as stream 0, & any thread
+		//  that hasnt drawn yet as stream 1, 2, ...
+		static void seedAll(std::uint64_t seed) {
+			Random& rng=local();
+			sharedSeed()=seed;
+			nextStream()=1;
+			rng.setSeed(seed, 0);
+		}
+	};
+}
+#endif
\ No newline at end of file
@@ -34,6 +34,11 @@ namespace cmn {
 		long long getMillis() const {
 			return std::chrono::duration_cast<std::chrono::milliseconds>(m_end-m_start).count();
 		}
+
+		//from other's start to this start
+		long long getNanosSince(const Stopwatch& other) const {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(m_start-other.m_start).count();
+		}
 	};
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,305 @@
+#pragma once
+#ifndef COMMON_THREAD_POOL_CLASS_H
+#define COMMON_THREAD_POOL_CLASS_H
+
+//work stealing thread pool.
+//  every thread has its own queue, takes from the back of it,
+//  & steals from the front of others when empty. threads that
+//  wait on work help run it instead of blocking.
+
+#include <vector>
+#include <deque>
+
+//for min
+#include <algorithm>
+
+#include <functional>
+
+//for unique_ptr
+#include <memory>
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+//for seeding workers
+#include "random.h"
+
+namespace cmn {
+	class ThreadPool {
+		struct Task {
+			std::function<void()> func;
+
+			//decremented once func is done
+			std::atomic<int>* pending=nullptr;
+
+			//deterministic tasks stay on their queue
+			bool pinned=false;
+		};
+
+		struct Queue {
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		//one per worker, then one for outside threads
+		std::vector<std::unique_ptr<Queue>> _queues;
+		std::vector<std::thread> _workers;
+
+		std::mutex _sleep_mutex;
+		std::condition_variable _wake;
+		std::atomic<int> _num_stealable{0};
+		bool _stop=false;
+
+		//which queue this thread owns, per pool
+		struct ThreadSlot {
+			const ThreadPool* pool=nullptr;
+			int index=-1;
+		};
+
+		static ThreadSlot& threadSlot() {
+			thread_local ThreadSlot slot;
+			return slot;
+		}
+
+		int getQueueIndex() const {
+			const ThreadSlot& slot=threadSlot();
+			return slot.pool==this?slot.index:_workers.size();
+		}
+
+		bool popOwn(int q, Task& t) {
+			Queue& queue=*_queues[q];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if(queue.tasks.empty()) return false;
+
+			//pinned tasks run in the order they came,
+			//  so each thread sees the same sequence every run
+			if(queue.tasks.front().pinned) {
+				t=std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+				return true;
+			}
+
+			t=std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+			if(!t.pinned) _num_stealable--;
+			return true;
+		}
+
+		bool steal(int q, Task& t) {
+			const int num=_queues.size();
+			for(int i=1; i<num; i++) {
+				Queue& queue=*_queues[(q+i)%num];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if(queue.tasks.empty()||queue.tasks.front().pinned) continue;
+
+				t=std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+				_num_stealable--;
+				return true;
+			}
+			return false;
+		}
+
+		bool hasWork(int q) {
+			if(_num_stealable>0) return true;
+
+			Queue& queue=*_queues[q];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			return !queue.tasks.empty();
+		}
+
+		static void runTask(Task& t) {
+			t.func();
+			if(t.pending) t.pending->fetch_sub(1, std::memory_order_acq_rel);
+		}
+
+		void workerLoop(int q) {
+			threadSlot()={this, q};
+
+			//by index, not by who draws first
+			Random::seedLocal(worker_stream+q);
+
+			Task t;
+			while(true) {
+				if(popOwn(q, t)||steal(q, t)) {
+					runTask(t);
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(_sleep_mutex);
+				_wake.wait(lock, [&] { return _stop||hasWork(q); });
+				if(_stop) return;
+			}
+		}
+
+		void push(int q, Task&& t) {
+			const bool pinned=t.pinned;
+			{
+				Queue& queue=*_queues[q];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				queue.tasks.push_back(std::move(t));
+				if(!pinned) _num_stealable++;
+			}
+
+			//so a worker between its check & its wait still hears it
+			{ std::lock_guard<std::mutex> lock(_sleep_mutex); }
+
+			//only the owner can run pinned tasks
+			if(pinned) _wake.notify_all();
+			else _wake.notify_one();
+		}
+
+	public:
+		//static partitioning: chunk c always runs on thread c%num,
+		//  in chunk order, & nothing is stolen. w/ Random::seedAll
+		//  called before the pool starts, every chunk draws the same
+		//  Random::local() numbers every run.
+		bool deterministic=false;
+
+		//worker q seeds its Random::local() as this stream+q of the
+		//  shared seed, clear of the ones other threads get lazily.
+		static constexpr std::uint64_t worker_stream=1ull<<32;
+
+		//num_threads counts the calling thread, 0=all cores
+		ThreadPool(int num_threads=0) {
+#ifdef __EMSCRIPTEN__
+			num_threads=1;
+#else
+			if(num_threads<=0) num_threads=std::thread::hardware_concurrency();
+			if(num_threads<=0) num_threads=1;
+#endif
+
+			for(int i=0; i<num_threads; i++) _queues.push_back(std::make_unique<Queue>());
+			for(int i=0; i<num_threads-1; i++) _workers.emplace_back(&ThreadPool::workerLoop, this, i);
+		}
+
+		ThreadPool(const ThreadPool&)=delete;
+		ThreadPool& operator=(const ThreadPool&)=delete;
+
+		~ThreadPool() {
+			{
+				std::lock_guard<std::mutex> lock(_sleep_mutex);
+				_stop=true;
+			}
+			_wake.notify_all();
+			for(auto& w:_workers) w.join();
+		}
+
+		int getNumThreads() const { return _queues.size(); }
+
+		//lazily made w/ every core
+		static ThreadPool& shared() {
+			static ThreadPool pool;
+			return pool;
+		}
+
+		//queues func, & decrements pending when its done.
+		//  slot picks the queue in deterministic mode.
+		void submit(std::function<void()> func, std::atomic<int>& pending, int slot=-1) {
+			if(_workers.empty()) {
+				func();
+				pending.fetch_sub(1, std::memory_order_acq_rel);
+				return;
+			}
+
+			Task t{std::move(func), &pending, deterministic};
+			int q=deterministic&&slot>=0?slot%_queues.size():getQueueIndex();
+			push(q, std::move(t));
+		}
+
+		//runs queued work until pending hits 0
+		void wait(std::atomic<int>& pending) {
+			const int q=getQueueIndex();
+			Task t;
+			while(pending.load(std::memory_order_acquire)>0) {
+				if(popOwn(q, t)||(!deterministic&&steal(q, t))) runTask(t);
+				else std::this_thread::yield();
+			}
+		}
+
+		//f(i0, i1) over [begin, end) in chunks of grain.
+		//  chunk bounds only depend on grain, never thread count.
+		template<typename Func>
+		void parallelFor(int begin, int end, int grain, Func f) {
+			if(grain<1) grain=1;
+			const int num_chunks=(end-begin+grain-1)/grain;
+			if(num_chunks<=0) return;
+
+			//not worth the queueing
+			if(num_chunks==1||_workers.empty()) {
+				for(int c=0; c<num_chunks; c++) {
+					int i0=begin+c*grain;
+					f(i0, std::min(end, i0+grain));
+				}
+				return;
+			}
+
+			std::atomic<int> pending{num_chunks};
+			const int num_queues=_queues.size();
+			for(int c=0; c<num_chunks; c++) {
+				int i0=begin+c*grain, i1=std::min(end, i0+grain);
+
+				//spread out up front, stealing evens it out later
+				Task t{[&f, i0, i1] { f(i0, i1); }, &pending, deterministic};
+				push(c%num_queues, std::move(t));
+			}
+			wait(pending);
+		}
+	};
+
+	//tasks w/ dependencies, run on a pool.
+	//  a task starts once every task before it finishes.
+	class TaskGraph {
+		struct Node {
+			std::function<void()> func;
+			std::vector<int> next;
+			int num_deps=0;
+		};
+
+		std::vector<Node> _nodes;
+
+	public:
+		int add(std::function<void()> func) {
+			_nodes.push_back({std::move(func), {}, 0});
+			return _nodes.size()-1;
+		}
+
+		//a must finish before b starts
+		void precede(int a, int b) {
+			_nodes[a].next.push_back(b);
+			_nodes[b].num_deps++;
+		}
+
+		int getNumTasks() const { return _nodes.size(); }
+
+		void clear() { _nodes.clear(); }
+
+		//blocks until every task has run
+		void run(ThreadPool& pool) {
+			const int num=_nodes.size();
+			if(!num) return;
+
+			std::vector<std::atomic<int>> deps_left(num);
+			for(int i=0; i<num; i++) deps_left[i]=_nodes[i].num_deps;
+
+			std::atomic<int> pending{num};
+			std::function<void(int)> launch=[&] (int i) {
+				pool.submit([&, i] {
+					_nodes[i].func();
+
+					//the last dependency to finish starts it
+					for(const auto& n:_nodes[i].next) {
+						if(deps_left[n].fetch_sub(1, std::memory_order_acq_rel)==1) launch(n);
+					}
+				}, pending, i);
+			};
+			for(int i=0; i<num; i++) {
+				if(!_nodes[i].num_deps) launch(i);
+			}
+			pool.wait(pending);
+		}
+	};
+}
+#endif
\ No newline at end of file
@@ -2,8 +2,7 @@
 #ifndef COMMON_UTILS_H
 #define COMMON_UTILS_H
 
-//for rand
-#include <cstdlib>
+#include "random.h"
 
 //for trig
 #include <cmath>
@@ -14,20 +13,23 @@ namespace cmn {
 	//random(a)=0-a
 	//random(a, b)=a-b
 	float randFloat(float b=1, float a=0) {
-		static const float rand_max=RAND_MAX;
-		float t=std::rand()/rand_max;
+		float t=Random::local().nextFloat();
 		return a+t*(b-a);
 	}
 
 	double randDouble(double b=1, double a=0) {
-		static const double rand_max=RAND_MAX;
-		double t=std::rand()/rand_max;
+		double t=Random::local().nextDouble();
 		return a+t*(b-a);
 	}
 
 	//inclusive integer choice [a, b]
 	int randInt(int a, int b) {
-		return a+std::rand()%(1+b-a);
+		return Random::local().nextInt(a, b);
+	}
+
+	//like srand, but for the above
+	void seedRandom(std::uint64_t seed) {
+		Random::seedAll(seed);
 	}
 
 	//clamps x to [a, b]
@@ -15,6 +15,8 @@
 #include "../cmn/math/v3d.h"
 #include "../cmn/math/mat4.h"
 
+#include "../cmn/profiler.h"
+
 #include "triangle.h"
 #include "line.h"
 
@@ -112,6 +114,8 @@ namespace cmn {
 		}
 
 		void projectAndClip() {
+			CMN_PROFILE_ZONE("Engine3D::projectAndClip");
+
 			//recalculate matrices
 			{
 				mat4 look_at=mat4::makeLookAt(cam_pos, cam_pos+cam_dir, cam_up);
@@ -642,6 +646,8 @@ namespace cmn {
 	bool Engine3D::OnUserDestroy() {
 		if(!user_destroy()) return false;
 
+		CMN_PROFILE_DUMP("trace.json");
+
 		delete[] depth_buffer;
 
 		delete[] id_buffer;
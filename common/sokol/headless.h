@@ -0,0 +1,98 @@
+//include right before sokol_app.h.
+//  CMN_SOKOL_HEADLESS builds need no window or gpu: sokol_app's
+//  implementation is swapped for the stand-in below, and sokol_gfx
+//  runs on its dummy backend. see cmn::SokolEngine::runHeadless.
+#ifdef CMN_SOKOL_HEADLESS
+#ifndef CMN_SOKOL_HEADLESS_H
+#define CMN_SOKOL_HEADLESS_H
+
+#undef SOKOL_GLCORE
+#undef SOKOL_GLES3
+#undef SOKOL_D3D11
+#undef SOKOL_METAL
+#define SOKOL_DUMMY_BACKEND
+
+//implement everything but sokol_app
+#ifdef SOKOL_IMPL
+#undef SOKOL_IMPL
+#define SOKOL_GFX_IMPL
+#define SOKOL_GLUE_IMPL
+#define SOKOL_GL_IMPL
+#define SOKOL_IMGUI_IMPL
+#endif
+
+#include "include/sokol_app.h"
+
+//for memset
+#include <cstring>
+
+//what the engine tells the stand-in
+struct CmnHeadlessState {
+	int width=640, height=480;
+	double frame_duration=1/60.;
+	uint64_t frame_count=0;
+	bool quit_requested=false;
+};
+static CmnHeadlessState cmn_headless;
+
+#pragma region SAPP_STAND_IN
+bool sapp_isvalid(void) { return true; }
+int sapp_width(void) { return cmn_headless.width; }
+float sapp_widthf(void) { return cmn_headless.width; }
+int sapp_height(void) { return cmn_headless.height; }
+float sapp_heightf(void) { return cmn_headless.height; }
+sapp_pixel_format sapp_color_format(void) { return SAPP_PIXELFORMAT_RGBA8; }
+sapp_pixel_format sapp_depth_format(void) { return SAPP_PIXELFORMAT_DEPTH_STENCIL; }
+int sapp_sample_count(void) { return 1; }
+bool sapp_high_dpi(void) { return false; }
+float sapp_dpi_scale(void) { return 1; }
+void sapp_show_keyboard(bool) {}
+bool sapp_keyboard_shown(void) { return false; }
+bool sapp_is_fullscreen(void) { return false; }
+void sapp_toggle_fullscreen(void) {}
+void sapp_show_mouse(bool) {}
+bool sapp_mouse_shown(void) { return true; }
+void sapp_lock_mouse(bool) {}
+bool sapp_mouse_locked(void) { return false; }
+void sapp_set_mouse_cursor(sapp_mouse_cursor) {}
+sapp_mouse_cursor sapp_get_mouse_cursor(void) { return SAPP_MOUSECURSOR_DEFAULT; }
+sapp_mouse_cursor sapp_bind_mouse_cursor_image(sapp_mouse_cursor c, const sapp_image_desc*) { return c; }
+void sapp_unbind_mouse_cursor_image(sapp_mouse_cursor) {}
+void* sapp_userdata(void) { return nullptr; }
+sapp_desc sapp_query_desc(void) { return {}; }
+void sapp_request_quit(void) { cmn_headless.quit_requested=true; }
+void sapp_cancel_quit(void) { cmn_headless.quit_requested=false; }
+void sapp_quit(void) { cmn_headless.quit_requested=true; }
+void sapp_consume_event(void) {}
+uint64_t sapp_frame_count(void) { return cmn_headless.frame_count; }
+double sapp_frame_duration(void) { return cmn_headless.frame_duration; }
+void sapp_set_clipboard_string(const char*) {}
+const char* sapp_get_clipboard_string(void) { return ""; }
+void sapp_set_window_title(const char*) {}
+void sapp_set_icon(const sapp_icon_desc*) {}
+int sapp_get_num_dropped_files(void) { return 0; }
+const char* sapp_get_dropped_file_path(int) { return ""; }
+void sapp_run(const sapp_desc*) {}
+
+sapp_environment sapp_get_environment(void) {
+	sapp_environment env;
+	std::memset(&env, 0, sizeof(env));
+	env.defaults.color_format=sapp_color_format();
+	env.defaults.depth_format=sapp_depth_format();
+	env.defaults.sample_count=sapp_sample_count();
+	return env;
+}
+
+sapp_swapchain sapp_get_swapchain(void) {
+	sapp_swapchain sc;
+	std::memset(&sc, 0, sizeof(sc));
+	sc.width=sapp_width();
+	sc.height=sapp_height();
+	sc.sample_count=sapp_sample_count();
+	sc.color_format=sapp_color_format();
+	sc.depth_format=sapp_depth_format();
+	return sc;
+}
+#pragma endregion
+#endif
+#endif
\ No newline at end of file
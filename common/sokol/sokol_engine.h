@@ -8,6 +8,17 @@
 //for snprintf
 #include <cstdio>
 
+//for strcmp, atoi, atof
+#include <cstring>
+#include <cstdlib>
+
+#include <iostream>
+
+#include "../cmn/stopwatch.h"
+
+#include "../cmn/frame_profiler.h"
+#include "../cmn/profiler.h"
+
 namespace cmn {
 	class SokolEngine {
 		static const int _num_keys=512;
@@ -23,6 +34,28 @@ namespace cmn {
 		float _mouse_x_next=0, _mouse_y_next=0;
 		float _mouse_x_curr=0, _mouse_y_curr=0;
 
+		Stopwatch _frame_watch;
+
+		bool _created=false;
+
+		void _updateInput() {
+			//update keys
+			std::memcpy(_keys_prev, _keys_curr, sizeof(_keys_curr));
+			std::memcpy(_keys_curr, _keys_next, sizeof(_keys_curr));
+
+			//update mouse buttons
+			std::memcpy(_mouse_buttons_prev, _mouse_buttons_curr, sizeof(_mouse_buttons_curr));
+			std::memcpy(_mouse_buttons_curr, _mouse_buttons_next, sizeof(_mouse_buttons_curr));
+
+			//update mouse pos
+			_mouse_x_curr=_mouse_x_next;
+			_mouse_y_curr=_mouse_y_next;
+		}
+
+		float _elapsedMillis() const {
+			return _frame_watch.getNanos()/1e6f;
+		}
+
 	public:
 		virtual bool user_create()=0;
 		virtual bool user_update(float dt)=0;
@@ -32,6 +65,30 @@ namespace cmn {
 
 		std::string app_title="[untitled]";
 
+		//update & render times of every frame,
+		//  saved on exit if profile_path is set.
+		FrameProfiler frame_profiler;
+		std::string profile_path;
+
+		//CMN_PROFILE zones, saved on exit as a chrome trace
+		std::string trace_path;
+
+		//headless runs: fixed dt, no rendering
+		int headless_steps=600;
+		float headless_dt=1/60.f;
+
+		//--profile <file.csv|file.json>
+		//--trace <file.json> w/ CMN_PROFILE
+		//--steps <num> --dt <seconds> for headless
+		void parseArgs(int argc, char* argv[]) {
+			for(int i=1; i+1<argc; i++) {
+				if(!std::strcmp(argv[i], "--profile")) profile_path=argv[++i];
+				else if(!std::strcmp(argv[i], "--trace")) trace_path=argv[++i];
+				else if(!std::strcmp(argv[i], "--steps")) headless_steps=std::atoi(argv[++i]);
+				else if(!std::strcmp(argv[i], "--dt")) headless_dt=std::atof(argv[++i]);
+			}
+		}
+
 		void init() {
 			//should this be here...
 			sg_desc desc{};
@@ -46,7 +103,8 @@ namespace cmn {
 			std::memset(_mouse_buttons_curr, false, sizeof(bool)*_num_mouse_buttons);
 			std::memset(_mouse_buttons_next, false, sizeof(bool)*_num_mouse_buttons);
 
-			if(!user_create()) sapp_request_quit();
+			_created=user_create();
+			if(!_created) sapp_request_quit();
 		}
 
 		void input(const sapp_event* e) {
@@ -74,17 +132,7 @@ namespace cmn {
 		}
 
 		void frame() {
-			//update keys
-			std::memcpy(_keys_prev, _keys_curr, sizeof(_keys_curr));
-			std::memcpy(_keys_curr, _keys_next, sizeof(_keys_curr));
-
-			//update mouse buttons
-			std::memcpy(_mouse_buttons_prev, _mouse_buttons_curr, sizeof(_mouse_buttons_curr));
-			std::memcpy(_mouse_buttons_curr, _mouse_buttons_next, sizeof(_mouse_buttons_curr));
-
-			//update mouse pos
-			_mouse_x_curr=_mouse_x_next;
-			_mouse_y_curr=_mouse_y_next;
+			_updateInput();
 
 			float dt=sapp_frame_duration();
 
@@ -101,16 +149,61 @@ namespace cmn {
 				sapp_set_window_title(buf);
 			}
 
+			_frame_watch.start();
 			if(!user_update(dt)) sapp_request_quit();
+			_frame_watch.stop();
+			float update_ms=_elapsedMillis();
 
+			_frame_watch.start();
 			if(!user_render()) sapp_request_quit();
+			_frame_watch.stop();
+			float render_ms=_elapsedMillis();
+
+			frame_profiler.addFrame(update_ms, render_ms);
 		}
 
 		void cleanup() {
 			user_destroy();
 
 			sg_shutdown();
+
+			if(profile_path.size()&&!frame_profiler.save(profile_path)) {
+				std::cout<<"unable to save profile to "<<profile_path<<'\n';
+			}
+
+			if(trace_path.size()) CMN_PROFILE_DUMP(trace_path);
+		}
+
+#ifdef CMN_SOKOL_HEADLESS
+		//runs user_update headless_steps times at headless_dt,
+		//  w/o a window. no input, & user_render never runs.
+		//  returns false if the app asked to quit early.
+		bool runHeadless() {
+			cmn_headless.frame_duration=headless_dt;
+
+			init();
+
+			bool ok=_created;
+			for(int i=0; ok&&i<headless_steps; i++) {
+				_updateInput();
+
+				_frame_watch.start();
+				ok=user_update(headless_dt);
+				_frame_watch.stop();
+				frame_profiler.addFrame(_elapsedMillis());
+
+				cmn_headless.frame_count++;
+				if(cmn_headless.quit_requested) ok=false;
+			}
+
+			std::cout<<app_title<<" headless, "<<headless_steps<<" steps of "<<headless_dt<<"s:\n";
+			frame_profiler.print(std::cout);
+
+			cleanup();
+
+			return ok;
 		}
+#endif
 
 		struct ButtonState { bool pressed, held, released; };
 
@@ -126,10 +219,30 @@ namespace cmn {
 
 		float GetMouseX() const { return _mouse_x_curr; }
 		float GetMouseY() const { return _mouse_y_curr; }
+
+		//generated shaders pick their source by this.
+		//  headless runs the dummy backend, which takes any of them.
+		sg_backend getBackend() const {
+#ifdef CMN_SOKOL_HEADLESS
+			return SG_BACKEND_GLCORE;
+#else
+			return sg_query_backend();
+#endif
+		}
 	};
 }
 
 //convenience macro
+#ifdef CMN_SOKOL_HEADLESS
+#define CMN_SOKOL_ENGINE_LAUNCH(AppClass, init_w, init_h)\
+int main(int argc, char* argv[]) {\
+	cmn_headless.width=init_w;\
+	cmn_headless.height=init_h;\
+	static AppClass app;\
+	app.parseArgs(argc, argv);\
+	return app.runHeadless()?0:1;\
+}
+#else
 #define CMN_SOKOL_ENGINE_LAUNCH(AppClass, init_w, init_h)\
 static AppClass* app_ptr=nullptr;\
 static void init_cb() { app_ptr->init(); }\
@@ -139,6 +252,7 @@ static void cleanup_cb() { app_ptr->cleanup(); }\
 sapp_desc sokol_main(int argc, char* argv[]) {\
 	static AppClass app;\
 	app_ptr=&app;\
+	app.parseArgs(argc, argv);\
 	sapp_desc app_desc{};\
 	app_desc.init_cb=init_cb;\
 	app_desc.frame_cb=frame_cb;\
@@ -149,4 +263,5 @@ sapp_desc sokol_main(int argc, char* argv[]) {\
 	app_desc.icon.sokol_default=true;\
 	return app_desc;\
 }
+#endif
 #endif
\ No newline at end of file
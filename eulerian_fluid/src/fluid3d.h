@@ -5,15 +5,10 @@
 
 #include <string.h>
 
-template<typename T>
-const T& min(const T& a, const T& b) {
-	return a<b?a:b;
-}
+//for min & max
+#include <algorithm>
 
-template<typename T>
-const T& max(const T& a, const T& b) {
-	return a>b?a:b;
-}
+#include "cmn/thread_pool.h"
 
 struct Fluid3D {
 	int num_x=0, num_y=0, num_z=0;
@@ -27,6 +22,9 @@ struct Fluid3D {
 	float* m=nullptr;
 	float* new_m=nullptr;
 
+	//null uses the shared pool
+	cmn::ThreadPool* pool=nullptr;
+
 	enum {
 		U_FIELD=0,
 		V_FIELD,
@@ -73,6 +71,7 @@ struct Fluid3D {
 		num_cells=f.num_cells;
 		density=f.density;
 		h=f.h;
+		pool=f.pool;
 
 		u=new float[num_cells];
 		v=new float[num_cells];
@@ -216,9 +215,9 @@ struct Fluid3D {
 		float h2=h/2;
 
 		//clamp query
-		x=max(h, min(x, num_x*h));
-		y=max(h, min(y, num_y*h));
-		z=max(h, min(z, num_z*h));
+		x=std::max(h, std::min(x, num_x*h));
+		y=std::max(h, std::min(y, num_y*h));
+		z=std::max(h, std::min(z, num_z*h));
 
 		float dx=0.f, dy=0.f, dz=0.f;
 
@@ -233,12 +232,12 @@ struct Fluid3D {
 		if(!f) return 0.f;
 
 		//find four corners to interpolate
-		int x0=min(int(h1*(x-dx)), num_x-1);
-		int y0=min(int(h1*(y-dy)), num_y-1);
-		int z0=min(int(h1*(z-dz)), num_z-1);
-		int x1=min(x0+1, num_x-1);
-		int y1=min(y0+1, num_y-1);
-		int z1=min(z0+1, num_z-1);
+		int x0=std::min(int(h1*(x-dx)), num_x-1);
+		int y0=std::min(int(h1*(y-dy)), num_y-1);
+		int z0=std::min(int(h1*(z-dz)), num_z-1);
+		int x1=std::min(x0+1, num_x-1);
+		int y1=std::min(y0+1, num_y-1);
+		int z1=std::min(z0+1, num_z-1);
 
 		//find interpolation factors
 		float tx=h1*((x-dx)-h*x0);
@@ -306,35 +305,39 @@ struct Fluid3D {
 
 		float h2=h/2;
 
-		for(int i=1; i<num_x; i++) {
-			for(int j=1; j<num_y; j++) {
-				for(int k=1; k<num_y; k++) {
-					if(solid[ix(i, j, k)]) continue;
+		//only reads old fields, so slices of i are independent
+		cmn::ThreadPool& p=pool?*pool:cmn::ThreadPool::shared();
+		p.parallelFor(1, num_x, 1, [&] (int i0, int i1) {
+			for(int i=i0; i<i1; i++) {
+				for(int j=1; j<num_y; j++) {
+					for(int k=1; k<num_z; k++) {
+						if(solid[ix(i, j, k)]) continue;
 
-					if(!solid[ix(i-1, j, k)]&&j<num_y-1&&k<num_z-1) {
-						float x=h*i, y=h2+h*j, z=h2+h*k;
-						float u0=u[ix(i, j, k)];
-						float v0=avgV(i, j, k);
-						float w0=avgW(i, j, k);
-						new_u[ix(i, j, k)]=sampleField(x-dt*u0, y-dt*v0, z-dt*w0, U_FIELD);
-					}
-					if(!solid[ix(i, j-1, k)]&&k<num_z-1&&i<num_x-1) {
-						float x=h2+h*i, y=h*j, z=h2+h*k;
-						float u0=avgU(i, j, k);
-						float v0=v[ix(i, j, k)];
-						float w0=avgW(i, j, k);
-						new_v[ix(i, j, k)]=sampleField(x-dt*u0, y-dt*v0, z-dt*w0, V_FIELD);
-					}
-					if(!solid[ix(i, j, k-1)]&&i<num_x-1&&j<num_y-1) {
-						float x=h2+h*i, y=h2+h*j, z=h*k;
-						float u0=avgU(i, j, k);
-						float v0=avgV(i, j, k);
-						float w0=w[ix(i, j, k)];
-						new_w[ix(i, j, k)]=sampleField(x-dt*u0, y-dt*v0, z-dt*w0, W_FIELD);
+						if(!solid[ix(i-1, j, k)]&&j<num_y-1&&k<num_z-1) {
+							float x=h*i, y=h2+h*j, z=h2+h*k;
+							float u0=u[ix(i, j, k)];
+							float v0=avgV(i, j, k);
+							float w0=avgW(i, j, k);
+							new_u[ix(i, j, k)]=sampleField(x-dt*u0, y-dt*v0, z-dt*w0, U_FIELD);
+						}
+						if(!solid[ix(i, j-1, k)]&&k<num_z-1&&i<num_x-1) {
+							float x=h2+h*i, y=h*j, z=h2+h*k;
+							float u0=avgU(i, j, k);
+							float v0=v[ix(i, j, k)];
+							float w0=avgW(i, j, k);
+							new_v[ix(i, j, k)]=sampleField(x-dt*u0, y-dt*v0, z-dt*w0, V_FIELD);
+						}
+						if(!solid[ix(i, j, k-1)]&&i<num_x-1&&j<num_y-1) {
+							float x=h2+h*i, y=h2+h*j, z=h*k;
+							float u0=avgU(i, j, k);
+							float v0=avgV(i, j, k);
+							float w0=w[ix(i, j, k)];
+							new_w[ix(i, j, k)]=sampleField(x-dt*u0, y-dt*v0, z-dt*w0, W_FIELD);
+						}
 					}
 				}
 			}
-		}
+		});
 
 		//copy values over
 		memcpy(u, new_u, sizeof(float)*num_cells);
@@ -6,8 +6,14 @@ using olc::vf2d;
 
 #include "fluid.h"
 
+#include "fluid3d.h"
+
 #include "cmn/utils.h"
 
+#include "cmn/stopwatch.h"
+
+#include <iostream>
+
 struct FluidUI : olc::PixelGameEngine {
 	FluidUI() {
 		sAppName="Fluid";
@@ -88,6 +94,41 @@ struct FluidUI : olc::PixelGameEngine {
 		return true;
 	}
 
+	//times 3d advection on a 64^3 grid w/ 1..N threads
+	void benchmarkAdvection() {
+		const int num_steps=4;
+		Fluid3D base(62, 62, 62, 1000, 1/64.f);
+		for(int i=0; i<base.num_cells; i++) {
+			base.u[i]=cmn::randFloat(1, -1);
+			base.v[i]=cmn::randFloat(1, -1);
+			base.w[i]=cmn::randFloat(1, -1);
+		}
+
+		int max_threads=std::thread::hardware_concurrency();
+		if(max_threads<1) max_threads=1;
+
+		std::cout<<"Fluid3D::advectVel: 64^3 cells, "<<num_steps<<" steps\n";
+		double base_ms=0;
+		for(int n=1; n<=max_threads; n++) {
+			cmn::ThreadPool p(n);
+			Fluid3D test=base;
+			test.pool=&p;
+
+			cmn::Stopwatch watch;
+			watch.start();
+			for(int i=0; i<num_steps; i++) test.advectVel(1/60.f);
+			watch.stop();
+
+			//should match for every thread count
+			double checksum=0;
+			for(int i=0; i<test.num_cells; i++) checksum+=test.u[i]+test.v[i]+test.w[i];
+
+			double ms=watch.getMicros()/1000.;
+			if(n==1) base_ms=ms;
+			std::cout<<"  "<<n<<" threads: "<<ms<<" ms, "
+				<<base_ms/ms<<"x, checksum "<<checksum<<'\n';
+		}
+	}
 
 	bool OnUserUpdate(float dt) override {
 		if(dt>1/60.f) dt=1/60.f;
@@ -103,6 +144,8 @@ struct FluidUI : olc::PixelGameEngine {
 		if(GetKey(olc::Key::P).bPressed) show_pressure^=true;
 		if(GetKey(olc::Key::S).bPressed) show_streamlines^=true;
 
+		if(GetKey(olc::Key::B).bPressed) benchmarkAdvection();
+
 		//update fluid
 		fluid->solveIncompressibility(40, dt);
 
@@ -10,6 +10,8 @@
 //for sqrt
 #include <cmath>
 
+#include "cmn/profiler.h"
+
 struct FlipFluid {
 	float density=0;
 
@@ -56,6 +58,12 @@ struct FlipFluid {
 
 	int num_particles=0;
 
+	//sort particles into cell order every this many steps,
+	//  so neighbors stay close in memory. 0=never
+	int reorder_interval=0;
+	int num_steps=0;
+	float* particle_scratch=nullptr;
+
 	FlipFluid() {}
 
 	//95-141
@@ -109,6 +117,8 @@ struct FlipFluid {
 		first_cell_particle=new int[1+p_num_cells];
 		cell_particle_ids=new int[max_particles];
 
+		particle_scratch=new float[3*max_particles];
+
 		num_particles=0;
 	}
 
@@ -139,6 +149,8 @@ struct FlipFluid {
 		delete[] num_cell_particles;
 		delete[] first_cell_particle;
 		delete[] cell_particle_ids;
+
+		delete[] particle_scratch;
 	}
 
 	//ro3 3
@@ -161,10 +173,8 @@ struct FlipFluid {
 		}
 	}
 
-	//152-251
-	void pushParticlesApart(int num_iter) {
-		float color_diffusion_coeff=.001f;
-
+	//counting sort of particles by cell
+	void fillParticleCells() {
 		//count particles per cell
 		std::memset(num_cell_particles, 0, sizeof(int)*p_num_cells);
 		for(int i=0; i<num_particles; i++) {
@@ -196,6 +206,32 @@ struct FlipFluid {
 			first_cell_particle[cell_nr]--;
 			cell_particle_ids[first_cell_particle[cell_nr]]=i;
 		}
+	}
+
+	//moves particle cell_particle_ids[k] to k
+	void permuteParticles(float* arr, int num) {
+		for(int k=0; k<num_particles; k++) {
+			const int id=cell_particle_ids[k];
+			for(int c=0; c<num; c++) particle_scratch[c+num*k]=arr[c+num*id];
+		}
+		std::memcpy(arr, particle_scratch, sizeof(float)*num*num_particles);
+	}
+
+	//uses the last fillParticleCells order
+	void reorderParticles() {
+		permuteParticles(particle_pos, 2);
+		permuteParticles(particle_vel, 2);
+		permuteParticles(particle_color, 3);
+
+		//cells now hold particles in order
+		for(int k=0; k<num_particles; k++) cell_particle_ids[k]=k;
+	}
+
+	//152-251
+	void pushParticlesApart(int num_iter) {
+		float color_diffusion_coeff=.001f;
+
+		fillParticleCells();
 
 		//push particles apart
 		float min_dist=2*particle_radius;
@@ -563,19 +599,51 @@ struct FlipFluid {
 		float over_relaxation, bool compensate_drift, bool separate_particles,
 		float obstacle_x, float obstacle_y, float obstacle_vel_x, float obstacle_vel_y, float obstacle_radius
 	) {
+		CMN_PROFILE_ZONE("FlipFluid::simulate");
+
 		int num_sub_steps=1;
 		float sdt=dt/num_sub_steps;
 
 		for(int step=0; step<num_sub_steps; step++) {
-			integrateParticles(sdt, gravity);
-			if(separate_particles) pushParticlesApart(num_particle_iters);
-			handleParticleCollisions(obstacle_x, obstacle_y, obstacle_vel_x, obstacle_vel_y, obstacle_radius);
-			transferVelocities(true);
-			updateParticleDensity();
-			solveIncompressibility(num_pressure_iters, sdt, over_relaxation, compensate_drift);
-			transferVelocities(false, flip_ratio);
+			{
+				CMN_PROFILE_ZONE("integrateParticles");
+				integrateParticles(sdt, gravity);
+			}
+			if(separate_particles) {
+				CMN_PROFILE_ZONE("pushParticlesApart");
+				pushParticlesApart(num_particle_iters);
+			}
+			if(reorder_interval>0&&num_steps%reorder_interval==0) {
+				CMN_PROFILE_ZONE("reorderParticles");
+
+				//reuse the cells push just filled
+				if(!separate_particles) fillParticleCells();
+				reorderParticles();
+			}
+			num_steps++;
+			{
+				CMN_PROFILE_ZONE("handleParticleCollisions");
+				handleParticleCollisions(obstacle_x, obstacle_y, obstacle_vel_x, obstacle_vel_y, obstacle_radius);
+			}
+			{
+				CMN_PROFILE_ZONE("transferVelocities to grid");
+				transferVelocities(true);
+			}
+			{
+				CMN_PROFILE_ZONE("updateParticleDensity");
+				updateParticleDensity();
+			}
+			{
+				CMN_PROFILE_ZONE("solveIncompressibility");
+				solveIncompressibility(num_pressure_iters, sdt, over_relaxation, compensate_drift);
+			}
+			{
+				CMN_PROFILE_ZONE("transferVelocities to particles");
+				transferVelocities(false, flip_ratio);
+			}
 		}
 
+		CMN_PROFILE_ZONE("update colors");
 		updateParticleColors();
 		updateCellColors();
 	}
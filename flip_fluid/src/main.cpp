@@ -6,6 +6,10 @@ using olc::vf2d;
 
 #include "flip_fluid.h"
 
+#include "cmn/stopwatch.h"
+
+#include <iostream>
+
 struct FluidUI : olc::PixelGameEngine {
 	FluidUI() {
 		sAppName="Flip Fluid Simulation";
@@ -34,6 +38,24 @@ struct FluidUI : olc::PixelGameEngine {
 		c_scale=ScreenHeight()/sim_height;
 		float sim_width=ScreenWidth()/c_scale;
 
+		setupFluid(sim_width, sim_height);
+
+		setObstacle(3, 2, true);
+
+		{
+			int sz=512;
+			prim_circ_spr=new olc::Sprite(sz, sz);
+			SetDrawTarget(prim_circ_spr);
+			Clear(olc::BLANK);
+			FillCircle(sz/2, sz/2, sz/2, olc::WHITE);
+			SetDrawTarget(nullptr);
+			prim_circ_dec=new olc::Decal(prim_circ_spr);
+		}
+
+		return true;
+	}
+
+	void setupFluid(float sim_width, float sim_height) {
 		int res=100;
 		float tank_height=1*sim_height;
 		float tank_width=1*sim_width;
@@ -75,20 +97,6 @@ struct FluidUI : olc::PixelGameEngine {
 				fluid->s[fluid->fIX(i, j)]=s;
 			}
 		}
-
-		setObstacle(3, 2, true);
-
-		{
-			int sz=512;
-			prim_circ_spr=new olc::Sprite(sz, sz);
-			SetDrawTarget(prim_circ_spr);
-			Clear(olc::BLANK);
-			FillCircle(sz/2, sz/2, sz/2, olc::WHITE);
-			SetDrawTarget(nullptr);
-			prim_circ_dec=new olc::Decal(prim_circ_spr);
-		}
-
-		return true;
 	}
 
 	//1021
@@ -125,8 +133,49 @@ struct FluidUI : olc::PixelGameEngine {
 		obstacle_vel_y=vy;
 	}
 
+	//long runs w/ & w/o reordering, stirred by a circling obstacle
+	void benchmarkReorder() {
+		const int num_steps=1200, window=200;
+		const float sim_width=ScreenWidth()/c_scale, sim_height=ScreenHeight()/c_scale;
+
+		FlipFluid* orig=fluid;
+		const float orig_x=obstacle_x, orig_y=obstacle_y;
+		for(const auto& interval:{0, 10}) {
+			setupFluid(sim_width, sim_height);
+			fluid->reorder_interval=interval;
+
+			std::cout<<"reorder every "<<interval<<" steps (0=never):\n";
+			long long window_us=0;
+			for(int i=0; i<num_steps; i++) {
+				float t=i*time_step;
+				setObstacle(.5f*sim_width+.3f*sim_width*std::cos(t), .5f*sim_height+.2f*sim_height*std::sin(t), i==0);
+
+				cmn::Stopwatch watch;
+				watch.start();
+				fluid->simulate(
+					time_step, 9.81f, .9f, 50, 2, 1.9f, true, true,
+					obstacle_x, obstacle_y, obstacle_vel_x, obstacle_vel_y, obstacle_radius
+				);
+				watch.stop();
+				window_us+=watch.getMicros();
+
+				if((i+1)%window==0) {
+					std::cout<<"  steps "<<i+1-window<<"-"<<i+1<<": "<<window_us/1000.f/window<<" ms/step\n";
+					window_us=0;
+				}
+			}
+
+			delete fluid;
+		}
+
+		fluid=orig;
+		setObstacle(orig_x, orig_y, true);
+	}
+
 	bool OnUserDestroy() override {
 		delete fluid;
+
+		CMN_PROFILE_DUMP("trace.json");
 		
 		return true;
 	}
@@ -139,6 +188,8 @@ struct FluidUI : olc::PixelGameEngine {
 
 	bool OnUserUpdate(float dt) override {
 		if(GetKey(olc::Key::D).bPressed) show_density^=true;
+
+		if(GetKey(olc::Key::B).bPressed) benchmarkReorder();
 		
 		const auto mouse_left=GetMouse(olc::Mouse::LEFT);
 		if(mouse_left.bPressed) {
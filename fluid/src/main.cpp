@@ -20,7 +20,7 @@ struct Example : olc::PixelGameEngine {
 	bool show_grid=true;
 
 	bool OnUserCreate() override {
-		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 		
 		//detemine sizing
 		float cell_sz=30;
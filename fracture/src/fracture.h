@@ -4,6 +4,7 @@
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -11,13 +12,17 @@
 
 #include "sokol/sokol_engine.h"
 
-#include "mesh.h"
+#include "voronoi.h"
 
 #include "cmn/utils.h"
 
 //for time
 #include <ctime>
 
+#include <chrono>
+
+#include <iostream>
+
 using cmn::vf3d;
 using cmn::mat4;
 
@@ -46,6 +51,11 @@ class Fracture : public cmn::SokolEngine {
 	//scene
 	std::vector<Mesh> meshes;
 	int mesh_ix=0;
+
+	VoronoiFracture voronoi;
+	std::vector<Mesh> pieces;
+	//from mesh center, for exploding
+	std::vector<vf3d> piece_dirs;
 	
 	struct {
 		vf3d ctr, norm;
@@ -101,6 +111,7 @@ public:
 
 	void randomizeMesh() {
 		mesh_ix=std::rand()%meshes.size();
+		pieces.clear();
 	}
 
 	void setupSGL() {
@@ -122,6 +133,7 @@ public:
 		app_title="Fracture";
 		
 		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		if(!setupMeshes()) return false;
 
@@ -175,6 +187,64 @@ public:
 		cam.view_proj=mat4::mul(cam.proj, cam.view);
 	}
 
+	//random seeds in mesh bounds
+	std::vector<vf3d> makeSeeds(const Mesh& m, int num) {
+		const vf3d inf(1e30f, 1e30f, 1e30f);
+		cmn::AABBf3 box{inf, -inf};
+		for(const auto& v:m.verts) box.fitToEnclose(v);
+
+		std::vector<vf3d> seeds;
+		for(int i=0; i<num; i++) {
+			vf3d t(cmn::randFloat(), cmn::randFloat(), cmn::randFloat());
+			seeds.push_back(box.min+t*(box.max-box.min));
+		}
+		return seeds;
+	}
+
+	void shatterMesh(int num) {
+		const auto& m=meshes[mesh_ix];
+		voronoi.shatter(m, makeSeeds(m, num), pieces);
+
+		//drop seeds that missed
+		pieces.erase(std::remove_if(pieces.begin(), pieces.end(), [] (const Mesh& p) {
+			return p.tris.empty();
+		}), pieces.end());
+
+		vf3d ctr;
+		for(const auto& v:m.verts) ctr+=v;
+		ctr/=m.verts.size();
+		piece_dirs.clear();
+		for(const auto& p:pieces) {
+			vf3d p_ctr;
+			for(const auto& v:p.verts) p_ctr+=v;
+			p_ctr/=p.verts.size();
+			piece_dirs.push_back(p_ctr-ctr);
+		}
+	}
+
+	void benchmarkShatter() {
+		const auto& m=meshes[mesh_ix];
+		std::vector<Mesh> out;
+		for(const auto& num:{64, 500}) {
+			auto seeds=makeSeeds(m, num);
+			//first call sizes scratch
+			voronoi.shatter(m, seeds, out);
+
+			auto start=std::chrono::steady_clock::now();
+			voronoi.shatter(m, seeds, out);
+			auto end=std::chrono::steady_clock::now();
+			float ms=std::chrono::duration<float, std::milli>(end-start).count();
+
+			int num_pieces=0, num_tris=0;
+			for(const auto& p:out) {
+				if(p.tris.size()) num_pieces++;
+				num_tris+=p.tris.size();
+			}
+			std::cout<<"shatter "<<m.tris.size()<<" tris into "<<num<<" cells: "
+				<<ms<<" ms, "<<num_pieces<<" pieces, "<<num_tris<<" tris\n";
+		}
+	}
+
 	void handleUserInput(float dt) {
 		handleCameraLooking(dt);
 
@@ -190,6 +260,13 @@ public:
 		if(GetKey(SAPP_KEYCODE_B).pressed) show_bounds^=true;
 		if(GetKey(SAPP_KEYCODE_F).pressed) fill_triangles^=true;
 		if(GetKey(SAPP_KEYCODE_R).pressed) randomizeMesh();
+
+		//voronoi shatter
+		if(GetKey(SAPP_KEYCODE_V).pressed) {
+			if(pieces.empty()) shatterMesh(64);
+			else pieces.clear();
+		}
+		if(GetKey(SAPP_KEYCODE_T).pressed) benchmarkShatter();
 	}
 #pragma endregion
 
@@ -330,23 +407,35 @@ public:
 		sgl_matrix_mode_modelview();
 		sgl_load_matrix(cam.view.m);
 
-		//split meshes & offset by plane
-		Mesh ahead, behind;
-		if(meshes[mesh_ix].splitByPlane(plane.ctr, plane.norm, ahead, behind)) {
-			if(offset_meshes) {
-				vf3d offset=.075f*plane.norm;
-				for(auto& v:ahead.verts) v+=offset;
-				for(auto& v:behind.verts) v-=offset;
+		if(pieces.size()) {
+			//explode from center
+			for(int i=0; i<pieces.size(); i++) {
+				vf3d offset;
+				if(offset_meshes) offset=.5f*piece_dirs[i];
+				sgl_push_matrix();
+				sgl_translate(offset.x, offset.y, offset.z);
+				renderMesh(pieces[i]);
+				sgl_pop_matrix();
 			}
-
-			renderMesh(ahead);
-			renderMesh(behind);
-
-			if(show_bounds) {
-				//orange
-				renderBounds(ahead, 1, .5f, 0);
-				//purple
-				renderBounds(behind, .5f, 0, 1);
+		} else {
+			//split meshes & offset by plane
+			Mesh ahead, behind;
+			if(meshes[mesh_ix].splitByPlane(plane.ctr, plane.norm, ahead, behind)) {
+				if(offset_meshes) {
+					vf3d offset=.075f*plane.norm;
+					for(auto& v:ahead.verts) v+=offset;
+					for(auto& v:behind.verts) v-=offset;
+				}
+
+				renderMesh(ahead);
+				renderMesh(behind);
+
+				if(show_bounds) {
+					//orange
+					renderBounds(ahead, 1, .5f, 0);
+					//purple
+					renderBounds(behind, .5f, 0, 1);
+				}
 			}
 		}
 
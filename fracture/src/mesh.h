@@ -9,9 +9,9 @@
 #include <fstream>
 #include <sstream>
 
-#include <unordered_map>
-//for hash
-#include <functional>
+#include "cmn/obj_loader.h"
+
+#include "cmn/edge_cache.h"
 
 cmn::vf3d segIntersectPlane(
 	const cmn::vf3d& a, const cmn::vf3d& b,
@@ -27,27 +27,6 @@ struct IndexTriangle {
 	float r=1, g=1, b=1;
 };
 
-//sorted edges
-struct IndexEdge {
-	int a, b;
-
-	IndexEdge(int v0, int v1) {
-		a=v0, b=v1;
-		if(a>b) std::swap(a, b);
-	}
-
-	bool operator==(const IndexEdge& e) const {
-		return e.a==a&&e.b==b;
-	}
-};
-
-struct IndexEdgeHash {
-	std::uint64_t operator()(const IndexEdge& e) const {
-		std::uint64_t a=e.a, b=e.b;
-		return (a<<32)|b;
-	}
-};
-
 struct SplitIndex {
 	int pos_ix, neg_ix;
 };
@@ -80,23 +59,20 @@ struct Mesh {
 		if(ahead.verts.empty()||behind.verts.empty()) return false;
 
 		//store intersections for reuse
-		std::unordered_map<IndexEdge, SplitIndex, IndexEdgeHash> cache;
+		static thread_local cmn::EdgeCache<SplitIndex> cache;
+		cache.reset(3*tris.size());
 		auto getEdgeIndex=[&] (int i0, int i1) {
-			IndexEdge e(i0, i1);
-
-			auto it=cache.find(e);
-			if(it!=cache.end()) return it->second;
+			SplitIndex* is;
+			if(cache.findOrInsert(i0, i1, is)) return *is;
 
 			cmn::vf3d ix=segIntersectPlane(verts[i0], verts[i1], ctr, norm);
 
 			ahead.verts.push_back(ix);
 			behind.verts.push_back(ix);
 
-			SplitIndex is;
-			is.pos_ix=ahead.verts.size()-1;
-			is.neg_ix=behind.verts.size()-1;
-			cache[e]=is;
-			return is;
+			is->pos_ix=ahead.verts.size()-1;
+			is->neg_ix=behind.verts.size()-1;
+			return *is;
 		};
 
 		//add tri to corresponding mesh & ensure correct winding
@@ -164,44 +140,21 @@ struct Mesh {
 
 
 	static bool loadFromOBJ(Mesh& m, const std::string& filename) {
-		std::ifstream file(filename);
-		if(file.fail()) return false;
+		cmn::OBJMesh obj;
+		if(!cmn::loadOBJCached(obj, filename)) return false;
 
 		m={};
 
-		//parse file line by line
-		std::string line;
-		while(std::getline(file, line)) {
-			std::stringstream line_str(line);
-			std::string type; line_str>>type;
-			if(type=="v") {
-				cmn::vf3d v;
-				line_str>>v.x>>v.y>>v.z;
-				m.verts.push_back(v);
-			} else if(type=="f") {
-				std::vector<int> v_ixs;
-
-				//parse v/t/n until fail
-				int num=0;
-				for(std::string vtn; line_str>>vtn; num++) {
-					std::stringstream vtn_str(vtn);
-					int v_ix;
-					if(vtn_str>>v_ix) v_ixs.push_back(v_ix-1);
-				}
-
-				//triangulate
-				for(int i=2; i<num; i++) {
-					m.tris.push_back({
-						v_ixs[0],
-						v_ixs[i-1],
-						v_ixs[i]
-						});
-				}
-			}
+		m.verts=std::move(obj.positions);
+		m.tris.reserve(obj.getNumTris());
+		for(int i=0; i<obj.corners.size(); i+=3) {
+			m.tris.push_back({
+				obj.corners[i].v,
+				obj.corners[i+1].v,
+				obj.corners[i+2].v
+				});
 		}
 
-		file.close();
-
 		return true;
 	}
 };
@@ -0,0 +1,626 @@
+#pragma once
+#ifndef VORONOI_FRACTURE_CLASS_H
+#define VORONOI_FRACTURE_CLASS_H
+
+#include "mesh.h"
+
+#include <algorithm>
+
+#include <atomic>
+
+#ifndef __EMSCRIPTEN__
+#include <thread>
+#endif
+
+//cap faces stay as loose directed edges until a cell is done,
+//  so later cuts never have to walk through cap triangulations.
+struct CapSet {
+	std::vector<cmn::vf3d> norms;
+	//prefix sums into edges
+	std::vector<int> start{0};
+	//pairs
+	std::vector<int> edges;
+
+	int size() const {
+		return norms.size();
+	}
+
+	void clear() {
+		norms.clear();
+		start.assign(1, 0);
+		edges.clear();
+	}
+};
+
+struct CellMesh {
+	Mesh mesh;
+	CapSet caps;
+};
+
+//per worker buffers, reused for every clip & cell
+struct ClipScratch {
+	cmn::EdgeCache<SplitIndex> cache;
+	std::vector<float> dist;
+	std::vector<int> remap;
+	std::vector<std::pair<float, int>> crossings;
+	std::vector<int> open;
+
+	//cap segments & loops
+	std::vector<int> segs;
+	std::vector<int> next;
+	std::vector<bool> visited;
+	//loops past num_loops are spare buffers
+	std::vector<std::vector<int>> loops;
+	int num_loops=0;
+	std::vector<float> areas;
+	std::vector<int> owner;
+	std::vector<const std::vector<int>*> holes;
+
+	//hole bridging
+	std::vector<std::pair<float, int>> cands;
+	std::vector<int> merged;
+
+	//triangulation
+	std::vector<float> px, py;
+	std::vector<int> poly, prev_ix, next_ix;
+	std::vector<bool> reflex;
+	std::vector<int> reflex_list;
+	std::vector<int> grid_start, grid_fill, grid_items;
+	std::vector<int> tris;
+
+	//ping pong cells
+	CellMesh buf[2];
+	std::vector<std::pair<float, int>> order;
+};
+
+#pragma region CAP_TRIANGULATION
+namespace cap_detail {
+	inline float cross2(float ax, float ay, float bx, float by) {
+		return ax*by-ay*bx;
+	}
+
+	//shoelace
+	inline float loopArea(const std::vector<int>& loop, const ClipScratch& s) {
+		float sum=0;
+		for(int i=0; i<loop.size(); i++) {
+			int a=loop[i], b=loop[(i+1)%loop.size()];
+			sum+=cross2(s.px[a], s.py[a], s.px[b], s.py[b]);
+		}
+		return sum/2;
+	}
+
+	inline bool insideLoop(float x, float y, const std::vector<int>& loop, const ClipScratch& s) {
+		bool inside=false;
+		for(int i=0, j=loop.size()-1; i<loop.size(); j=i++) {
+			float xi=s.px[loop[i]], yi=s.py[loop[i]];
+			float xj=s.px[loop[j]], yj=s.py[loop[j]];
+			if((yi>y)!=(yj>y)&&x<xi+(y-yi)*(xj-xi)/(yj-yi)) inside^=true;
+		}
+		return inside;
+	}
+
+	//proper crossing only, shared endpoints dont count
+	inline bool segsCross(int a, int b, int c, int d, const ClipScratch& s) {
+		if(a==c||a==d||b==c||b==d) return false;
+		float abx=s.px[b]-s.px[a], aby=s.py[b]-s.py[a];
+		float cdx=s.px[d]-s.px[c], cdy=s.py[d]-s.py[c];
+		float d1=cross2(abx, aby, s.px[c]-s.px[a], s.py[c]-s.py[a]);
+		float d2=cross2(abx, aby, s.px[d]-s.px[a], s.py[d]-s.py[a]);
+		float d3=cross2(cdx, cdy, s.px[a]-s.px[c], s.py[a]-s.py[c]);
+		float d4=cross2(cdx, cdy, s.px[b]-s.px[c], s.py[b]-s.py[c]);
+		return ((d1>0)!=(d2>0))&&((d3>0)!=(d4>0))&&d1!=0&&d2!=0&&d3!=0&&d4!=0;
+	}
+
+	inline bool crossesAny(int a, int b, const std::vector<int>& loop, const ClipScratch& s) {
+		for(int i=0; i<loop.size(); i++) {
+			if(segsCross(a, b, loop[i], loop[(i+1)%loop.size()], s)) return true;
+		}
+		return false;
+	}
+
+	//splice hole into outer w/ a two way bridge
+	//  from its rightmost vertex to the closest visible outer vertex.
+	//  holes after first in s.holes can still block it.
+	inline void bridgeHole(std::vector<int>& outer, const std::vector<int>& hole, int first, ClipScratch& s) {
+		int m=0;
+		for(int i=1; i<hole.size(); i++) {
+			if(s.px[hole[i]]>s.px[hole[m]]) m=i;
+		}
+		int hm=hole[m];
+
+		//closest first
+		s.cands.clear();
+		for(int i=0; i<outer.size(); i++) {
+			float dx=s.px[outer[i]]-s.px[hm], dy=s.py[outer[i]]-s.py[hm];
+			s.cands.push_back({dx*dx+dy*dy, i});
+		}
+		std::sort(s.cands.begin(), s.cands.end());
+		int best=s.cands.front().second;
+		for(const auto& c:s.cands) {
+			int ov=outer[c.second];
+			if(crossesAny(hm, ov, outer, s)) continue;
+			if(crossesAny(hm, ov, hole, s)) continue;
+			bool blocked=false;
+			for(int o=first; o<s.holes.size(); o++) {
+				if(crossesAny(hm, ov, *s.holes[o], s)) {
+					blocked=true;
+					break;
+				}
+			}
+			if(blocked) continue;
+
+			best=c.second;
+			break;
+		}
+
+		//outer[..best], hole from m around to m, outer[best..]
+		auto& merged=s.merged;
+		merged.clear();
+		merged.insert(merged.end(), outer.begin(), outer.begin()+best+1);
+		for(int i=0; i<=hole.size(); i++) merged.push_back(hole[(m+i)%hole.size()]);
+		merged.insert(merged.end(), outer.begin()+best, outer.end());
+		//swap keeps both buffers
+		std::swap(outer, merged);
+	}
+
+	inline bool inTri(int p, int a, int b, int c, const ClipScratch& s) {
+		float x=s.px[p], y=s.py[p];
+		float d0=cross2(s.px[b]-s.px[a], s.py[b]-s.py[a], x-s.px[a], y-s.py[a]);
+		float d1=cross2(s.px[c]-s.px[b], s.py[c]-s.py[b], x-s.px[b], y-s.py[b]);
+		float d2=cross2(s.px[a]-s.px[c], s.py[a]-s.py[c], x-s.px[c], y-s.py[c]);
+		return d0>0&&d1>0&&d2>0;
+	}
+
+	//ccw polygon to ccw triangles.
+	//  only reflex vertexes can sit inside an ear,
+	//  and cut planes leave mostly convex loops.
+	inline void earClip(const std::vector<int>& poly, ClipScratch& s) {
+		int n=poly.size();
+		if(n<3) return;
+
+		//earlier caps leave runs of nearly collinear vertexes,
+		//  count those as convex so they go as flat ears.
+		auto isReflex=[&] (int pi, int ci, int ni) {
+			int a=poly[pi], b=poly[ci], c=poly[ni];
+			float abx=s.px[b]-s.px[a], aby=s.py[b]-s.py[a];
+			float bcx=s.px[c]-s.px[b], bcy=s.py[c]-s.py[b];
+			float eps=1e-5f*(std::abs(abx)+std::abs(aby))*(std::abs(bcx)+std::abs(bcy));
+			return cross2(abx, aby, bcx, bcy)<-eps;
+		};
+
+		s.prev_ix.resize(n), s.next_ix.resize(n);
+		for(int i=0; i<n; i++) {
+			s.prev_ix[i]=(i+n-1)%n;
+			s.next_ix[i]=(i+1)%n;
+		}
+		s.reflex.assign(n, false);
+		s.reflex_list.clear();
+		for(int i=0; i<n; i++) {
+			if(isReflex(s.prev_ix[i], i, s.next_ix[i])) {
+				s.reflex[i]=true;
+				s.reflex_list.push_back(i);
+			}
+		}
+
+		//bucket reflex vertexes so ear tests only look nearby
+		float x_min=1e30f, y_min=1e30f, x_max=-1e30f, y_max=-1e30f;
+		for(const auto& v:poly) {
+			x_min=std::min(x_min, s.px[v]), x_max=std::max(x_max, s.px[v]);
+			y_min=std::min(y_min, s.py[v]), y_max=std::max(y_max, s.py[v]);
+		}
+		const int grid_sz=std::max(1, int(std::sqrt(s.reflex_list.size()/2.f)));
+		const float cell_w=std::max(1e-20f, (x_max-x_min)/grid_sz);
+		const float cell_h=std::max(1e-20f, (y_max-y_min)/grid_sz);
+		auto cellX=[&] (float x) { return std::min(grid_sz-1, std::max(0, int((x-x_min)/cell_w))); };
+		auto cellY=[&] (float y) { return std::min(grid_sz-1, std::max(0, int((y-y_min)/cell_h))); };
+		s.grid_start.assign(grid_sz*grid_sz+1, 0);
+		for(const auto& k:s.reflex_list) {
+			s.grid_start[1+cellX(s.px[poly[k]])+grid_sz*cellY(s.py[poly[k]])]++;
+		}
+		for(int c=0; c<grid_sz*grid_sz; c++) s.grid_start[c+1]+=s.grid_start[c];
+		s.grid_items.resize(s.reflex_list.size());
+		s.grid_fill.assign(s.grid_start.begin(), s.grid_start.end()-1);
+		for(const auto& k:s.reflex_list) {
+			s.grid_items[s.grid_fill[cellX(s.px[poly[k]])+grid_sz*cellY(s.py[poly[k]])]++]=k;
+		}
+
+		auto anyInside=[&] (int a, int b, int c) {
+			int i0=cellX(std::min({s.px[a], s.px[b], s.px[c]}));
+			int i1=cellX(std::max({s.px[a], s.px[b], s.px[c]}));
+			int j0=cellY(std::min({s.py[a], s.py[b], s.py[c]}));
+			int j1=cellY(std::max({s.py[a], s.py[b], s.py[c]}));
+			for(int j=j0; j<=j1; j++) {
+				for(int i=i0; i<=i1; i++) {
+					int cell=i+grid_sz*j;
+					for(int g=s.grid_start[cell]; g<s.grid_start[cell+1]; g++) {
+						int k=s.grid_items[g];
+						if(!s.reflex[k]) continue;
+
+						int v=poly[k];
+						//bridge duplicates
+						if(v==a||v==b||v==c) continue;
+						if(inTri(v, a, b, c, s)) return true;
+					}
+				}
+			}
+			return false;
+		};
+
+		int curr=0, left=n, since_ear=0;
+		while(left>3) {
+			int pi=s.prev_ix[curr], ni=s.next_ix[curr];
+			int a=poly[pi], b=poly[curr], c=poly[ni];
+
+			bool ear=!s.reflex[curr]&&!anyInside(a, b, c);
+
+			//stuck on degenerate input, cut anyway
+			if(ear||since_ear>left) {
+				s.tris.push_back(a);
+				s.tris.push_back(b);
+				s.tris.push_back(c);
+				s.reflex[curr]=false;
+				s.next_ix[pi]=ni;
+				s.prev_ix[ni]=pi;
+				left--;
+				since_ear=0;
+
+				//neighbors can only turn convex
+				if(s.reflex[pi]&&!isReflex(s.prev_ix[pi], pi, ni)) s.reflex[pi]=false;
+				if(s.reflex[ni]&&!isReflex(pi, ni, s.next_ix[ni])) s.reflex[ni]=false;
+				curr=pi;
+			} else {
+				curr=ni;
+				since_ear++;
+			}
+		}
+		s.tris.push_back(poly[s.prev_ix[curr]]);
+		s.tris.push_back(poly[curr]);
+		s.tris.push_back(poly[s.next_ix[curr]]);
+	}
+}
+
+//fill loops of segs lying on plane w/ triangles facing norm.
+//  segs index into verts, outer loops come ccw & holes cw.
+inline void triangulateCap(const std::vector<cmn::vf3d>& verts, const cmn::vf3d& norm, ClipScratch& s) {
+	using namespace cap_detail;
+
+	s.tris.clear();
+	s.num_loops=0;
+
+	//follow segments into loops
+	s.next.assign(verts.size(), -1);
+	s.visited.assign(verts.size(), false);
+	for(int i=0; i<s.segs.size(); i+=2) s.next[s.segs[i]]=s.segs[1+i];
+	for(int i=0; i<s.segs.size(); i+=2) {
+		int start=s.segs[i];
+		if(s.visited[start]) continue;
+
+		if(s.num_loops==s.loops.size()) s.loops.emplace_back();
+		auto& loop=s.loops[s.num_loops];
+		loop.clear();
+		int curr=start;
+		while(curr!=-1&&!s.visited[curr]) {
+			s.visited[curr]=true;
+			loop.push_back(curr);
+			curr=s.next[curr];
+		}
+		//open chains from non manifold input
+		if(curr==start&&loop.size()>=3) s.num_loops++;
+	}
+	const int num=s.num_loops;
+	if(num==0) return;
+
+	//project to plane basis w/ u x v=norm
+	cmn::vf3d u=std::abs(norm.x)<.9f?cross(norm, cmn::vf3d(1, 0, 0)):cross(norm, cmn::vf3d(0, 1, 0));
+	u=normalize(u);
+	cmn::vf3d v=cross(norm, u);
+	s.px.resize(verts.size());
+	s.py.resize(verts.size());
+	for(int l=0; l<num; l++) {
+		for(const auto& i:s.loops[l]) {
+			s.px[i]=dot(verts[i], u);
+			s.py[i]=dot(verts[i], v);
+		}
+	}
+
+	s.areas.resize(num);
+	for(int l=0; l<num; l++) s.areas[l]=loopArea(s.loops[l], s);
+
+	//holes go to smallest outer containing them
+	auto& owner=s.owner;
+	owner.assign(num, -1);
+	for(int h=0; h<num; h++) {
+		if(s.areas[h]>=0) continue;
+
+		int p=s.loops[h][0];
+		for(int o=0; o<num; o++) {
+			if(s.areas[o]<=0) continue;
+			if(!insideLoop(s.px[p], s.py[p], s.loops[o], s)) continue;
+			if(owner[h]==-1||s.areas[o]<s.areas[owner[h]]) owner[h]=o;
+		}
+	}
+
+	for(int o=0; o<num; o++) {
+		if(s.areas[o]<=0) continue;
+
+		auto& holes=s.holes;
+		holes.clear();
+		for(int h=0; h<num; h++) {
+			if(owner[h]==o) holes.push_back(&s.loops[h]);
+		}
+
+		//rightmost holes first so bridges dont cross
+		std::sort(holes.begin(), holes.end(), [&] (const std::vector<int>* a, const std::vector<int>* b) {
+			float ma=-1e30f, mb=-1e30f;
+			for(const auto& i:*a) ma=std::max(ma, s.px[i]);
+			for(const auto& i:*b) mb=std::max(mb, s.px[i]);
+			return ma>mb;
+		});
+
+		s.poly=s.loops[o];
+		for(int h=0; h<holes.size(); h++) {
+			bridgeHole(s.poly, *holes[h], h+1, s);
+		}
+		earClip(s.poly, s);
+	}
+}
+#pragma endregion
+
+//keep whats behind plane & add the cut as a cap.
+enum ClipResult {
+	CLIP_KEPT,
+	CLIP_CUT,
+	CLIP_REMOVED
+};
+
+inline ClipResult clipKeepBehind(
+	const Mesh& in, const CapSet& in_caps,
+	const cmn::vf3d& ctr, const cmn::vf3d& norm,
+	CellMesh& out, ClipScratch& s
+) {
+	//classify pts
+	s.dist.resize(in.verts.size());
+	int num_ahead=0;
+	for(int i=0; i<in.verts.size(); i++) {
+		s.dist[i]=dot(norm, in.verts[i]-ctr);
+		if(s.dist[i]>0) num_ahead++;
+	}
+	if(num_ahead==0) return CLIP_KEPT;
+	if(num_ahead==in.verts.size()) return CLIP_REMOVED;
+
+	out.mesh.verts.clear();
+	out.mesh.tris.clear();
+	out.caps.clear();
+	s.remap.assign(in.verts.size(), -1);
+	s.cache.reset(3*in.tris.size()+in_caps.edges.size()/2);
+	s.segs.clear();
+
+	//only copy used verts
+	auto keep=[&] (int i) {
+		if(s.remap[i]==-1) {
+			s.remap[i]=out.mesh.verts.size();
+			out.mesh.verts.push_back(in.verts[i]);
+		}
+		return s.remap[i];
+	};
+
+	//store intersections for reuse
+	auto cut=[&] (int i0, int i1) {
+		SplitIndex* is;
+		if(s.cache.findOrInsert(i0, i1, is)) return is->neg_ix;
+
+		//lerp from sorted end so every face agrees
+		int a=std::min(i0, i1), b=std::max(i0, i1);
+		float t=s.dist[a]/(s.dist[a]-s.dist[b]);
+		out.mesh.verts.push_back(in.verts[a]+t*(in.verts[b]-in.verts[a]));
+		is->pos_ix=-1;
+		is->neg_ix=out.mesh.verts.size()-1;
+		return is->neg_ix;
+	};
+
+	for(const auto& t:in.tris) {
+		bool in0=s.dist[t.ix[0]]<=0;
+		bool in1=s.dist[t.ix[1]]<=0;
+		bool in2=s.dist[t.ix[2]]<=0;
+		if(in0&&in1&&in2) {
+			out.mesh.tris.push_back({{keep(t.ix[0]), keep(t.ix[1]), keep(t.ix[2])}, t.r, t.g, t.b});
+			continue;
+		}
+		if(!in0&&!in1&&!in2) continue;
+
+		//sutherland hodgman keeps winding
+		int poly[4], num=0;
+		int x_in=-1, x_out=-1;
+		for(int e=0; e<3; e++) {
+			int a=t.ix[e], b=t.ix[(e+1)%3];
+			bool a_in=s.dist[a]<=0, b_in=s.dist[b]<=0;
+			if(a_in) poly[num++]=keep(a);
+			if(a_in!=b_in) {
+				int x=cut(a, b);
+				poly[num++]=x;
+				if(a_in) x_out=x;
+				else x_in=x;
+			}
+		}
+		out.mesh.tris.push_back({{poly[0], poly[1], poly[2]}, t.r, t.g, t.b});
+		if(num==4) out.mesh.tris.push_back({{poly[0], poly[2], poly[3]}, t.r, t.g, t.b});
+
+		//tri closes x_out->x_in, cap runs opposite
+		s.segs.push_back(x_in);
+		s.segs.push_back(x_out);
+	}
+
+	//clip older caps edge by edge
+	auto& oc=out.caps;
+	for(int f=0; f<in_caps.size(); f++) {
+		const auto& f_norm=in_caps.norms[f];
+		s.crossings.clear();
+		for(int e=in_caps.start[f]; e<in_caps.start[f+1]; e+=2) {
+			int a=in_caps.edges[e], b=in_caps.edges[1+e];
+			bool a_in=s.dist[a]<=0, b_in=s.dist[b]<=0;
+			if(!a_in&&!b_in) continue;
+
+			int u=a_in?keep(a):cut(a, b);
+			int v=b_in?keep(b):cut(a, b);
+			oc.edges.push_back(u);
+			oc.edges.push_back(v);
+
+			//odd indexes leave
+			if(a_in!=b_in) s.crossings.push_back({0.f, a_in?2*v+1:2*u});
+		}
+
+		//crossings pair up along the line where the planes meet.
+		//  overlapping shells nest, so match them like brackets.
+		if(s.crossings.size()) {
+			cmn::vf3d dir=cross(f_norm, norm);
+			for(auto& c:s.crossings) c.first=dot(dir, out.mesh.verts[c.second/2]);
+			std::sort(s.crossings.begin(), s.crossings.end());
+			const int opener=s.crossings[0].second%2;
+			s.open.clear();
+			for(const auto& c:s.crossings) {
+				if(c.second%2==opener) {
+					s.open.push_back(c.second);
+					continue;
+				}
+				if(s.open.empty()) continue;
+
+				int p=s.open.back(), q=c.second;
+				s.open.pop_back();
+				int x_out=p%2?p/2:q/2, x_in=p%2?q/2:p/2;
+				oc.edges.push_back(x_out);
+				oc.edges.push_back(x_in);
+				s.segs.push_back(x_in);
+				s.segs.push_back(x_out);
+			}
+		}
+
+		//fully clipped
+		if(oc.edges.size()==oc.start.back()) continue;
+
+		oc.norms.push_back(f_norm);
+		oc.start.push_back(oc.edges.size());
+	}
+
+	if(s.segs.size()) {
+		oc.norms.push_back(norm);
+		oc.edges.insert(oc.edges.end(), s.segs.begin(), s.segs.end());
+		oc.start.push_back(oc.edges.size());
+	}
+
+	return CLIP_CUT;
+}
+
+//split a closed mesh into the voronoi cells of some seeds.
+//  cells are independent, so each worker clips its own
+//  against bisector planes, nearest neighbors first.
+class VoronoiFracture {
+	std::vector<ClipScratch> scratches;
+
+	void computeCell(
+		const Mesh& src, const std::vector<cmn::vf3d>& seeds,
+		int i, ClipScratch& s, Mesh& piece
+	) {
+		const auto& seed=seeds[i];
+
+		//nearest bisectors cut the most
+		s.order.clear();
+		for(int j=0; j<seeds.size(); j++) {
+			if(j==i) continue;
+
+			float d=length(seeds[j]-seed);
+			if(d>1e-6f) s.order.push_back({d, j});
+		}
+		std::sort(s.order.begin(), s.order.end());
+
+		auto getReach=[&] (const Mesh& m) {
+			float r=0;
+			for(const auto& v:m.verts) {
+				cmn::vf3d sub=v-seed;
+				r=std::max(r, dot(sub, sub));
+			}
+			return std::sqrt(r);
+		};
+
+		static const CapSet no_caps;
+		const Mesh* curr=&src;
+		const CapSet* curr_caps=&no_caps;
+		int buf_ix=0;
+		float reach=getReach(src);
+		for(const auto& o:s.order) {
+			//piece fits in ball, farther planes cant reach
+			if(reach<=o.first/2) break;
+
+			cmn::vf3d norm=(seeds[o.second]-seed)/o.first;
+			cmn::vf3d ctr=(seed+seeds[o.second])/2;
+			CellMesh& next=s.buf[buf_ix];
+			auto res=clipKeepBehind(*curr, *curr_caps, ctr, norm, next, s);
+			if(res==CLIP_REMOVED) {
+				piece.verts.clear();
+				piece.tris.clear();
+				return;
+			}
+			if(res==CLIP_KEPT) continue;
+
+			curr=&next.mesh;
+			curr_caps=&next.caps;
+			buf_ix^=1;
+			reach=getReach(*curr);
+		}
+
+		piece=*curr;
+
+		//now triangulate whats left of each cap
+		for(int f=0; f<curr_caps->size(); f++) {
+			const auto& es=curr_caps->edges;
+			s.segs.assign(es.begin()+curr_caps->start[f], es.begin()+curr_caps->start[f+1]);
+			triangulateCap(piece.verts, curr_caps->norms[f], s);
+			for(int t=0; t<s.tris.size(); t+=3) {
+				piece.tris.push_back({{s.tris[t], s.tris[1+t], s.tris[2+t]}, cap_r, cap_g, cap_b});
+			}
+		}
+	}
+
+public:
+	//0 picks hardware concurrency
+	int num_threads=0;
+
+	float cap_r=.9f, cap_g=.35f, cap_b=.2f;
+
+	//one piece per seed, empty if it missed the mesh
+	void shatter(const Mesh& src, const std::vector<cmn::vf3d>& seeds, std::vector<Mesh>& pieces) {
+		pieces.resize(seeds.size());
+		if(seeds.empty()) return;
+
+		int num=num_threads;
+#ifdef __EMSCRIPTEN__
+		num=1;
+#else
+		if(num<=0) {
+			num=std::thread::hardware_concurrency();
+			if(num<=0) num=1;
+		}
+#endif
+		num=std::max(1, std::min(num, int(seeds.size())));
+		if(scratches.size()<num) scratches.resize(num);
+
+		//cells vary a lot, so hand them out one at a time
+		std::atomic<int> next_cell{0};
+		auto work=[&] (ClipScratch& s) {
+			for(int i; (i=next_cell++)<seeds.size(); ) {
+				computeCell(src, seeds, i, s, pieces[i]);
+			}
+		};
+
+#ifdef __EMSCRIPTEN__
+		work(scratches[0]);
+#else
+		if(num==1) work(scratches[0]);
+		else {
+			std::vector<std::thread> workers;
+			for(int i=0; i<num; i++) workers.emplace_back(work, std::ref(scratches[i]));
+			for(auto& w:workers) w.join();
+		}
+#endif
+	}
+};
+#endif
\ No newline at end of file
@@ -64,7 +64,8 @@ struct FruitNinja : olc::PixelGameEngine {
 
 	bool show_bounds=false;
 
-	std::list<Particle*> particles;
+	//splatters & messages
+	cmn::ParticlePool particles{2048};
 
 	//sound stuff
 	olc::sound::WaveEngine sound_engine;
@@ -72,6 +73,7 @@ struct FruitNinja : olc::PixelGameEngine {
 
 	bool OnUserCreate() override {
 		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		{//"primitive" to draw with
 			int sz=1024;
@@ -85,6 +87,10 @@ struct FruitNinja : olc::PixelGameEngine {
 
 		screen_bounds={{0, 0}, cmn::vf2d(ScreenWidth(), ScreenHeight())};
 
+		//~99% compounding
+		particles.drag=.6f;
+		particles.rot_drag=.6f;
+
 		//sounds
 		sound_engine.InitialiseAudio();
 		sound_engine.SetOutputVolume(.8f);
@@ -207,8 +213,8 @@ struct FruitNinja : olc::PixelGameEngine {
 							float speed=cmn::randFloat(5, 15);
 							vf2d vel=cmn::polar<vf2d>(speed, cmn::randFloat(2*cmn::Pi));
 							float lifespan=cmn::randFloat(2, 3);
-							float rad=cmn::randFloat(3, 4);
-							particles.emplace_back(new Splatter(pos, vel, f->col, lifespan, rad));
+							int j=spawnParticle(particles, pos, vel, f->col, lifespan, SPLATTER_TAG);
+							if(j!=-1) particles.size[j]=cmn::randFloat(3, 4);
 						}
 					}
 
@@ -220,19 +226,20 @@ struct FruitNinja : olc::PixelGameEngine {
 						int diff=abs(50-pct);
 
 						//string feedback
-						std::string msg; olc::Pixel col;
-						if(diff<5) msg="awesome!!", col=olc::BLUE;
-						else if(diff<10) msg="nice!", col=olc::CYAN;
-						else if(diff<20) msg="decent", col=olc::GREEN;
-						else if(diff<30) msg="meh.", col=olc::YELLOW;
-						else msg="bad!", col=olc::RED;
+						int rating;
+						if(diff<5) rating=0;
+						else if(diff<10) rating=1;
+						else if(diff<20) rating=2;
+						else if(diff<30) rating=3;
+						else rating=4;
 
 						//random movement
 						float speed=cmn::randFloat(50, 75);
 						vf2d vel=cmn::polar<vf2d>(speed, cmn::randFloat(2*cmn::Pi));
 						float rot_vel=cmn::randFloat(-.5f*cmn::Pi, .5f*cmn::Pi);
 						float lifespan=cmn::randFloat(2, 4);
-						particles.push_back(new Message(f->pos, vel, col, lifespan, msg, rot_vel));
+						int j=spawnParticle(particles, f->pos, vel, ratings[rating].col, lifespan, rating);
+						if(j!=-1) particles.rot_vel[j]=rot_vel;
 					}
 
 					//update new fruit velocities
@@ -341,15 +348,6 @@ struct FruitNinja : olc::PixelGameEngine {
 				it=fruits.erase(it);
 			} else it++;
 		}
-
-		//"sanitize" messages
-		for(auto it=particles.begin(); it!=particles.end();) {
-			const auto& p=*it;
-			if(p->isDead()) {
-				delete p;
-				it=particles.erase(it);
-			} else it++;
-		}
 	}
 
 	void handlePhysics(float dt) {
@@ -359,10 +357,9 @@ struct FruitNinja : olc::PixelGameEngine {
 			f->update(dt);
 		}
 
-		//particle kinematics
-		for(const auto& p:particles) {
-			p->update(dt);
-		}
+		//particle kinematics, & remove the old ones
+		particles.integrate(dt);
+		particles.updateAges(dt);
 	}
 
 	void update(float dt) {
@@ -540,27 +537,15 @@ struct FruitNinja : olc::PixelGameEngine {
 		}
 
 		//show particles
-		for(const auto& p:particles) {
-			switch(p->getID()) {
-				case Particle::MESSAGE:
-				{
-					const auto& m=dynamic_cast<Message*>(p);
-					vf2d offset(4*m->msg.length(), 4);
-					float t=1-m->age/m->lifespan;
-					olc::Pixel fill=m->col;
-					fill.a=255*clamp(t, 0, 1);
-					DrawRotatedStringDecal(m->pos, m->msg, m->rot, offset, fill, {2, 2});
-					break;
-				}
-				case Particle::SPLATTER:
-				{
-					const auto& s=dynamic_cast<Splatter*>(p);
-					float t=1-s->age/s->lifespan;
-					olc::Pixel fill=s->col;
-					fill.a=255*clamp(t, 0, 1);
-					FillCircleDecal(s->pos, s->rad, fill);
-					break;
-				}
+		for(int i=0; i<particles.getNum(); i++) {
+			vf2d pos(particles.pos_x[i], particles.pos_y[i]);
+			olc::Pixel fill=olc::PixelF(particles.r[i], particles.g[i], particles.b[i], particles.getFade(i));
+			if(particles.tag[i]==SPLATTER_TAG) {
+				FillCircleDecal(pos, particles.size[i], fill);
+			} else {
+				std::string msg=ratings[particles.tag[i]].msg;
+				vf2d offset(4*msg.length(), 4);
+				DrawRotatedStringDecal(pos, msg, particles.rot[i], offset, fill, {2, 2});
 			}
 		}
 	}
@@ -2,93 +2,37 @@
 #ifndef PARTICLE_STRUCTS_H
 #define PARTICLE_STRUCTS_H
 
-#include <string>
+#include "cmn/particle_pool.h"
 
-//basic particle functionality
-struct Particle {
-protected:
-	int id=0;
-
-public:
-	vf2d pos, vel, acc;
-	float lifespan=0, age=0;
+//effects live in a cmn::ParticlePool, & tag says what each one is.
+//  messages use their rating index, splatters use this.
+const int SPLATTER_TAG=-1;
 
+//slice feedback, best to worst
+struct Rating {
+	const char* msg;
 	olc::Pixel col;
-
-	enum {
-		BASE,
-		MESSAGE,
-		SPLATTER
-	};
-
-	Particle()=default;
-
-	Particle(vf2d p, vf2d v, olc::Pixel c, float l) {
-		pos=p;
-		vel=v;
-		col=c;
-		lifespan=l;
-	}
-
-	int getID() const {
-		return id;
-	}
-
-	void applyForce(const vf2d& f) {
-		acc+=f;
-	}
-
-	virtual void update(float dt) {
-		vel+=acc*dt;
-		pos+=vel*dt;
-		acc={0, 0};
-
-		//~99% compounding
-		float drag=1-.6f*dt;
-		vel*=drag;
-
-		age+=dt;
-	}
-
-	bool isDead() const {
-		return age>lifespan;
-	}
 };
 
-//string and rotation
-struct Message : Particle {
-	std::string msg;
-	float rot=0, rot_vel=0;
-
-	Message()=default;
-
-	Message(vf2d p, vf2d v, olc::Pixel c, float l, const std::string& m, float r) : Particle(p, v, c, l) {
-		msg=m;
-		rot_vel=r;
-		id=MESSAGE;
-	}
-
-	void update(float dt) override {
-		Particle::update(dt);
-
-		rot+=rot_vel*dt;
-
-		float drag=1-.6f*dt;
-		rot_vel*=drag;
-	}
+static const Rating ratings[]{
+	{"awesome!!", olc::BLUE},
+	{"nice!", olc::CYAN},
+	{"decent", olc::GREEN},
+	{"meh.", olc::YELLOW},
+	{"bad!", olc::RED}
 };
 
-//this just has a radius
-struct Splatter : Particle {
-	float rad=0;
-
-	Splatter()=default;
-
-	Splatter(vf2d p, vf2d v, olc::Pixel c, float l, float r) : Particle(p, v, c, l) {
-		rad=r;
-		id=SPLATTER;
-	}
-};
+//-1 when the pool is full
+inline int spawnParticle(cmn::ParticlePool& pool, vf2d p, vf2d v, olc::Pixel c, float l, int tag) {
+	int i=pool.spawn(p.x, p.y, v.x, v.y, l);
+	if(i==-1) return -1;
+
+	pool.r[i]=c.r/255.f;
+	pool.g[i]=c.g/255.f;
+	pool.b[i]=c.b/255.f;
+	pool.tag[i]=tag;
+	return i;
+}
 
 //add explosion emitter
 #endif
\ No newline at end of file
@@ -29,6 +29,7 @@ public:
 
 	bool OnUserCreate() override {
 		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		//initialize images
 		image_width=ScreenWidth();
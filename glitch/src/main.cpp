@@ -105,7 +105,7 @@ public:
 
 public:
 	bool OnUserCreate() override {
-		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		//make some "primitives" to draw with
 		prim_rect.Create(1, 1);
@@ -85,6 +85,7 @@ class JellyCarGame : public olc::PixelGameEngine {
 
 	bool OnUserCreate() override {
 		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		//init render "primitives"
 		prim_rect.Create(1, 1);
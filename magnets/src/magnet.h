@@ -130,6 +130,19 @@ public:
 #pragma endregion
 
 #pragma region BEHAVIORS
+	//u*q1*q2/4/Pi, unit pole strength
+	static const double pole_coeff;
+	//softening so poles dont explode up close
+	static const double pole_soft;
+
+	//force on a pole from a like pole at offset d=self-other.
+	//  scale by charges(N=+1, S=-1) for anything else.
+	static cmn::vd2d poleKernel(const cmn::vd2d& d) {
+		double l=length(d);
+		if(l<1e-6) return {0, 0};
+		return pole_coeff/l/(pole_soft+l*l)*d;
+	}
+
 	static void applyMonopoleForces(Magnet& a, Magnet& b) {
 		//get pole locations
 		cmn::vd2d a_n=a.getNorth();
@@ -143,20 +156,11 @@ public:
 		cmn::vd2d asbn=b_n-a_s;
 		cmn::vd2d asbs=b_s-a_s;
 
-		//separation distances
-		double anbn_l=length(anbn);
-		double anbs_l=length(anbs);
-		double asbn_l=length(asbn);
-		double asbs_l=length(asbs);
-
 		//safe norm(ignore) + inverse square law
-		const double u=4*Pi*1e-7;//permeability
-		const double q1=1, q2=1;
-		const double coeff=u*q1*q2/4/Pi;
-		cmn::vd2d f_anbn=(anbn_l<1e-6?0:coeff/anbn_l/(1e-4+anbn_l*anbn_l))*anbn;
-		cmn::vd2d f_anbs=(anbs_l<1e-6?0:coeff/anbs_l/(1e-4+anbs_l*anbs_l))*anbs;
-		cmn::vd2d f_asbn=(asbn_l<1e-6?0:coeff/asbn_l/(1e-4+asbn_l*asbn_l))*asbn;
-		cmn::vd2d f_asbs=(asbs_l<1e-6?0:coeff/asbs_l/(1e-4+asbs_l*asbs_l))*asbs;
+		cmn::vd2d f_anbn=poleKernel(anbn);
+		cmn::vd2d f_anbs=poleKernel(anbs);
+		cmn::vd2d f_asbn=poleKernel(asbn);
+		cmn::vd2d f_asbs=poleKernel(asbs);
 
 		//final force applications
 		a.applyForce(f_anbs-f_anbn, a_n);
@@ -214,6 +218,10 @@ public:
 //pole inside magnet
 const double Magnet::rel_pole_rad=.75;
 
+//permeability cancels out
+const double Magnet::pole_coeff=4*Pi*1e-7/4/Pi;
+const double Magnet::pole_soft=1e-4;
+
 //precompute rotation matrix
 void Magnet::updateRot() {
 	sincos.x=std::sin(rot);
@@ -0,0 +1,99 @@
+#pragma once
+#ifndef MAGNET_GRID_CLASS_H
+#define MAGNET_GRID_CLASS_H
+
+#include "magnet.h"
+
+#include <vector>
+
+//uniform grid broadphase w/ cell size=biggest diameter
+//  so colliding magnets are always in neighboring cells.
+//  cells are packed by counting sort, so no per cell allocations.
+class MagnetGrid {
+	cmn::vd2d origin;
+	double cell_sz=1;
+	int width=0, height=0;
+
+	std::vector<int> cell_ix;
+	//prefix sums into sorted
+	std::vector<int> cell_start;
+	std::vector<int> sorted;
+
+	int getCellIX(int i, int j) const {
+		return i+width*j;
+	}
+
+public:
+	int getNumCells() const {
+		return width*height;
+	}
+
+	void build(const std::vector<Magnet*>& ms) {
+		width=0, height=0;
+		if(ms.empty()) return;
+
+		const cmn::vd2d inf(1e300, 1e300);
+		cmn::AABBd2 box{inf, -inf};
+		double max_rad=0;
+		for(const auto& m:ms) {
+			box.fitToEnclose(m->pos);
+			max_rad=std::max(max_rad, m->getRad());
+		}
+		cell_sz=std::max(2*max_rad, 1e-9);
+		origin=box.min;
+
+		//cap so one stray magnet cant blow up the grid
+		const int max_dim=2048;
+		width=std::min(max_dim, 1+int((box.max.x-box.min.x)/cell_sz));
+		height=std::min(max_dim, 1+int((box.max.y-box.min.y)/cell_sz));
+
+		//count
+		cell_start.assign(width*height+1, 0);
+		cell_ix.resize(ms.size());
+		for(int k=0; k<ms.size(); k++) {
+			int i=std::min(width-1, int((ms[k]->pos.x-origin.x)/cell_sz));
+			int j=std::min(height-1, int((ms[k]->pos.y-origin.y)/cell_sz));
+			cell_ix[k]=getCellIX(i, j);
+			cell_start[cell_ix[k]+1]++;
+		}
+
+		//prefix sum
+		for(int c=0; c<width*height; c++) cell_start[c+1]+=cell_start[c];
+
+		//scatter
+		sorted.resize(ms.size());
+		std::vector<int> fill(cell_start.begin(), cell_start.end()-1);
+		for(int k=0; k<ms.size(); k++) {
+			sorted[fill[cell_ix[k]]++]=k;
+		}
+	}
+
+	//calls fn(a, b) once for every nearby pair
+	template<typename Fn>
+	void forEachPair(Fn fn) const {
+		for(int j=0; j<height; j++) {
+			for(int i=0; i<width; i++) {
+				int c=getCellIX(i, j);
+				for(int s=cell_start[c]; s<cell_start[c+1]; s++) {
+					int a=sorted[s];
+
+					//3x3 neighborhood, higher index wins
+					for(int dj=-1; dj<=1; dj++) {
+						int nj=j+dj;
+						if(nj<0||nj>=height) continue;
+						for(int di=-1; di<=1; di++) {
+							int ni=i+di;
+							if(ni<0||ni>=width) continue;
+							int nc=getCellIX(ni, nj);
+							for(int t=cell_start[nc]; t<cell_start[nc+1]; t++) {
+								int b=sorted[t];
+								if(b>a) fn(a, b);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+};
+#endif
\ No newline at end of file
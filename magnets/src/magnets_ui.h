@@ -4,6 +4,7 @@
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -19,6 +20,15 @@
 
 #include <list>
 
+#include "pole_tree.h"
+
+#include "magnet_grid.h"
+
+//for report
+#include <iostream>
+
+#include "cmn/stopwatch.h"
+
 #include "camera.h"
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -39,6 +49,15 @@ class MagnetsUI : public cmn::SokolEngine {
 	const double time_step=1/360.;
 	double update_timer=0;
 
+	//barnes hut
+	bool use_tree=true;
+	PoleTree pole_tree;
+	std::vector<PoleTree::Pole> poles;
+
+	//broadphase
+	std::vector<Magnet*> magnet_ptrs;
+	MagnetGrid grid;
+
 	cmn::AABBd2 bounds{
 		{-.5, -.5},
 		{.5, .5}
@@ -117,7 +136,7 @@ public:
 	bool user_create() override {
 		app_title="Magnets";
 
-		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		setupMagnets();
 
@@ -186,6 +205,28 @@ public:
 		magnets.push_back(cand);
 	}
 
+	//fill bounds w/ a bunch of magnets
+	void handleSpawnAction() {
+		if(!GetKey(SAPP_KEYCODE_T).pressed) return;
+
+		const int num=2000;
+		int added=0;
+		for(int tries=0; tries<20*num&&added<num; tries++) {
+			vd2d pos(
+				cmn::randDouble(bounds.min.x, bounds.max.x),
+				cmn::randDouble(bounds.min.y, bounds.max.y)
+			);
+			double rot=cmn::randDouble(2*Pi);
+			double rad=centimeter*cmn::randDouble(.25, .35);
+			Magnet cand(pos, rad, rot);
+			if(isOverlapping(cand)) continue;
+
+			magnets.push_back(cand);
+			added++;
+		}
+		std::cout<<"spawned "<<added<<" magnets("<<magnets.size()<<" total)\n";
+	}
+
 	void handleRemovalAction() {
 		if(!GetKey(SAPP_KEYCODE_X).held) return;
 
@@ -224,6 +265,8 @@ public:
 	void handleUserInput(double dt) {
 		handleAdditionAction();
 
+		handleSpawnAction();
+
 		handleRemovalAction();
 
 		handleGrabbingAction();
@@ -239,21 +282,127 @@ public:
 		//toggles
 		if(GetKey(SAPP_KEYCODE_SPACE).pressed) update_phys^=true;
 		if(GetKey(SAPP_KEYCODE_P).pressed) render_poles^=true;
+		if(GetKey(SAPP_KEYCODE_B).pressed) {
+			use_tree^=true;
+			std::cout<<"barnes hut: "<<(use_tree?"on":"off")<<'\n';
+		}
+
+		//opening angle
+		if(GetKey(SAPP_KEYCODE_LEFT_BRACKET).pressed) {
+			pole_tree.theta=std::max(0., pole_tree.theta-.1);
+			std::cout<<"theta: "<<pole_tree.theta<<'\n';
+		}
+		if(GetKey(SAPP_KEYCODE_RIGHT_BRACKET).pressed) {
+			pole_tree.theta=std::min(2., pole_tree.theta+.1);
+			std::cout<<"theta: "<<pole_tree.theta<<'\n';
+		}
+
+		if(GetKey(SAPP_KEYCODE_R).pressed) reportAccuracy();
+	}
+
+	void refreshMagnetPtrs() {
+		magnet_ptrs.clear();
+		for(auto& m:magnets) magnet_ptrs.push_back(&m);
+	}
+
+	//for each unique pair of magnets
+	void applyExactForces() {
+		for(auto ait=magnets.begin(); ait!=magnets.end(); ait++) {
+			for(auto bit=std::next(ait); bit!=magnets.end(); bit++) {
+				Magnet::applyMonopoleForces(*ait, *bit);
+			}
+		}
+	}
+
+	void buildPoleTree() {
+		poles.clear();
+		for(int i=0; i<magnet_ptrs.size(); i++) {
+			const auto& m=*magnet_ptrs[i];
+			poles.push_back({m.getNorth(), 1, i});
+			poles.push_back({m.getSouth(), -1, i});
+		}
+		pole_tree.build(poles);
+	}
+
+	//net force on each pole of magnet i
+	void getTreeForces(int i, vd2d& f_n, vd2d& f_s) const {
+		const auto& m=*magnet_ptrs[i];
+		vd2d n=m.getNorth(), s=m.getSouth();
+		f_n=pole_tree.getField(n, i, s);
+		f_s=-pole_tree.getField(s, i, n);
+	}
+
+	void applyTreeForces() {
+		buildPoleTree();
+		for(int i=0; i<magnet_ptrs.size(); i++) {
+			auto& m=*magnet_ptrs[i];
+			vd2d f_n, f_s;
+			getTreeForces(i, f_n, f_s);
+			m.applyForce(f_n, m.getNorth());
+			m.applyForce(f_s, m.getSouth());
+		}
+	}
+
+	//compare tree against brute force on current state
+	void reportAccuracy() {
+		if(magnets.empty()) return;
+
+		refreshMagnetPtrs();
+		const int num=magnet_ptrs.size();
+
+		//exact pairwise per pole forces
+		cmn::Stopwatch watch;
+		watch.start();
+		std::vector<vd2d> exact(2*num);
+		for(int i=0; i<num; i++) {
+			vd2d n=magnet_ptrs[i]->getNorth();
+			vd2d s=magnet_ptrs[i]->getSouth();
+			for(int j=0; j<num; j++) {
+				if(j==i) continue;
+				vd2d on=magnet_ptrs[j]->getNorth();
+				vd2d os=magnet_ptrs[j]->getSouth();
+				exact[2*i]+=Magnet::poleKernel(n-on)-Magnet::poleKernel(n-os);
+				exact[2*i+1]+=Magnet::poleKernel(s-os)-Magnet::poleKernel(s-on);
+			}
+		}
+		watch.stop();
+		auto exact_us=watch.getMicros();
+
+		watch.start();
+		buildPoleTree();
+		std::vector<vd2d> approx(2*num);
+		for(int i=0; i<num; i++) {
+			getTreeForces(i, approx[2*i], approx[2*i+1]);
+		}
+		watch.stop();
+		auto tree_us=watch.getMicros();
+
+		//relative to rms force so tiny forces dont dominate
+		double sum_err=0, sum_ref=0, max_err=0;
+		for(int k=0; k<2*num; k++) {
+			vd2d e=approx[k]-exact[k];
+			double e_sq=dot(e, e);
+			sum_err+=e_sq;
+			sum_ref+=dot(exact[k], exact[k]);
+			max_err=std::max(max_err, std::sqrt(e_sq));
+		}
+		double rms_ref=std::sqrt(sum_ref/(2*num));
+		double rel_rms=rms_ref>0?std::sqrt(sum_err/sum_ref):0;
+		double rel_max=rms_ref>0?max_err/rms_ref:0;
+
+		std::cout<<"magnets: "<<num<<" theta: "<<pole_tree.theta<<" nodes: "<<pole_tree.getNumNodes()<<'\n';
+		std::cout<<"  exact: "<<exact_us<<"us tree: "<<tree_us<<"us\n";
+		std::cout<<"  rel rms err: "<<rel_rms<<" rel max err: "<<rel_max<<'\n';
 	}
 
 	void handlePhysics(double dt) {
 		//ensure similar update across multiple framerates?
 		update_timer+=dt;
 		while(update_timer>time_step) {
-			//for each unique pair of magnets
-			for(auto ait=magnets.begin(); ait!=magnets.end(); ait++) {
-				for(auto bit=std::next(ait); bit!=magnets.end(); bit++) {
-					auto& a=*ait;
-					auto& b=*bit;
+			refreshMagnetPtrs();
 
-					Magnet::applyMonopoleForces(a, b);
-				}
-			}
+			if(use_tree) applyTreeForces();
+			else applyExactForces();
 
 			if(grab_magnet) {
 				//spring force
@@ -271,14 +420,10 @@ public:
 			}
 
 			//check for collisions
-			for(auto ait=magnets.begin(); ait!=magnets.end(); ait++) {
-				for(auto bit=std::next(ait); bit!=magnets.end(); bit++) {
-					auto& a=*ait;
-					auto& b=*bit;
-
-					Magnet::checkCollide(a, b);
-				}
-			}
+			grid.build(magnet_ptrs);
+			grid.forEachPair([&] (int a, int b) {
+				Magnet::checkCollide(*magnet_ptrs[a], *magnet_ptrs[b]);
+			});
 
 			update_timer-=time_step;
 		}
@@ -0,0 +1,182 @@
+//https://en.wikipedia.org/wiki/Barnes%E2%80%93Hut_simulation
+#pragma once
+#ifndef POLE_TREE_CLASS_H
+#define POLE_TREE_CLASS_H
+
+#include "magnet.h"
+
+#include <vector>
+
+//quadtree over every magnets north & south poles.
+//  far away groups are collapsed into net charge + dipole
+//  so field evaluation is O(log n) instead of O(n).
+class PoleTree {
+public:
+	struct Pole {
+		cmn::vd2d pos;
+		//N=+1, S=-1
+		double charge=0;
+		//magnet index
+		int owner=-1;
+	};
+
+private:
+	struct Node {
+		cmn::AABBd2 box;
+		//expansion center
+		cmn::vd2d ctr;
+		double charge=0;
+		cmn::vd2d dipole;
+		int child[4]{-1, -1, -1, -1};
+		int start=0, num=0;
+		bool leaf=true;
+	};
+
+	static const int max_leaf_sz=8;
+	static const int max_depth=32;
+
+	std::vector<Node> nodes;
+	std::vector<Pole> poles;
+
+	int buildRecursive(const cmn::AABBd2& box, int start, int num, int depth) {
+		int ix=nodes.size();
+		nodes.push_back(Node());
+		nodes[ix].box=box;
+		nodes[ix].start=start;
+		nodes[ix].num=num;
+
+		//expand about center of absolute charge
+		cmn::vd2d ctr;
+		double sum_q=0, sum_abs=0;
+		for(int i=start; i<start+num; i++) {
+			const auto& p=poles[i];
+			double a=std::abs(p.charge);
+			ctr+=a*p.pos;
+			sum_q+=p.charge;
+			sum_abs+=a;
+		}
+		ctr=sum_abs>0?ctr/sum_abs:box.getCenter();
+		cmn::vd2d dipole;
+		for(int i=start; i<start+num; i++) {
+			dipole+=poles[i].charge*(poles[i].pos-ctr);
+		}
+		nodes[ix].ctr=ctr;
+		nodes[ix].charge=sum_q;
+		nodes[ix].dipole=dipole;
+
+		if(num<=max_leaf_sz||depth>=max_depth) return ix;
+
+		//partition into quadrants: x then y
+		cmn::vd2d mid=box.getCenter();
+		auto part=[&] (int b, int e, auto pred) {
+			int i=b;
+			for(int j=b; j<e; j++) {
+				if(pred(poles[j])) std::swap(poles[i++], poles[j]);
+			}
+			return i;
+		};
+		int end=start+num;
+		int sx=part(start, end, [&] (const Pole& p) { return p.pos.x<mid.x; });
+		int sy0=part(start, sx, [&] (const Pole& p) { return p.pos.y<mid.y; });
+		int sy1=part(sx, end, [&] (const Pole& p) { return p.pos.y<mid.y; });
+		const int bounds[5]{start, sy0, sx, sy1, end};
+		const cmn::AABBd2 quads[4]{
+			{box.min, mid},
+			{{box.min.x, mid.y}, {mid.x, box.max.y}},
+			{{mid.x, box.min.y}, {box.max.x, mid.y}},
+			{mid, box.max}
+		};
+
+		nodes[ix].leaf=false;
+		for(int i=0; i<4; i++) {
+			int n=bounds[i+1]-bounds[i];
+			if(n==0) continue;
+			int c=buildRecursive(quads[i], bounds[i], n, depth+1);
+			nodes[ix].child[i]=c;
+		}
+		return ix;
+	}
+
+	//far field of a whole node: monopole + dipole terms.
+	//  moving a source by s changes the kernel by -J*s,
+	//  so the dipole term is the kernel jacobian times p.
+	static cmn::vd2d farField(const Node& n, const cmn::vd2d& x) {
+		cmn::vd2d d=x-n.ctr;
+		double r2=dot(d, d);
+		double r=std::sqrt(r2);
+		if(r<1e-6) return {0, 0};
+		const double eps=Magnet::pole_soft;
+		double den=r*(eps+r2);
+		double g=1/den;
+		double dg_r=-(eps+3*r2)/(r2*den*(eps+r2));
+		cmn::vd2d jp=g*n.dipole+dg_r*dot(d, n.dipole)*d;
+		return Magnet::pole_coeff*(n.charge*g*d-jp);
+	}
+
+public:
+	//opening angle: 0=exact, bigger=faster
+	double theta=.5;
+
+	int getNumNodes() const {
+		return nodes.size();
+	}
+
+	void build(const std::vector<Pole>& ps) {
+		nodes.clear();
+		poles=ps;
+		if(poles.empty()) return;
+
+		//bounding square
+		const cmn::vd2d inf(1e300, 1e300);
+		cmn::AABBd2 box{inf, -inf};
+		for(const auto& p:poles) box.fitToEnclose(p.pos);
+		cmn::vd2d sz=box.max-box.min;
+		double half=.5*std::max(sz.x, sz.y)+1e-9;
+		cmn::vd2d ctr=box.getCenter();
+		box={ctr-half, ctr+half};
+
+		nodes.reserve(poles.size()/2+1);
+		buildRecursive(box, 0, poles.size(), 0);
+	}
+
+	//field at x from every pole not owned by owner.
+	//  force on a pole there is charge*field.
+	//  partner is owners other pole, which must never be lumped in.
+	cmn::vd2d getField(const cmn::vd2d& x, int owner, const cmn::vd2d& partner) const {
+		cmn::vd2d field;
+		if(nodes.empty()) return field;
+
+		int stack[4*max_depth+4];
+		int sz=0;
+		stack[sz++]=0;
+		const double theta_sq=theta*theta;
+		while(sz) {
+			const Node& n=nodes[stack[--sz]];
+
+			//far enough & doesnt hold any of this magnet?
+			if(!n.box.contains(x)&&!n.box.contains(partner)) {
+				double s=n.box.max.x-n.box.min.x;
+				cmn::vd2d d=x-n.ctr;
+				if(s*s<theta_sq*dot(d, d)) {
+					field+=farField(n, x);
+					continue;
+				}
+			}
+
+			if(n.leaf) {
+				for(int i=n.start; i<n.start+n.num; i++) {
+					const auto& p=poles[i];
+					if(p.owner==owner) continue;
+					field+=p.charge*Magnet::poleKernel(x-p.pos);
+				}
+			} else {
+				for(int i=0; i<4; i++) {
+					if(n.child[i]!=-1) stack[sz++]=n.child[i];
+				}
+			}
+		}
+
+		return field;
+	}
+};
+#endif
\ No newline at end of file
@@ -10,10 +10,7 @@ constexpr float Pi=3.1415927f;
 
 #include "lookup.h"
 
-float random01() {
-	static constexpr float rand_max=RAND_MAX;
-	return rand()/rand_max;
-}
+#include "cmn/utils.h"
 
 struct Example : cmn::Engine3D {
 	Example() {
@@ -41,12 +38,12 @@ struct Example : cmn::Engine3D {
 	float surf=.5f;
 
 	bool user_create() override {
-		srand(time(0));
+		cmn::seedRandom(time(0));
 
 		//w, h, d = [5, 10]
-		width=5+rand()%6;
-		height=5+rand()%6;
-		depth=5+rand()%6;
+		width=cmn::randInt(5, 10);
+		height=cmn::randInt(5, 10);
+		depth=cmn::randInt(5, 10);
 
 		cam_pos=vf3d(-2, .5f*height, -2);
 		light_pos=vf3d(.5f*width, 5+height, .5f*depth);
@@ -0,0 +1,261 @@
+#pragma once
+#ifndef CONTOUR_CLASS_H
+#define CONTOUR_CLASS_H
+
+#include "sdf_field.h"
+
+#include <string>
+
+#include <fstream>
+
+#ifndef __EMSCRIPTEN__
+#include <thread>
+#endif
+
+//isolines of a field as indexed, stitched polylines.
+//  every crossed grid edge gets exactly one vertex,
+//  which both cells touching it share.
+class Contour {
+	//max 2 edges per state
+	//-1 is stop flag
+	static constexpr int edge_table[16][4]{
+		{-1, -1, -1, -1}, {0, 3, -1, -1},
+		{0, 1, -1, -1}, {1, 3, -1, -1},
+		{2, 3, -1, -1}, {0, 2, -1, -1},
+		{0, 3, 1, 2}, {1, 2, -1, -1},
+		{1, 2, -1, -1}, {0, 1, 2, 3},
+		{0, 2, -1, -1}, {2, 3, -1, -1},
+		{1, 3, -1, -1}, {0, 1, -1, -1},
+		{0, 3, -1, -1}, {-1, -1, -1, -1}
+	};
+
+	//band local vertex index per grid edge, -1 if not crossed.
+	//  horizontal: (i, j)-(i+1, j), vertical: (i, j)-(i, j+1)
+	std::vector<int> h_vert, v_vert;
+
+	struct Band {
+		int j0=0, j1=0;
+		int offset=0;
+		std::vector<cmn::vf2d> verts;
+		std::vector<int> segs;
+	};
+	std::vector<Band> bands;
+	int rows_per_band=1;
+
+	//stitching
+	std::vector<int> nbrs;
+	std::vector<bool> visited;
+
+	template<typename Fn>
+	void forEachBand(Fn fn) {
+#ifdef __EMSCRIPTEN__
+		for(auto& b:bands) fn(b);
+#else
+		if(bands.size()==1) fn(bands[0]);
+		else {
+			std::vector<std::thread> workers;
+			for(auto& b:bands) workers.emplace_back(fn, std::ref(b));
+			for(auto& w:workers) w.join();
+		}
+#endif
+	}
+
+	int globalVert(int local, int j) const {
+		return local==-1?-1:bands[j/rows_per_band].offset+local;
+	}
+
+	//crossings on every edge starting in bands rows
+	void findCrossings(const SDFField& field, float surf, Band& b) {
+		const int w=field.getWidth(), h=field.getHeight();
+		const auto& vals=field.val_grid;
+		const auto& pos=field.pos_grid;
+		b.verts.clear();
+		for(int j=b.j0; j<b.j1; j++) {
+			for(int i=0; i<w; i++) {
+				int k=i+w*j;
+				bool in=vals[k]>surf;
+
+				h_vert[k]=-1;
+				if(i<w-1&&in!=(vals[k+1]>surf)) {
+					h_vert[k]=b.verts.size();
+					b.verts.push_back(mix(pos[k], pos[k+1], invLerp(surf, vals[k], vals[k+1])));
+				}
+
+				v_vert[k]=-1;
+				if(j<h-1&&in!=(vals[k+w]>surf)) {
+					v_vert[k]=b.verts.size();
+					b.verts.push_back(mix(pos[k], pos[k+w], invLerp(surf, vals[k], vals[k+w])));
+				}
+			}
+		}
+	}
+
+	//segments as global vertex pairs
+	void findSegments(const SDFField& field, float surf, Band& b) {
+		const int w=field.getWidth(), h=field.getHeight();
+		const auto& vals=field.val_grid;
+		b.segs.clear();
+		for(int j=b.j0; j<b.j1&&j<h-1; j++) {
+			for(int i=0; i<w-1; i++) {
+				int k=i+w*j;
+				//threshold values against surface
+				bool b0=vals[k]>surf, b1=vals[k+1]>surf;
+				bool b2=vals[k+w]>surf, b3=vals[k+w+1]>surf;
+				//bitbang state
+				int state=b3<<3|b2<<2|b1<<1|b0<<0;
+				const auto& edges=edge_table[state];
+				if(edges[0]==-1) continue;
+
+				//top, right, bottom, left
+				const int ids[4]{
+					globalVert(h_vert[k], j),
+					globalVert(v_vert[k+1], j),
+					globalVert(h_vert[k+w], j+1),
+					globalVert(v_vert[k], j)
+				};
+				for(int e=0; e<4; e+=2) {
+					if(edges[e]==-1) break;
+
+					b.segs.push_back(ids[edges[e]]);
+					b.segs.push_back(ids[edges[e+1]]);
+				}
+			}
+		}
+	}
+
+	void walk(int start, bool closed) {
+		Polyline p;
+		p.start=indices.size();
+		p.closed=closed;
+
+		int curr=start;
+		while(curr!=-1) {
+			visited[curr]=true;
+			indices.push_back(curr);
+
+			//unvisited neighbor
+			int n0=nbrs[2*curr], n1=nbrs[1+2*curr];
+			if(n0!=-1&&!visited[n0]) curr=n0;
+			else if(n1!=-1&&!visited[n1]) curr=n1;
+			else curr=-1;
+		}
+
+		p.num=indices.size()-p.start;
+		polylines.push_back(p);
+	}
+
+	//each vertex has at most 2 segments,
+	//  so chains either end on the border or loop
+	void stitch() {
+		const int num=verts.size();
+		nbrs.assign(2*num, -1);
+		visited.assign(num, false);
+		for(const auto& b:bands) {
+			for(int s=0; s<b.segs.size(); s+=2) {
+				int u=b.segs[s], v=b.segs[s+1];
+				nbrs[2*u+(nbrs[2*u]!=-1)]=v;
+				nbrs[2*v+(nbrs[2*v]!=-1)]=u;
+			}
+		}
+
+		indices.clear();
+		polylines.clear();
+
+		//open chains start at an end
+		for(int v=0; v<num; v++) {
+			if(visited[v]) continue;
+
+			if(nbrs[1+2*v]==-1) walk(v, false);
+		}
+
+		//everything left is a loop
+		for(int v=0; v<num; v++) {
+			if(!visited[v]) walk(v, true);
+		}
+	}
+
+public:
+	struct Polyline {
+		int start=0, num=0;
+		bool closed=false;
+	};
+
+	std::vector<cmn::vf2d> verts;
+	//polylines are ranges of this
+	std::vector<int> indices;
+	std::vector<Polyline> polylines;
+
+	int getNumSegments() const {
+		int num=0;
+		for(const auto& p:polylines) num+=p.closed?p.num:p.num-1;
+		return num;
+	}
+
+	//num_threads=0 picks hardware concurrency
+	void extract(const SDFField& field, float surf, int num_threads=0) {
+		const int w=field.getWidth(), h=field.getHeight();
+		verts.clear();
+		indices.clear();
+		polylines.clear();
+		if(w<2||h<2) return;
+
+#ifdef __EMSCRIPTEN__
+		num_threads=1;
+#else
+		//tiny grids arent worth the threads
+		if(num_threads<=0) {
+			const int min_rows=64;
+			num_threads=std::thread::hardware_concurrency();
+			if(num_threads<=0) num_threads=1;
+			num_threads=std::min(num_threads, 1+h/min_rows);
+		}
+#endif
+		num_threads=std::max(1, std::min(num_threads, h));
+
+		h_vert.resize(w*h);
+		v_vert.resize(w*h);
+
+		rows_per_band=(h+num_threads-1)/num_threads;
+		bands.resize((h+rows_per_band-1)/rows_per_band);
+		for(int i=0; i<bands.size(); i++) {
+			bands[i].j0=rows_per_band*i;
+			bands[i].j1=std::min(h, rows_per_band*(i+1));
+		}
+
+		forEachBand([&] (Band& b) { findCrossings(field, surf, b); });
+
+		//global vertex ids
+		int num_verts=0;
+		for(auto& b:bands) {
+			b.offset=num_verts;
+			num_verts+=b.verts.size();
+		}
+		verts.resize(num_verts);
+
+		forEachBand([&] (Band& b) {
+			std::copy(b.verts.begin(), b.verts.end(), verts.begin()+b.offset);
+			findSegments(field, surf, b);
+		});
+
+		stitch();
+	}
+
+	bool saveSVG(const std::string& filename, float w, float h) const {
+		std::ofstream file(filename);
+		if(file.fail()) return false;
+
+		file<<"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\""<<w<<"\" height=\""<<h<<"\">\n";
+		for(const auto& p:polylines) {
+			file<<(p.closed?"<polygon":"<polyline")<<" fill=\"none\" stroke=\"black\" points=\"";
+			for(int i=0; i<p.num; i++) {
+				const auto& v=verts[indices[p.start+i]];
+				file<<v.x<<','<<v.y<<' ';
+			}
+			file<<"\"/>\n";
+		}
+		file<<"</svg>\n";
+
+		return true;
+	}
+};
+#endif
\ No newline at end of file
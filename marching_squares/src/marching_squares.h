@@ -4,6 +4,7 @@
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -53,6 +54,16 @@ cmn::vf2d mix(const cmn::vf2d& a, const cmn::vf2d& b, float t) {
 	return a+t*(b-a);
 }
 
+//uses gradients above
+#include "sdf_field.h"
+
+//uses mix & invLerp above
+#include "contour.h"
+
+#include "cmn/stopwatch.h"
+
+#include <iostream>
+
 using cmn::vf2d;
 
 struct MarchingSquares : public cmn::SokolEngine {
@@ -61,9 +72,11 @@ struct MarchingSquares : public cmn::SokolEngine {
 	int width=0, height=0;
 	int ix(int i, int j) { return i+width*j; }
 
-	float* val_grid=nullptr;
-	vf2d* pos_grid=nullptr;
-	float* col_grid=nullptr;
+	SDFField field;
+
+	//only reextracted when field changes
+	Contour contour;
+	int contour_version=-1;
 
 	vf2d mouse_pos;
 
@@ -75,18 +88,6 @@ struct MarchingSquares : public cmn::SokolEngine {
 	bool render_values=true;
 	bool render_shapes=true;
 
-	//max 2 edges per state
-	//-1 is stop flag
-	const int edge_table[16][4]{
-		{-1, -1, -1, -1}, {0, 3, -1, -1},
-		{0, 1, -1, -1}, {1, 3, -1, -1},
-		{2, 3, -1, -1}, {0, 2, -1, -1},
-		{0, 3, 1, 2}, {1, 2, -1, -1},
-		{1, 2, -1, -1}, {0, 1, 2, 3},
-		{0, 2, -1, -1}, {2, 3, -1, -1},
-		{1, 3, -1, -1}, {0, 1, -1, -1},
-		{0, 3, -1, -1}, {-1, -1, -1, -1}
-	};
 #pragma region SETUP HELPERS
 	void setupShapes() {
 		const vf2d res(sapp_widthf(), sapp_heightf());
@@ -119,7 +120,7 @@ struct MarchingSquares : public cmn::SokolEngine {
 	bool user_create() override {
 		app_title="Marching Squares";
 		
-		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		setupShapes();
 
@@ -233,6 +234,14 @@ struct MarchingSquares : public cmn::SokolEngine {
 		if(GetKey(SAPP_KEYCODE_V).pressed) render_values^=true;
 		if(GetKey(SAPP_KEYCODE_S).pressed) render_shapes^=true;
 
+		if(GetKey(SAPP_KEYCODE_B).pressed) runBenchmark();
+
+		if(GetKey(SAPP_KEYCODE_E).pressed) {
+			if(contour.saveSVG("contours.svg", sapp_widthf(), sapp_heightf())) {
+				std::cout<<"exported "<<contour.polylines.size()<<" contours to contours.svg\n";
+			}
+		}
+
 		//change resolution?
 		if(GetKey(SAPP_KEYCODE_UP).held) cell_sz*=1-dt;
 		if(GetKey(SAPP_KEYCODE_DOWN).held) cell_sz*=1+dt;
@@ -246,69 +255,130 @@ struct MarchingSquares : public cmn::SokolEngine {
 	}
 
 	void updateSizing() {
-		int w=1+sapp_widthf()/cell_sz;
-		int h=1+sapp_heightf()/cell_sz;
-		if(w==width&&h==height) return;
-
-		delete[] val_grid;
-		delete[] pos_grid;
-		delete[] col_grid;
-
-		width=w, height=h;
-		val_grid=new float[width*height];
-		pos_grid=new vf2d[width*height];
-		col_grid=new float[3*width*height];
+		width=1+sapp_widthf()/cell_sz;
+		height=1+sapp_heightf()/cell_sz;
+
+		//only reallocates if changed
+		field.resize(width, height, cell_sz);
 	}
 
 	//update values based on signed distance field
 	void updateGrids() {
-		for(int i=0; i<width; i++) {
-			for(int j=0; j<height; j++) {
-				int k=ix(i, j);
+		field.update(shapes, combine_union);
+	}
 
-				//center of cell
-				auto p=cell_sz*vf2d(.5f+i, .5f+j);
-				pos_grid[k]=p;
+	void updateContour() {
+		if(field.getVersion()==contour_version) return;
 
-				bool first=true;
-				auto& record=val_grid[k];
-				for(const auto& s:shapes) {
-					float sd=s->signedDist(p);
+		contour.extract(field, 0);
+		contour_version=field.getVersion();
+	}
 
-					//min for union, max for intersection
-					bool more=sd>record;
-					if(first||(combine_union^more)) {
-						record=sd;
-						first=false;
-					}
+	//big offscreen field: full build, then drag one shape around.
+	//  compares against evaluating every shape at every cell.
+	void runBenchmark() {
+		const int sz=2048;
+		const int num_shapes=300;
+		const int num_drags=20;
+
+		std::list<SDFShape*> bench_shapes;
+		for(int i=0; i<num_shapes; i++) {
+			vf2d pos(cmn::randFloat(sz), cmn::randFloat(sz));
+			switch(i%3) {
+				case 0: {
+					auto rect=new SDFRectangle{};
+					vf2d half_size(cmn::randFloat(5, 25), cmn::randFloat(5, 25));
+					rect->p0=pos-half_size;
+					rect->p1=pos+half_size;
+					bench_shapes.push_back(rect);
+					break;
+				}
+				case 1: {
+					auto circ=new SDFCircle{};
+					circ->ctr=pos;
+					circ->edge=pos+vf2d(cmn::randFloat(5, 25), 0);
+					bench_shapes.push_back(circ);
+					break;
+				}
+				case 2: {
+					auto tri=new SDFTriangle{};
+					tri->p0=pos+cmn::polar<vf2d>(25.f, cmn::randFloat(2*cmn::Pi));
+					tri->p1=pos+cmn::polar<vf2d>(25.f, cmn::randFloat(2*cmn::Pi));
+					tri->p2=pos+cmn::polar<vf2d>(25.f, cmn::randFloat(2*cmn::Pi));
+					bench_shapes.push_back(tri);
+					break;
 				}
-				if(first) record=0;
 			}
 		}
 
-		//find absolute value range
-		float max=1e-6f;
-		for(int i=0; i<width; i++) {
-			for(int j=0; j<height; j++) {
-				float v=std::abs(val_grid[ix(i, j)]);
-				if(v>max) max=v;
-			}
+		SDFField bench;
+		bench.resize(sz, sz, 1);
+		cmn::Stopwatch watch;
+		watch.start();
+		bench.update(bench_shapes, true);
+		watch.stop();
+		std::cout<<"field "<<sz<<"x"<<sz<<" w/ "<<num_shapes<<" shapes\n";
+		std::cout<<"  full build: "<<watch.getMillis()<<"ms\n";
+
+		//drag a circle around
+		auto circ=static_cast<SDFCircle*>(*std::next(bench_shapes.begin()));
+		watch.start();
+		long long evaluated=0;
+		for(int i=0; i<num_drags; i++) {
+			vf2d delta=cmn::polar<vf2d>(8.f, cmn::randFloat(2*cmn::Pi));
+			circ->ctr+=delta;
+			circ->edge+=delta;
+			bench.update(bench_shapes, true);
+			evaluated+=bench.getNumEvaluated();
 		}
-
-		//color ramp
-		for(int i=0; i<width; i++) {
-			for(int j=0; j<height; j++) {
-				int k=ix(i, j);
-
-				//sign predicates in/out
-				float t=val_grid[k]/max;
-				float& r=col_grid[3*k];
-				float& g=col_grid[1+3*k];
-				float& b=col_grid[2+3*k];
-				if(t>0) outsideGradient(t, &r, &g, &b);
-				else insideGradient(-t, &r, &g, &b);
+		watch.stop();
+		std::cout<<"  drag: "<<(watch.getMicros()/num_drags)<<"us/update, "
+			<<(evaluated/num_drags)<<" shape evals/update\n";
+
+		//every shape at every cell, like before
+		watch.start();
+		float max_err=0;
+		for(int j=0; j<sz; j++) {
+			for(int i=0; i<sz; i++) {
+				vf2d p(.5f+i, .5f+j);
+				float record=bench.band;
+				for(const auto& s:bench_shapes) {
+					record=std::min(record, s->signedDist(p));
+				}
+				max_err=std::max(max_err, std::abs(record-bench.val_grid[i+sz*j]));
 			}
 		}
+		watch.stop();
+		std::cout<<"  brute force: "<<watch.getMillis()<<"ms, max diff: "<<max_err<<'\n';
+
+		//contour extraction against grid size, same shapes
+		const int num_runs=10;
+		std::cout<<"contour extraction\n";
+		for(int res=256; res<=sz; res*=2) {
+			SDFField res_field;
+			res_field.resize(res, res, float(sz)/res);
+			res_field.update(bench_shapes, true);
+
+			Contour res_contour;
+			watch.start();
+			for(int i=0; i<num_runs; i++) res_contour.extract(res_field, 0, 1);
+			watch.stop();
+			auto single_us=watch.getMicros()/num_runs;
+
+			watch.start();
+			for(int i=0; i<num_runs; i++) res_contour.extract(res_field, 0);
+			watch.stop();
+			auto multi_us=watch.getMicros()/num_runs;
+
+			std::cout<<"  "<<res<<"x"<<res<<": "
+				<<res_contour.verts.size()<<" verts, "
+				<<res_contour.getNumSegments()<<" segs, "
+				<<res_contour.polylines.size()<<" lines, "
+				<<single_us<<"us 1 thread, "
+				<<multi_us<<"us threaded\n";
+		}
+
+		for(const auto& s:bench_shapes) delete s;
 	}
 #pragma endregion
 
@@ -323,6 +393,8 @@ struct MarchingSquares : public cmn::SokolEngine {
 
 		updateGrids();
 
+		updateContour();
+
 		return true;
 	}
 
@@ -336,7 +408,7 @@ struct MarchingSquares : public cmn::SokolEngine {
 				float y=cell_sz*j;
 				cmn::fill_rect(
 					x, y, cell_sz, cell_sz,
-					col_grid[3*k], col_grid[1+3*k], col_grid[2+3*k]
+					field.col_grid[3*k], field.col_grid[1+3*k], field.col_grid[2+3*k]
 				);
 			}
 		}
@@ -348,40 +420,17 @@ struct MarchingSquares : public cmn::SokolEngine {
 		}
 	}
 
-	void renderMarchedSquares(float surf) {
-		for(int i=0; i<width-1; i++) {
-			for(int j=0; j<height-1; j++) {
-				const auto& v0=val_grid[ix(i, j)];
-				const auto& v1=val_grid[ix(i+1, j)];
-				const auto& v2=val_grid[ix(i, j+1)];
-				const auto& v3=val_grid[ix(i+1, j+1)];
-				const auto& p0=pos_grid[ix(i, j)];
-				const auto& p1=pos_grid[ix(i+1, j)];
-				const auto& p2=pos_grid[ix(i, j+1)];
-				const auto& p3=pos_grid[ix(i+1, j+1)];
-				//threshold values against surface
-				bool b0=v0>surf, b1=v1>surf, b2=v2>surf, b3=v3>surf;
-				//bitbang state
-				int state=b3<<3|b2<<2|b1<<1|b0<<0;
-				const auto& edges=edge_table[state];
-				for(int k=0; k<4; k+=2) {
-					if(edges[k]==-1) break;
-
-					vf2d p[2];
-					for(int l=0; l<2; l++) {
-						switch(edges[k+l]) {
-							case 0: p[l]=mix(p0, p1, invLerp(surf, v0, v1)); break;
-							case 1: p[l]=mix(p1, p3, invLerp(surf, v1, v3)); break;
-							case 2: p[l]=mix(p3, p2, invLerp(surf, v3, v2)); break;
-							case 3: p[l]=mix(p2, p0, invLerp(surf, v2, v0)); break;
-						}
-					}
-					cmn::draw_thick_line(
-						p[0].x, p[0].y, p[1].x, p[1].y,
-						2,
-						1, 1, 1
-					);
-				}
+	void renderContour() {
+		for(const auto& p:contour.polylines) {
+			int num=p.closed?p.num:p.num-1;
+			for(int i=0; i<num; i++) {
+				const auto& a=contour.verts[contour.indices[p.start+i]];
+				const auto& b=contour.verts[contour.indices[p.start+(i+1)%p.num]];
+				cmn::draw_thick_line(
+					a.x, a.y, b.x, b.y,
+					2,
+					1, 1, 1
+				);
 			}
 		}
 	}
@@ -416,7 +465,7 @@ struct MarchingSquares : public cmn::SokolEngine {
 		//these look better behind
 		if(render_shapes) renderShapes();
 
-		renderMarchedSquares(0);
+		renderContour();
 
 		//these look better in front
 		if(render_shapes) renderShapeHandles();
@@ -0,0 +1,263 @@
+#pragma once
+#ifndef SDF_FIELD_CLASS_H
+#define SDF_FIELD_CLASS_H
+
+#include "sdf_shape.h"
+
+#include <vector>
+
+#include <unordered_map>
+
+//grid of combined shape distances & colors.
+//  every shape is clamped at band, so it only
+//  changes cells within band of its bounding circle.
+//  only tiles touched by shapes that moved,
+//  were added or removed are reevaluated.
+class SDFField {
+	int width=0, height=0;
+	float cell_sz=1;
+
+	//last seen state of each shape
+	struct Snapshot {
+		std::vector<cmn::vf2d> handles;
+		cmn::vf2d ctr;
+		float rad=0;
+		int stamp=0;
+	};
+	std::unordered_map<const SDFShape*, Snapshot> snapshots;
+	int stamp=0;
+
+	bool combine_union=true;
+	bool all_dirty=true;
+
+	static const int tile_sz=64;
+	int tiles_x=0, tiles_y=0;
+	std::vector<bool> dirty_tiles;
+
+	//scratch
+	std::vector<const SDFShape*> curr_shapes;
+	struct Bounds {
+		cmn::vf2d ctr;
+		float rad=0;
+	};
+	std::vector<Bounds> curr_bounds;
+	std::vector<int> candidates;
+	float row_buf[tile_sz];
+
+	int num_evaluated=0;
+	int version=0;
+
+	void markDirty(const cmn::vf2d& ctr, float rad) {
+		//circle of influence in cell space
+		float r=rad+band;
+		int i0=std::floor((ctr.x-r)/cell_sz-.5f);
+		int j0=std::floor((ctr.y-r)/cell_sz-.5f);
+		int i1=std::ceil((ctr.x+r)/cell_sz-.5f);
+		int j1=std::ceil((ctr.y+r)/cell_sz-.5f);
+		i0=std::max(0, i0), j0=std::max(0, j0);
+		i1=std::min(width-1, i1), j1=std::min(height-1, j1);
+		if(i0>i1||j0>j1) return;
+
+		for(int tj=j0/tile_sz; tj<=j1/tile_sz; tj++) {
+			for(int ti=i0/tile_sz; ti<=i1/tile_sz; ti++) {
+				dirty_tiles[ti+tiles_x*tj]=true;
+			}
+		}
+	}
+
+	//did any handle move since last time?
+	//  returns if any shapes were added or removed.
+	bool updateSnapshots(const std::list<SDFShape*>& shapes) {
+		bool membership=false;
+		stamp++;
+		for(const auto& s:shapes) {
+			auto handles=s->getHandles();
+			auto it=snapshots.find(s);
+
+			//new shape
+			if(it==snapshots.end()) {
+				Snapshot snap;
+				for(const auto& h:handles) snap.handles.push_back(*h);
+				s->getBounds(snap.ctr, snap.rad);
+				snap.stamp=stamp;
+				markDirty(snap.ctr, snap.rad);
+				snapshots[s]=snap;
+				membership=true;
+				continue;
+			}
+
+			auto& snap=it->second;
+			snap.stamp=stamp;
+			bool moved=handles.size()!=snap.handles.size();
+			if(!moved) {
+				int i=0;
+				for(const auto& h:handles) {
+					const auto& o=snap.handles[i++];
+					if(h->x!=o.x||h->y!=o.y) {
+						moved=true;
+						break;
+					}
+				}
+			}
+			if(!moved) continue;
+
+			//old & new footprints
+			markDirty(snap.ctr, snap.rad);
+			snap.handles.clear();
+			for(const auto& h:handles) snap.handles.push_back(*h);
+			s->getBounds(snap.ctr, snap.rad);
+			markDirty(snap.ctr, snap.rad);
+		}
+
+		//removed shapes
+		for(auto it=snapshots.begin(); it!=snapshots.end();) {
+			if(it->second.stamp!=stamp) {
+				markDirty(it->second.ctr, it->second.rad);
+				it=snapshots.erase(it);
+				membership=true;
+			} else it++;
+		}
+
+		return membership;
+	}
+
+	void evaluateTile(int ti, int tj) {
+		int i0=tile_sz*ti, j0=tile_sz*tj;
+		int i1=std::min(width, i0+tile_sz);
+		int j1=std::min(height, j0+tile_sz);
+		int num=i1-i0;
+
+		//tile box in world space
+		float x_min=cell_sz*(.5f+i0), x_max=cell_sz*(.5f+i1-1);
+		float y_min=cell_sz*(.5f+j0), y_max=cell_sz*(.5f+j1-1);
+
+		//cull by bounding circle+band
+		candidates.clear();
+		for(int k=0; k<curr_shapes.size(); k++) {
+			const auto& snap=curr_bounds[k];
+			float cx=std::clamp(snap.ctr.x, x_min, x_max);
+			float cy=std::clamp(snap.ctr.y, y_min, y_max);
+			float dx=snap.ctr.x-cx, dy=snap.ctr.y-cy;
+			float r=snap.rad+band;
+			if(dx*dx+dy*dy<=r*r) candidates.push_back(k);
+		}
+
+		//intersection needs every shape, any missing means >band
+		bool all_band=!combine_union&&candidates.size()<curr_shapes.size();
+		bool none=curr_shapes.empty();
+
+		for(int j=j0; j<j1; j++) {
+			float* vals=&val_grid[i0+width*j];
+			float y=cell_sz*(.5f+j);
+			if(none) {
+				std::fill(vals, vals+num, 0.f);
+			} else if(all_band) {
+				std::fill(vals, vals+num, band);
+			} else {
+				//min for union, max for intersection
+				std::fill(vals, vals+num, combine_union?band:-1e30f);
+				for(const auto& k:candidates) {
+					curr_shapes[k]->signedDistRow(cell_sz*(.5f+i0), cell_sz, y, num, row_buf);
+					if(combine_union) {
+						for(int i=0; i<num; i++) vals[i]=std::min(vals[i], row_buf[i]);
+					} else {
+						for(int i=0; i<num; i++) vals[i]=std::max(vals[i], row_buf[i]);
+					}
+				}
+				if(!combine_union) {
+					for(int i=0; i<num; i++) vals[i]=std::min(vals[i], band);
+				}
+				num_evaluated+=num*candidates.size();
+			}
+
+			//color ramp, normalized by band
+			float* cols=&col_grid[3*(i0+width*j)];
+			for(int i=0; i<num; i++) {
+				float t=vals[i]/band;
+				float* rgb=cols+3*i;
+				if(t>0) outsideGradient(t, rgb, rgb+1, rgb+2);
+				else insideGradient(-t, rgb, rgb+1, rgb+2);
+			}
+		}
+	}
+
+public:
+	//distances are clamped to this
+	float band=160;
+
+	std::vector<float> val_grid;
+	std::vector<cmn::vf2d> pos_grid;
+	std::vector<float> col_grid;
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+	//cells changed last update
+	int getNumEvaluated() const { return num_evaluated; }
+
+	//bumped whenever any values change
+	int getVersion() const { return version; }
+
+	void invalidate() {
+		all_dirty=true;
+	}
+
+	void resize(int w, int h, float sz) {
+		if(w==width&&h==height&&sz==cell_sz) return;
+
+		width=w, height=h;
+		cell_sz=sz;
+		val_grid.assign(width*height, 0);
+		col_grid.assign(3*width*height, 0);
+		pos_grid.resize(width*height);
+		for(int j=0; j<height; j++) {
+			for(int i=0; i<width; i++) {
+				pos_grid[i+width*j]=cell_sz*cmn::vf2d(.5f+i, .5f+j);
+			}
+		}
+
+		tiles_x=(width+tile_sz-1)/tile_sz;
+		tiles_y=(height+tile_sz-1)/tile_sz;
+		dirty_tiles.assign(tiles_x*tiles_y, false);
+
+		invalidate();
+	}
+
+	void update(const std::list<SDFShape*>& shapes, bool cu) {
+		num_evaluated=0;
+
+		if(cu!=combine_union) {
+			combine_union=cu;
+			invalidate();
+		}
+
+		//adding or removing any shape can change all of
+		//  intersection, and no shapes at all means 0 everywhere
+		bool was_empty=snapshots.empty();
+		if(updateSnapshots(shapes)) {
+			if(!combine_union||was_empty||shapes.empty()) invalidate();
+		}
+
+		curr_shapes.assign(shapes.begin(), shapes.end());
+		curr_bounds.clear();
+		for(const auto& s:curr_shapes) {
+			const auto& snap=snapshots[s];
+			curr_bounds.push_back({snap.ctr, snap.rad});
+		}
+
+		bool changed=false;
+		for(int tj=0; tj<tiles_y; tj++) {
+			for(int ti=0; ti<tiles_x; ti++) {
+				int t=ti+tiles_x*tj;
+				if(!all_dirty&&!dirty_tiles[t]) continue;
+
+				evaluateTile(ti, tj);
+				dirty_tiles[t]=false;
+				changed=true;
+			}
+		}
+		all_dirty=false;
+		if(changed) version++;
+	}
+};
+#endif
\ No newline at end of file
@@ -34,6 +34,14 @@ struct SDFShape {
 
 	virtual float signedDist(const cmn::vf2d&)const=0;
 
+	//signed dist of num points (x+i*dx, y) into out.
+	//  one virtual call per row, and the
+	//  branchless inner loops can vectorize.
+	virtual void signedDistRow(float x, float dx, float y, int num, float* out)const=0;
+
+	//shape fits inside this circle
+	virtual void getBounds(cmn::vf2d& ctr, float& rad)const=0;
+
 	virtual void render()const=0;
 };
 
@@ -61,6 +69,27 @@ struct SDFRectangle : SDFShape {
 		return outside+inside;
 	}
 
+	void signedDistRow(float x, float dx, float y, int num, float* out) const override {
+		cmn::vf2d half=.5f*abs(p0-p1);
+		cmn::vf2d ctr=(p0+p1)/2;
+
+		//same for whole row
+		float d_y=std::abs(y-ctr.y)-half.y;
+		float out_y=std::max(0.f, d_y);
+		for(int i=0; i<num; i++) {
+			float d_x=std::abs(x+dx*i-ctr.x)-half.x;
+			float out_x=std::max(0.f, d_x);
+			float outside=std::sqrt(out_x*out_x+out_y*out_y);
+			float inside=std::min(0.f, std::max(d_x, d_y));
+			out[i]=outside+inside;
+		}
+	}
+
+	void getBounds(cmn::vf2d& ctr, float& rad) const override {
+		ctr=(p0+p1)/2;
+		rad=.5f*(p0-p1).mag();
+	}
+
 	void render() const override {
 		cmn::vf2d sz=abs(p0-p1);
 		cmn::vf2d ctr=.5f*(p0+p1);
@@ -86,6 +115,21 @@ struct SDFCircle : SDFShape {
 		return (p-ctr).mag()-rad;
 	}
 
+	void signedDistRow(float x, float dx, float y, int num, float* out) const override {
+		float rad=(edge-ctr).mag();
+
+		float d_y=y-ctr.y;
+		for(int i=0; i<num; i++) {
+			float d_x=x+dx*i-ctr.x;
+			out[i]=std::sqrt(d_x*d_x+d_y*d_y)-rad;
+		}
+	}
+
+	void getBounds(cmn::vf2d& c, float& rad) const override {
+		c=ctr;
+		rad=(edge-ctr).mag();
+	}
+
 	void render() const override {
 		float rad=(edge-ctr).mag();
 		
@@ -118,6 +162,34 @@ struct SDFTriangle : SDFShape {
 		return -std::sqrt(d.x)*sign(d.y);
 	}
 
+	//same as above, unrolled per component
+	void signedDistRow(float x, float dx, float y, int num, float* out) const override {
+		cmn::vf2d e0=p1-p0, e1=p2-p1, e2=p0-p2;
+		float ie0=1/e0.dot(e0), ie1=1/e1.dot(e1), ie2=1/e2.dot(e2);
+		float s=sign(e0.x*e2.y-e0.y*e2.x);
+		float v0y=y-p0.y, v1y=y-p1.y, v2y=y-p2.y;
+		for(int i=0; i<num; i++) {
+			float px=x+dx*i;
+			float v0x=px-p0.x, v1x=px-p1.x, v2x=px-p2.x;
+			float t0=std::clamp((v0x*e0.x+v0y*e0.y)*ie0, 0.f, 1.f);
+			float t1=std::clamp((v1x*e1.x+v1y*e1.y)*ie1, 0.f, 1.f);
+			float t2=std::clamp((v2x*e2.x+v2y*e2.y)*ie2, 0.f, 1.f);
+			float q0x=v0x-e0.x*t0, q0y=v0y-e0.y*t0;
+			float q1x=v1x-e1.x*t1, q1y=v1y-e1.y*t1;
+			float q2x=v2x-e2.x*t2, q2y=v2y-e2.y*t2;
+			float d=std::min(q0x*q0x+q0y*q0y, std::min(q1x*q1x+q1y*q1y, q2x*q2x+q2y*q2y));
+			float c=std::min(s*(v0x*e0.y-v0y*e0.x), std::min(s*(v1x*e1.y-v1y*e1.x), s*(v2x*e2.y-v2y*e2.x)));
+			float sg=c>0?1.f:c<0?-1.f:0.f;
+			out[i]=-std::sqrt(d)*sg;
+		}
+	}
+
+	//centroid & furthest corner
+	void getBounds(cmn::vf2d& ctr, float& rad) const override {
+		ctr=(p0+p1+p2)/3;
+		rad=std::max((p0-ctr).mag(), std::max((p1-ctr).mag(), (p2-ctr).mag()));
+	}
+
 	void render() const override {
 		cmn::draw_triangle(
 			p0.x, p0.y, p1.x, p1.y, p2.x, p2.y,
@@ -4,6 +4,7 @@
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -68,6 +69,7 @@ public:
 		app_title="Meshing";
 		
 		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		setupSGL();
 
@@ -7,21 +7,33 @@
 #include <string>
 #include <vector>
 
-#include <stack>
+//for uint64_t
+#include <cstdint>
+
+//for min
+#include <algorithm>
 
 struct Cell {
 	int num_bombs=-1;
 	bool bomb=false;
 	bool swept=false;
 	bool flagged=false;
+};
 
-	bool operator!=(const Cell& c) const {
-		if(num_bombs!=c.num_bombs) return true;
-		if(bomb!=c.bomb) return true;
-		if(swept!=c.swept) return true;
-		if(flagged!=c.flagged) return true;
-		return false;
-	}
+//faces of a block of cells, only rebuilt when something in
+//  or right next to it gets swept or flagged.
+struct FaceChunk {
+	static const int size=16;
+
+	//cell range, exclusive
+	int i0=0, j0=0, k0=0;
+	int i1=0, j1=0, k1=0;
+
+	//base and flagged face instances(in local space)
+	//this assumes xz vertex buffer
+	std::vector<cmn::mat4> tile_faces, flag_faces;
+
+	bool dirty=true;
 };
 
 class Minesweeper {
@@ -30,15 +42,35 @@ class Minesweeper {
 
 	int num_bombs=0;
 
+	//cells in the order they got swept,
+	//  cleared & bumped every reset.
+	std::vector<int> sweep_log;
+	int generation=0;
+
+	//so state checks dont need to look at every cell
+	int num_swept_safe=0;
+	int num_flags=0;
+	bool exploded=false;
+
+	//flood scratch
+	std::vector<std::uint64_t> visited;
+	std::vector<int> to_sweep;
+	int nbr_offsets[27];
+
+	int chunks_x=0, chunks_y=0, chunks_z=0;
+
 	void copyFrom(const Minesweeper&), clear();
 
+	void countNeighbors();
+
+	void sweepCell(int i, int j, int k);
+
 	bool floodsweep(int i, int j, int k);
 
-	void updatePrev(), checkState(), unflagSwept(), updateFaces();
+	void checkState(), markDirty(int i, int j, int k), updateChunk(FaceChunk&);
 
 public:
 	Cell* cells=nullptr;
-	Cell* prev_cells=nullptr;
 
 	enum State {
 		START=0,
@@ -48,9 +80,7 @@ public:
 		WON
 	} state=START;
 
-	//base and flagged face instances(in local space)
-	//this assumes xz vertex buffer
-	std::vector<cmn::mat4> tile_faces, flag_faces;
+	std::vector<FaceChunk> chunks;
 
 	float timer=0;
 
@@ -65,7 +95,32 @@ public:
 		num_bombs=n;
 
 		cells=new Cell[num_cells];
-		prev_cells=new Cell[num_cells];
+
+		visited.assign((num_cells+63)/64, 0);
+		for(int dk=-1, o=0; dk<=1; dk++) {
+			for(int dj=-1; dj<=1; dj++) {
+				for(int di=-1; di<=1; di++, o++) {
+					nbr_offsets[o]=di+width*(dj+height*dk);
+				}
+			}
+		}
+
+		//split into chunks
+		const int sz=FaceChunk::size;
+		chunks_x=(width+sz-1)/sz;
+		chunks_y=(height+sz-1)/sz;
+		chunks_z=(depth+sz-1)/sz;
+		chunks.resize(chunks_x*chunks_y*chunks_z);
+		for(int ci=0; ci<chunks_x; ci++) {
+			for(int cj=0; cj<chunks_y; cj++) {
+				for(int ck=0; ck<chunks_z; ck++) {
+					auto& c=chunks[ci+chunks_x*(cj+chunks_y*ck)];
+					c.i0=sz*ci, c.i1=std::min(width, c.i0+sz);
+					c.j0=sz*cj, c.j1=std::min(height, c.j0+sz);
+					c.k0=sz*ck, c.k1=std::min(depth, c.k0+sz);
+				}
+			}
+		}
 
 		reset();
 	}
@@ -108,13 +163,23 @@ public:
 	}
 
 	int getNumBombs() const { return num_bombs; }
+	int getNumFlags() const { return num_flags; }
+
+	const std::vector<int>& getSweepLog() const { return sweep_log; }
+	int getGeneration() const { return generation; }
 
 	void reset() {
 		state=START;
 
+		sweep_log.clear();
+		generation++;
+
+		num_swept_safe=0;
+		num_flags=0;
+		exploded=false;
+
 		for(int i=0; i<num_cells; i++) {
 			cells[i]=Cell{};
-			prev_cells[i]=Cell{};
 		}
 
 		//fill grid with bombs
@@ -130,34 +195,12 @@ public:
 			cells[ix(i, j, k)].bomb=true;
 		}
 
-		//for each cell
-		for(int i=0; i<width; i++) {
-			for(int j=0; j<height; j++) {
-				for(int k=0; k<depth; k++) {
-					//bomb num=-1
-					if(cells[ix(i, j, k)].bomb) continue;
+		countNeighbors();
 
-					//count neighbors
-					int num=0;
-					for(int di=-1; di<=1; di++) {
-						for(int dj=-1; dj<=1; dj++) {
-							for(int dk=-1; dk<=1; dk++) {
-								//increment if bomb
-								int ni=i+di, nj=j+dj, nk=k+dk;
-								if(inRange(ni, nj, nk)&&cells[ix(ni, nj, nk)].bomb) num++;
-							}
-						}
-					}
-
-					//set value to count.
-					cells[ix(i, j, k)].num_bombs=num;
-				}
-			}
-		}
+		//faces get rebuilt on next update
+		for(auto& c:chunks) c.dirty=true;
 
 		timer=0;
-
-		update(0);
 	}
 
 	//toggle between paused/playing...
@@ -171,7 +214,12 @@ public:
 
 		if(!inRange(i, j, k)) return;
 
-		cells[ix(i, j, k)].flagged^=true;
+		Cell& c=cells[ix(i, j, k)];
+		if(c.swept) return;
+
+		c.flagged^=true;
+		num_flags+=c.flagged?1:-1;
+		markDirty(i, j, k);
 
 		if(state==START) state=PLAYING;
 	}
@@ -183,8 +231,11 @@ public:
 
 		//unflag before sweeping.
 		Cell& c=cells[ix(i, j, k)];
-		if(c.flagged) c.flagged=false;
-		else {
+		if(c.flagged) {
+			c.flagged=false;
+			num_flags--;
+			markDirty(i, j, k);
+		} else {
 			if(state==START) {
 				//non-tedious first move:
 				//	dont explode and ensure cavity
@@ -192,28 +243,19 @@ public:
 
 				state=PLAYING;
 			} else {
-				if(c.bomb) c.swept=true;
+				if(c.bomb) sweepCell(i, j, k);
 				else if(!c.swept) floodsweep(i, j, k);
 			}
 		}
 	}
 
 	void update(float dt){
-		unflagSwept();
+		for(auto& c:chunks) {
+			if(c.dirty) updateChunk(c);
+		}
 
 		checkState();
 
-		bool changed=false;
-		for(int i=0; i<num_cells; i++) {
-			if(cells[i]!=prev_cells[i]) {
-				changed=true;
-				break;
-			}
-		}
-		if(changed) updateFaces();
-		
-		updatePrev();
-
 		if(state==PLAYING) timer+=dt;
 	}
 };
@@ -225,89 +267,184 @@ void Minesweeper::copyFrom(const Minesweeper& m) {
 	num_cells=m.num_cells;
 	cells=new Cell[num_cells];
 	std::memcpy(cells, m.cells, sizeof(Cell)*num_cells);
-	prev_cells=new Cell[num_cells];
-	std::memcpy(prev_cells, m.prev_cells, sizeof(Cell)*num_cells);
 	num_bombs=m.num_bombs;
+	sweep_log=m.sweep_log;
+	generation=m.generation;
+	num_swept_safe=m.num_swept_safe;
+	num_flags=m.num_flags;
+	exploded=m.exploded;
+	visited=m.visited;
+	std::memcpy(nbr_offsets, m.nbr_offsets, sizeof(nbr_offsets));
+	chunks_x=m.chunks_x;
+	chunks_y=m.chunks_y;
+	chunks_z=m.chunks_z;
+	chunks=m.chunks;
 	state=m.state;
-	tile_faces=m.tile_faces;
-	flag_faces=m.flag_faces;
 	timer=m.timer;
 }
 
 void Minesweeper::clear() {
 	delete[] cells;
-	delete[] prev_cells;
+}
+
+//3x3x3 sums as 3 passes of 3 along each axis
+void Minesweeper::countNeighbors() {
+	std::vector<std::uint8_t> a(num_cells), b(num_cells);
+	for(int i=0; i<num_cells; i++) a[i]=cells[i].bomb;
+
+	//x: along each row
+	for(int r=0; r<num_cells; r+=width) {
+		const std::uint8_t* src=&a[r];
+		std::uint8_t* dst=&b[r];
+		for(int i=0; i<width; i++) {
+			int s=src[i];
+			if(i>0) s+=src[i-1];
+			if(i<width-1) s+=src[i+1];
+			dst[i]=s;
+		}
+	}
+
+	//y: whole rows at once
+	for(int k=0; k<depth; k++) {
+		for(int j=0; j<height; j++) {
+			const std::uint8_t* mid=&b[ix(0, j, k)];
+			const std::uint8_t* lo=j>0?mid-width:nullptr;
+			const std::uint8_t* hi=j<height-1?mid+width:nullptr;
+			std::uint8_t* dst=&a[ix(0, j, k)];
+			for(int i=0; i<width; i++) dst[i]=mid[i];
+			if(lo) for(int i=0; i<width; i++) dst[i]+=lo[i];
+			if(hi) for(int i=0; i<width; i++) dst[i]+=hi[i];
+		}
+	}
+
+	//z: whole slices at once
+	const int slice=width*height;
+	for(int k=0; k<depth; k++) {
+		const std::uint8_t* mid=&a[slice*k];
+		std::uint8_t* dst=&b[slice*k];
+		for(int i=0; i<slice; i++) dst[i]=mid[i];
+		if(k>0) for(int i=0; i<slice; i++) dst[i]+=mid[i-slice];
+		if(k<depth-1) for(int i=0; i<slice; i++) dst[i]+=mid[i+slice];
+	}
+
+	//bomb num=-1
+	for(int i=0; i<num_cells; i++) {
+		cells[i].num_bombs=cells[i].bomb?-1:b[i];
+	}
+}
+
+void Minesweeper::sweepCell(int i, int j, int k) {
+	Cell& c=cells[ix(i, j, k)];
+	if(c.swept) return;
+
+	c.swept=true;
+	if(c.flagged) c.flagged=false, num_flags--;
+	sweep_log.push_back(ix(i, j, k));
+
+	if(c.bomb) exploded=true;
+	else num_swept_safe++;
+
+	markDirty(i, j, k);
 }
 
 //returns whether function made a cavity.
 bool Minesweeper::floodsweep(int i, int j, int k) {
 	bool flood=false;
 
-	std::stack<cmn::vi3d> to_sweep;
-	to_sweep.push({i, j, k});
+	//each cell queued at most once
+	auto visit=[&] (int c) {
+		std::uint64_t bit=1ull<<(c&63);
+		if(visited[c>>6]&bit) return false;
+		visited[c>>6]|=bit;
+		return true;
+	};
+
+	to_sweep.clear();
+	std::size_t log_st=sweep_log.size();
+	visit(ix(i, j, k));
+	to_sweep.push_back(ix(i, j, k));
 	while(to_sweep.size()) {
-		cmn::vi3d top=to_sweep.top();
-		to_sweep.pop();
-		Cell& t=cells[ix(top.x, top.y, top.z)];
+		int c=to_sweep.back();
+		to_sweep.pop_back();
+		int ci=c%width, cj=c/width%height, ck=c/(width*height);
 
-		t.swept=true;
+		sweepCell(ci, cj, ck);
 
-		if(t.num_bombs==0) {
+		if(cells[c].num_bombs==0) {
 			flood=true;
 
+			//sweep next if unswept and unflagged
+			auto tryQueue=[&] (int n) {
+				const Cell& nc=cells[n];
+				if(nc.swept||nc.flagged) return;
+
+				if(visit(n)) to_sweep.push_back(n);
+			};
+
+			//interior cells dont need range checks
+			if(ci>0&&ci<width-1&&cj>0&&cj<height-1&&ck>0&&ck<depth-1) {
+				for(int o=0; o<27; o++) tryQueue(c+nbr_offsets[o]);
+				continue;
+			}
+
 			//for each adjacent neighbor
-			for(int di=-1; di<=1; di++) {
+			for(int dk=-1; dk<=1; dk++) {
+				int nk=ck+dk;
+				if(!inRangeZ(nk)) continue;
 				for(int dj=-1; dj<=1; dj++) {
-					for(int dk=-1; dk<=1; dk++) {
-						//skip if out of range
-						cmn::vi3d next{top.x+di, top.y+dj, top.z+dk};
-						if(!inRange(next.x, next.y, next.z)) continue;
-
-						//sweep next if unswept and unflagged
-						Cell& n=cells[ix(next.x, next.y, next.z)];
-						if(!n.swept&&!n.flagged) to_sweep.push(next);
+					int nj=cj+dj;
+					if(!inRangeY(nj)) continue;
+					for(int di=-1; di<=1; di++) {
+						int ni=ci+di;
+						if(!inRangeX(ni)) continue;
+
+						tryQueue(ix(ni, nj, nk));
 					}
 				}
 			}
 		}
 	}
 
-	return flood;
-}
+	//only clear what got set
+	visited[ix(i, j, k)>>6]=0;
+	for(std::size_t l=log_st; l<sweep_log.size(); l++) {
+		visited[sweep_log[l]>>6]=0;
+	}
 
-void Minesweeper::updatePrev() {
-	std::memcpy(prev_cells, cells, sizeof(Cell)*num_cells);
+	return flood;
 }
 
 void Minesweeper::checkState() {
 	//are any bombs swept?
-	for(int i=0; i<num_cells; i++) {
-		Cell& c=cells[i];
-		if(c.bomb&&c.swept) {
-			state=LOST;
-			return;
-		}
+	if(exploded) {
+		state=LOST;
+		return;
 	}
 
 	//are all nonbombs swept?
-	for(int i=0; i<num_cells; i++) {
-		Cell& c=cells[i];
-		if(!c.bomb&&!c.swept) return;
-	}
-
-	state=WON;
+	if(num_swept_safe==num_cells-num_bombs) state=WON;
 }
 
-void Minesweeper::unflagSwept() {
-	for(int i=0; i<num_cells; i++) {
-		auto& c=cells[i];
-		if(c.flagged&&c.swept) c.flagged=false;
-	}
+//a cells faces depend on its neighbors too,
+//  but those only leave the chunk on its border.
+void Minesweeper::markDirty(int i, int j, int k) {
+	const int sz=FaceChunk::size;
+	const int ci=i/sz, cj=j/sz, ck=k/sz;
+	const int li=i-sz*ci, lj=j-sz*cj, lk=k-sz*ck;
+	const int c=ci+chunks_x*(cj+chunks_y*ck);
+	chunks[c].dirty=true;
+	if(li==0&&ci>0) chunks[c-1].dirty=true;
+	if(li==sz-1&&ci<chunks_x-1) chunks[c+1].dirty=true;
+	if(lj==0&&cj>0) chunks[c-chunks_x].dirty=true;
+	if(lj==sz-1&&cj<chunks_y-1) chunks[c+chunks_x].dirty=true;
+	if(lk==0&&ck>0) chunks[c-chunks_x*chunks_y].dirty=true;
+	if(lk==sz-1&&ck<chunks_z-1) chunks[c+chunks_x*chunks_y].dirty=true;
 }
 
-void Minesweeper::updateFaces() {
-	tile_faces.clear();
-	flag_faces.clear();
+void Minesweeper::updateChunk(FaceChunk& chunk) {
+	chunk.dirty=false;
+	chunk.tile_faces.clear();
+	chunk.flag_faces.clear();
 
 	//add matrix with new coordinate system and translation(to flag or not to flag)
 	auto addFace=[&] (const cmn::vf3d& x, const cmn::vf3d& y, const cmn::vf3d& z, const cmn::vf3d& t, bool f) {
@@ -316,8 +453,8 @@ void Minesweeper::updateFaces() {
 		m(1, 0)=x.y, m(1, 1)=y.y, m(1, 2)=z.y, m(1, 3)=t.y;
 		m(2, 0)=x.z, m(2, 1)=y.z, m(2, 2)=z.z, m(2, 3)=t.z;
 		m(3, 3)=1;
-		if(f) flag_faces.push_back(m);
-		else tile_faces.push_back(m);
+		if(f) chunk.flag_faces.push_back(m);
+		else chunk.tile_faces.push_back(m);
 	};
 
 	const cmn::vf3d x(1, 0, 0);
@@ -325,9 +462,9 @@ void Minesweeper::updateFaces() {
 	const cmn::vf3d z(0, 0, 1);
 
 	//for each cell
-	for(int i=0; i<width; i++) {
-		for(int j=0; j<height; j++) {
-			for(int k=0; k<depth; k++) {
+	for(int i=chunk.i0; i<chunk.i1; i++) {
+		for(int j=chunk.j0; j<chunk.j1; j++) {
+			for(int k=chunk.k0; k<chunk.k1; k++) {
 				//skip if swept
 				const auto& c=cells[ix(i, j, k)];
 				if(c.swept) continue;
@@ -9,6 +9,7 @@ sound
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -25,6 +26,8 @@ sound
 
 #include "minesweeper.h"
 
+#include "solver.h"
+
 #include "cmn/utils.h"
 
 #include <algorithm>
@@ -39,6 +42,10 @@ sound
 
 #include "sokol/font.h"
 
+#include "cmn/stopwatch.h"
+
+#include <iostream>
+
 //y p => x y z
 //0 0 => 0 0 1
 static cmn::vf3d polarToCartesian(float yaw, float pitch) {
@@ -168,6 +175,20 @@ class MinesweeperUI : public cmn::SokolEngine {
 
 	Minesweeper game;
 
+	//how much of the sweep log particles have seen
+	struct {
+		std::size_t log_pos=0;
+		int generation=-1;
+	} swept_render;
+
+	MinesweeperSolver solver;
+
+	struct {
+		bool show=false;
+		int i=0, j=0, k=0;
+		float risk=0;
+	} hint;
+
 	struct {
 		std::vector<Particle> debris;
 		std::vector<Particle> explosion;
@@ -298,7 +319,7 @@ public:
 	void setupLineRendering() {
 		sg_pipeline_desc pip_desc{};
 		pip_desc.layout.attrs[ATTR_line_i_pos].format=SG_VERTEXFORMAT_FLOAT3;
-		pip_desc.shader=sg_make_shader(line_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(line_shader_desc(getBackend()));
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_LINES;
 		pip_desc.index_type=SG_INDEXTYPE_UINT32;
 		pip_desc.depth.write_enabled=true;
@@ -345,7 +366,7 @@ public:
 		pip_desc.layout.attrs[ATTR_mesh_i_pos].format=SG_VERTEXFORMAT_FLOAT3;
 		pip_desc.layout.attrs[ATTR_mesh_i_norm].format=SG_VERTEXFORMAT_FLOAT3;
 		pip_desc.layout.attrs[ATTR_mesh_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(mesh_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(mesh_shader_desc(getBackend()));
 		pip_desc.index_type=SG_INDEXTYPE_UINT32;
 		pip_desc.cull_mode=SG_CULLMODE_FRONT;
 		pip_desc.depth.write_enabled=true;
@@ -379,7 +400,7 @@ public:
 		sg_pipeline_desc pip_desc{};
 		pip_desc.layout.attrs[ATTR_billboard_i_pos].format=SG_VERTEXFORMAT_FLOAT3;
 		pip_desc.layout.attrs[ATTR_billboard_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(billboard_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(billboard_shader_desc(getBackend()));
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 		//pip_desc.cull_mode=SG_CULLMODE_FRONT;
 		pip_desc.depth.write_enabled=true;
@@ -410,7 +431,7 @@ public:
 		sg_pipeline_desc pip_desc{};
 		pip_desc.layout.attrs[ATTR_colorview_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
 		pip_desc.layout.attrs[ATTR_colorview_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(colorview_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(colorview_shader_desc(getBackend()));
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 		//with alpha blending
 		pip_desc.colors[0].blend.enabled=true;
@@ -445,7 +466,7 @@ public:
 
 		sg_pipeline_desc pip_desc{};
 		pip_desc.layout.attrs[ATTR_crt_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(crt_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(crt_shader_desc(getBackend()));
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 		post_process.crt_pip=sg_make_pipeline(pip_desc);
 
@@ -470,6 +491,7 @@ public:
 		app_title="Minesweeper 3D";
 		
 		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		setupSampler();
 
@@ -507,6 +529,11 @@ public:
 	}
 
 #pragma region UPDATE HELPERS
+	vf3d cellPos(int c) const {
+		int w=game.getWidth(), h=game.getHeight();
+		return vf3d(c%w, c/w%h, c/(w*h));
+	}
+
 	void handleCameraLooking(float dt) {
 		prev_mouse_x=mouse_x;
 		prev_mouse_y=mouse_y;
@@ -545,7 +572,6 @@ public:
 		light_pos=cam.pos;
 	}
 
-	//make this use dda instead.
 	void handleCursor() {
 		//unprojection matrix
 		mat4 inv_vp=mat4::inverse(cam.view_proj);
@@ -561,27 +587,43 @@ public:
 		//normalize direction
 		vf3d mouse_dir=(world-cam.pos).norm();
 
-		//intersect ray with cells
-		float record=-1;
-		cmn::AABBf3 unit_box{{0, 0, 0}, {1, 1, 1}};
-		for(int i=0; i<game.getWidth(); i++) {
-			for(int j=0; j<game.getHeight(); j++) {
-				for(int k=0; k<game.getDepth(); k++) {
-					const auto& cell=game.cells[game.ix(i, j, k)];
-					if(cell.swept) continue;
-
-					vf3d rel=cam.pos-vf3d(i, j, k);
-					float t=unit_box.intersectRay(rel, mouse_dir);
-					if(t>0) {
-						if(record<0||t<record) {
-							record=t;
-							cursor.i=i;
-							cursor.j=j;
-							cursor.k=k;
-						}
-					}
-				}
+		//walk the cells the ray passes thru
+		const vf3d game_size(game.getWidth(), game.getHeight(), game.getDepth());
+		cmn::AABBf3 box{{0, 0, 0}, game_size};
+		float t_st=box.intersectRay(cam.pos, mouse_dir);
+		if(t_st==-1) return;
+
+		vf3d st=cam.pos+(std::max(0.f, t_st)+1e-4f)*mouse_dir;
+		const float pos[3]{st.x, st.y, st.z};
+		const float dir[3]{mouse_dir.x, mouse_dir.y, mouse_dir.z};
+		const int size[3]{game.getWidth(), game.getHeight(), game.getDepth()};
+		int cell[3], step[3];
+		float t_max[3], t_delta[3];
+		for(int a=0; a<3; a++) {
+			cell[a]=std::max(0, std::min(size[a]-1, int(pos[a])));
+			step[a]=dir[a]>0?1:-1;
+			if(dir[a]==0) {
+				t_max[a]=t_delta[a]=INFINITY;
+				continue;
 			}
+			float next=cell[a]+(dir[a]>0?1:0);
+			t_max[a]=(next-pos[a])/dir[a];
+			t_delta[a]=std::abs(1/dir[a]);
+		}
+
+		while(game.inRange(cell[0], cell[1], cell[2])) {
+			if(!game.cells[game.ix(cell[0], cell[1], cell[2])].swept) {
+				cursor.i=cell[0];
+				cursor.j=cell[1];
+				cursor.k=cell[2];
+				return;
+			}
+
+			//step along whichever boundary is closest
+			int a=t_max[0]<t_max[1]?0:1;
+			if(t_max[2]<t_max[a]) a=2;
+			cell[a]+=step[a];
+			t_max[a]+=t_delta[a];
 		}
 	}
 
@@ -623,36 +665,98 @@ public:
 		}
 	}
 
+	//auto-play games w/o rendering anything
+	void benchmarkSolver() {
+		struct Config { int w, h, d, bombs, games; };
+		const Config configs[]{
+			{7, 5, 8, 20, 2000},
+			{10, 10, 10, 50, 1000},
+			{10, 10, 10, 120, 300},
+			{20, 20, 20, 400, 100},
+			{100, 100, 100, 50000, 1}
+		};
+
+		std::cout<<"solver benchmark:\n";
+		cmn::Stopwatch watch;
+		for(const auto& cfg:configs) {
+			int won=0;
+			long long moves=0, guesses=0, solver_us=0;
+			for(int g=0; g<cfg.games; g++) {
+				Minesweeper m(cfg.w, cfg.h, cfg.d, cfg.bombs);
+				MinesweeperSolver s;
+				while(true) {
+					watch.start();
+					s.observe(m);
+					MinesweeperSolver::Hint h;
+					bool found=s.getHint(h);
+					watch.stop();
+					solver_us+=watch.getMicros();
+					if(!found) break;
+
+					moves++;
+					if(h.risk>0) guesses++;
+					m.sweep(h.i, h.j, h.k);
+					if(m.cells[m.ix(h.i, h.j, h.k)].bomb) break;
+				}
+				s.observe(m);
+				if(s.getNumSwept()+cfg.bombs==m.getNumCells()) won++;
+			}
+			std::cout<<"  "<<cfg.w<<'x'<<cfg.h<<'x'<<cfg.d<<", "<<cfg.bombs<<" bombs: "
+				<<(100.f*won/cfg.games)<<"% solved, "
+				<<(float(guesses)/cfg.games)<<" guesses/game, "
+				<<(float(solver_us)/std::max(1ll, moves))<<" us/move\n";
+		}
+	}
+
 	void handleGame(float dt) {
-		if(GetKey(SAPP_KEYCODE_R).pressed) game.reset();
+		if(GetKey(SAPP_KEYCODE_R).pressed) game.reset(), hint.show=false;
 
 		if(GetKey(SAPP_KEYCODE_P).pressed) game.pause();
 
-		if(GetKey(SAPP_KEYCODE_SPACE).pressed) game.sweep(cursor.i, cursor.j, cursor.k);
+		if(GetKey(SAPP_KEYCODE_SPACE).pressed) game.sweep(cursor.i, cursor.j, cursor.k), hint.show=false;
 
 		if(GetKey(SAPP_KEYCODE_F).pressed) game.flag(cursor.i, cursor.j, cursor.k);
 
-		//find changes from prev->curr
-		for(int i=0; i<game.getWidth(); i++) {
-			for(int j=0; j<game.getHeight(); j++) {
-				for(int k=0; k<game.getDepth(); k++) {
-					vf3d ctr=.5f+vf3d(i, j, k);
-
-					int ix=game.ix(i, j, k);
-					const auto& prev=game.prev_cells[ix];
-					const auto& curr=game.cells[ix];
-					if(curr.swept&&!prev.swept) {
-						//swept a cell
-						spawnDebris(ctr);
-						if(curr.bomb) {
-							//swept a bomb
-							spawnExplosion(ctr);
-						}
-					}
-				}
+		//show or play the safest move
+		bool show_hint=GetKey(SAPP_KEYCODE_H).pressed;
+		bool auto_play=GetKey(SAPP_KEYCODE_G).pressed;
+		if((show_hint||auto_play)&&(game.state==Minesweeper::START||game.state==Minesweeper::PLAYING)) {
+			solver.observe(game);
+			MinesweeperSolver::Hint h;
+			if(solver.getHint(h)) {
+				hint.i=h.i, hint.j=h.j, hint.k=h.k;
+				hint.risk=h.risk;
+				hint.show=show_hint;
+				if(h.risk>0) std::cout<<"no sure move, "<<int(100*h.risk)<<"% risk\n";
+				if(auto_play) game.sweep(h.i, h.j, h.k);
 			}
 		}
 
+		if(GetKey(SAPP_KEYCODE_B).pressed) benchmarkSolver();
+
+		//cells swept since last frame
+		if(swept_render.generation!=game.getGeneration()) {
+			swept_render.generation=game.getGeneration();
+			swept_render.log_pos=0;
+		}
+		const auto& log=game.getSweepLog();
+		//big floods only get debris on the last few
+		const std::size_t max_debris=512;
+		std::size_t st=swept_render.log_pos;
+		if(log.size()-st>max_debris) st=log.size()-max_debris;
+		for(std::size_t l=st; l<log.size(); l++) {
+			int c=log[l];
+			vf3d ctr=.5f+cellPos(c);
+
+			//swept a cell
+			spawnDebris(ctr);
+			if(game.cells[c].bomb) {
+				//swept a bomb
+				spawnExplosion(ctr);
+			}
+		}
+		swept_render.log_pos=log.size();
+
 		game.update(dt);
 	}
 
@@ -765,8 +869,10 @@ public:
 			sg_draw(0, 3*face_mesh.tris.size(), 1);
 		};
 
-		for(const auto& t:game.tile_faces) renderFace(t, textures.tile);
-		for(const auto& f:game.flag_faces) renderFace(f, textures.flag);
+		for(const auto& c:game.chunks) {
+			for(const auto& t:c.tile_faces) renderFace(t, textures.tile);
+			for(const auto& f:c.flag_faces) renderFace(f, textures.flag);
+		}
 	}
 
 	sg_color getCellColor(int num_bombs) {
@@ -798,41 +904,34 @@ public:
 			));
 		};
 
-		//for each cell
-		for(int i=0; i<game.getWidth(); i++) {
-			for(int j=0; j<game.getHeight(); j++) {
-				for(int k=0; k<game.getDepth(); k++) {
-					//skip unswept
-					const auto& cell=game.cells[game.ix(i, j, k)];
-					if(!cell.swept) continue;
-
-					vf3d ctr=.5f+vf3d(i, j, k);
-
-					if(cell.bomb) {
-						billboard_render.instances.push_back(Billboard(
-							ctr, .6f, .5f, .5f,
-							textures.bomb, 0, 0, 1, 1,
-							{1, 1, 1, 1}
-						));
-						continue;
-					}
-
-					//skip empties
-					if(cell.num_bombs==0) continue;
-
-					//display 2or1 digit number
-					int tens=cell.num_bombs/10;
-					int ones=cell.num_bombs%10;
-					
-					//center anchoring if 2 digit
-					sg_color col=getCellColor(cell.num_bombs);
-					if(tens) {
-						addNumber(ctr, .3f, 1, .5f, tens, col);
-						addNumber(ctr, .3f, 0, .5f, ones, col);
-					} else {
-						addNumber(ctr, .4f, .5f, .5f, ones, col);
-					}
-				}
+		//only swept cells show anything
+		for(const auto& c:game.getSweepLog()) {
+			const auto& cell=game.cells[c];
+			vf3d ctr=.5f+cellPos(c);
+
+			if(cell.bomb) {
+				billboard_render.instances.push_back(Billboard(
+					ctr, .6f, .5f, .5f,
+					textures.bomb, 0, 0, 1, 1,
+					{1, 1, 1, 1}
+				));
+				continue;
+			}
+
+			//skip empties
+			if(cell.num_bombs==0) continue;
+
+			//display 2or1 digit number
+			int tens=cell.num_bombs/10;
+			int ones=cell.num_bombs%10;
+			
+			//center anchoring if 2 digit
+			sg_color col=getCellColor(cell.num_bombs);
+			if(tens) {
+				addNumber(ctr, .3f, 1, .5f, tens, col);
+				addNumber(ctr, .3f, 0, .5f, ones, col);
+			} else {
+				addNumber(ctr, .4f, .5f, .5f, ones, col);
 			}
 		}
 	}
@@ -1040,10 +1139,7 @@ public:
 
 		//bomb count
 		{
-			int remaining=game.getNumBombs();
-			for(int i=0; i<game.getNumCells(); i++) {
-				if(game.cells[i].flagged) remaining--;
-			}
+			int remaining=game.getNumBombs()-game.getNumFlags();
 			auto str=std::to_string(remaining);
 			float x=sapp_widthf()-scl*font.char_w*str.length();
 			renderString(x, y, str, scl);
@@ -1120,6 +1216,13 @@ public:
 
 			renderCursor();
 
+			//green if sure
+			if(hint.show) {
+				vf3d pos(hint.i, hint.j, hint.k);
+				sg_color col=hint.risk>0?sg_color{1, .6f, 0, 1}:sg_color{0, 1, 0, 1};
+				renderAABB(pos, pos+1, col);
+			}
+
 			realizeNumberBillboards();
 			realizeParticleBillboards();
 			renderBillboards();
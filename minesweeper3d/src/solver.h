@@ -0,0 +1,538 @@
+#pragma once
+#ifndef MINESWEEPER_SOLVER_CLASS_H
+#define MINESWEEPER_SOLVER_CLASS_H
+
+#include "minesweeper.h"
+
+//for Random
+#include "cmn/random.h"
+
+//for uint32_t
+#include <cstdint>
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int popCount(std::uint32_t x) {
+#ifdef _MSC_VER
+	return __popcnt(x);
+#else
+	return __builtin_popcount(x);
+#endif
+}
+
+//index of lowest set bit, x!=0
+static int lowestBit(std::uint32_t x) {
+#ifdef _MSC_VER
+	unsigned long i;
+	_BitScanForward(&i, x);
+	return i;
+#else
+	return __builtin_ctz(x);
+#endif
+}
+
+//only sees what a player would: swept cells & their numbers.
+//  each number keeps a 27 bit mask of its unknown neighbors
+//  & how many of those are mines. single cell & pair
+//  deductions run on whatever changed since the last sweep.
+//  when those run dry, frontier components are enumerated
+//  for mine odds & the safest cell gets picked.
+class MinesweeperSolver {
+	int width=0, height=0, depth=0;
+	int num_cells=0, num_bombs=0;
+
+	enum : std::uint8_t {
+		UNKNOWN=0,
+		SAFE,//deduced, not swept yet
+		MINE,
+		SWEPT
+	};
+	std::vector<std::uint8_t> status;
+
+	//for swept cells
+	std::vector<std::uint32_t> unknown_mask;
+	std::vector<std::int8_t> remaining;
+
+	//bit b is neighbor (b%3-1, b/3%3-1, b/9-1)
+	int offsets[27];
+	//bits of a mask that stay in frame when moved by d,
+	//  d is (dx+2)+5(dy+2)+25(dz+2)
+	std::uint32_t shift_valid[125];
+
+	//sure safe cells left to sweep
+	std::vector<int> safe_queue;
+	std::size_t safe_pos=0;
+
+	//numbers whose masks changed
+	std::vector<int> work;
+	std::vector<bool> in_work;
+
+	//numbers that might still have unknowns
+	std::vector<int> frontier;
+	std::vector<bool> in_frontier;
+
+	int num_swept=0, num_mines_known=0;
+
+	std::size_t log_pos=0;
+	int generation=-1;
+
+	//enumeration scratch
+	std::vector<int> var_of;
+	std::vector<int> vars, var_parent;
+	std::vector<int> cons, con_start, con_vars;
+	std::vector<int> var_start, var_cons, var_fill;
+	std::vector<int> comp_vars, comp_order;
+	std::vector<std::int8_t> assign;
+	std::vector<int> con_mines, con_open;
+	std::vector<double> mine_count;
+	std::vector<float> probs;
+	std::vector<bool> comp_done;
+	long long num_nodes=0;
+
+	static const long long max_nodes=200000;
+
+	void coords(int c, int& i, int& j, int& k) const {
+		i=c%width;
+		j=c/width%height;
+		k=c/(width*height);
+	}
+
+	//move a mask from a cell's frame to one d away
+	std::uint32_t translate(std::uint32_t m, int dx, int dy, int dz) const {
+		int s=dx+3*dy+9*dz;
+		std::uint32_t t=s>=0?m<<s:m>>-s;
+		return t&shift_valid[(dx+2)+5*(dy+2)+25*(dz+2)];
+	}
+
+	template<typename F>
+	void forEachNeighbor(int c, F f) const {
+		int i, j, k;
+		coords(c, i, j, k);
+		for(int b=0; b<27; b++) {
+			if(b==13) continue;
+
+			int ni=i+b%3-1, nj=j+b/3%3-1, nk=k+b/9-1;
+			if(ni<0||ni>=width||nj<0||nj>=height||nk<0||nk>=depth) continue;
+
+			f(c+offsets[b], b);
+		}
+	}
+
+	void pushWork(int c) {
+		if(in_work[c]) return;
+
+		in_work[c]=true;
+		work.push_back(c);
+	}
+
+	//c leaves the unknowns of every number around it
+	void resolve(int c, bool mine) {
+		forEachNeighbor(c, [&] (int n, int b) {
+			if(status[n]!=SWEPT) return;
+
+			unknown_mask[n]&=~(1u<<(26-b));
+			if(mine) remaining[n]--;
+			pushWork(n);
+		});
+	}
+
+	void markSafe(int c) {
+		if(status[c]!=UNKNOWN) return;
+
+		status[c]=SAFE;
+		safe_queue.push_back(c);
+		resolve(c, false);
+	}
+
+	void markMine(int c) {
+		if(status[c]!=UNKNOWN) return;
+
+		status[c]=MINE;
+		num_mines_known++;
+		resolve(c, true);
+	}
+
+	void markBits(int c, std::uint32_t m, bool mine) {
+		for(; m; m&=m-1) {
+			int n=c+offsets[lowestBit(m)];
+			if(mine) markMine(n);
+			else markSafe(n);
+		}
+	}
+
+	void reveal(int c, int num) {
+		if(status[c]==SWEPT) return;
+
+		//a bomb: nothing more to learn
+		if(num<0) {
+			if(status[c]==UNKNOWN) markMine(c);
+			return;
+		}
+
+		if(status[c]==UNKNOWN) resolve(c, false);
+		status[c]=SWEPT;
+		num_swept++;
+
+		std::uint32_t m=0;
+		int mines=0;
+		forEachNeighbor(c, [&] (int n, int b) {
+			if(status[n]==UNKNOWN) m|=1u<<b;
+			else if(status[n]==MINE) mines++;
+		});
+		unknown_mask[c]=m;
+		remaining[c]=num-mines;
+		if(m) {
+			pushWork(c);
+			if(!in_frontier[c]) {
+				in_frontier[c]=true;
+				frontier.push_back(c);
+			}
+		}
+	}
+
+	//every other number overlapping a's neighborhood
+	void deducePairs(int a) {
+		int i, j, k;
+		coords(a, i, j, k);
+		for(int dz=-2; dz<=2; dz++) {
+			int nk=k+dz;
+			if(nk<0||nk>=depth) continue;
+			for(int dy=-2; dy<=2; dy++) {
+				int nj=j+dy;
+				if(nj<0||nj>=height) continue;
+				for(int dx=-2; dx<=2; dx++) {
+					int ni=i+dx;
+					if(ni<0||ni>=width) continue;
+					if(!dx&&!dy&&!dz) continue;
+
+					int b=a+dx+width*dy+width*height*dz;
+					if(status[b]!=SWEPT||!unknown_mask[b]) continue;
+
+					std::uint32_t ma=unknown_mask[a], mb=unknown_mask[b];
+					if(!ma) return;
+
+					//both in a's frame & in b's
+					std::uint32_t mb_a=translate(mb, dx, dy, dz);
+					std::uint32_t ma_b=translate(ma, -dx, -dy, -dz);
+					if(!(ma&mb_a)) continue;
+
+					std::uint32_t only_a=ma&~mb_a, only_b=mb&~ma_b;
+					int n_only_a=popCount(only_a), n_only_b=popCount(only_b);
+					int ra=remaining[a], rb=remaining[b];
+					if(rb-ra==n_only_b&&(n_only_a||n_only_b)) {
+						markBits(b, only_b, true);
+						markBits(a, only_a, false);
+					} else if(ra-rb==n_only_a&&(n_only_a||n_only_b)) {
+						markBits(a, only_a, true);
+						markBits(b, only_b, false);
+					}
+				}
+			}
+		}
+	}
+
+	void propagate() {
+		while(work.size()) {
+			int c=work.back();
+			work.pop_back();
+			in_work[c]=false;
+
+			std::uint32_t m=unknown_mask[c];
+			if(!m) continue;
+
+			int r=remaining[c];
+			if(r==0) markBits(c, m, false);
+			else if(r==popCount(m)) markBits(c, m, true);
+			else deducePairs(c);
+		}
+	}
+
+#pragma region PROBABILITY
+	int findRoot(int v) {
+		while(var_parent[v]!=v) {
+			var_parent[v]=var_parent[var_parent[v]];
+			v=var_parent[v];
+		}
+		return v;
+	}
+
+	//count mines per var over every consistent assignment
+	bool enumerate(int d, double& total) {
+		if(++num_nodes>max_nodes) return false;
+
+		if(d==(int)comp_order.size()) {
+			total++;
+			for(const auto& v:comp_order) mine_count[v]+=assign[v];
+			return true;
+		}
+
+		int v=comp_order[d];
+		for(int a=0; a<=1; a++) {
+			bool ok=true;
+			for(int e=var_start[v]; e<var_start[v+1]; e++) {
+				int q=var_cons[e];
+				con_open[q]--;
+				con_mines[q]+=a;
+				int r=remaining[cons[q]];
+				if(con_mines[q]>r||con_mines[q]+con_open[q]<r) ok=false;
+			}
+			assign[v]=a;
+			bool within=!ok||enumerate(d+1, total);
+			for(int e=var_start[v]; e<var_start[v+1]; e++) {
+				int q=var_cons[e];
+				con_open[q]++;
+				con_mines[q]-=a;
+			}
+			if(!within) return false;
+		}
+		return true;
+	}
+
+	//mine odds of every frontier unknown, plus one for the rest.
+	//  components too big to enumerate use their worst number.
+	int pickGuess(float& prob) {
+		//drop settled numbers
+		std::size_t live=0;
+		for(const auto& c:frontier) {
+			if(unknown_mask[c]) frontier[live++]=c;
+			else in_frontier[c]=false;
+		}
+		frontier.resize(live);
+
+		vars.clear(), cons.clear();
+		con_start.assign(1, 0), con_vars.clear();
+		for(const auto& c:frontier) {
+			cons.push_back(c);
+			markBitsAsVars(c, unknown_mask[c]);
+			con_start.push_back(con_vars.size());
+		}
+		const int n_vars=vars.size(), n_cons=cons.size();
+
+		//var -> constraints
+		var_start.assign(n_vars+1, 0);
+		for(const auto& v:con_vars) var_start[v+1]++;
+		for(int v=0; v<n_vars; v++) var_start[v+1]+=var_start[v];
+		var_cons.resize(con_vars.size());
+		var_fill.assign(var_start.begin(), var_start.end()-1);
+		for(int q=0; q<n_cons; q++) {
+			for(int e=con_start[q]; e<con_start[q+1]; e++) var_cons[var_fill[con_vars[e]]++]=q;
+		}
+
+		//components thru shared numbers
+		var_parent.resize(n_vars);
+		for(int v=0; v<n_vars; v++) var_parent[v]=v;
+		for(int q=0; q<n_cons; q++) {
+			int r0=findRoot(con_vars[con_start[q]]);
+			for(int e=con_start[q]+1; e<con_start[q+1]; e++) {
+				int r=findRoot(con_vars[e]);
+				if(r!=r0) var_parent[r]=r0;
+			}
+		}
+
+		mine_count.assign(n_vars, 0);
+		assign.assign(n_vars, 0);
+		con_mines.assign(n_cons, 0);
+		con_open.resize(n_cons);
+		for(int q=0; q<n_cons; q++) con_open[q]=con_start[q+1]-con_start[q];
+
+		probs.assign(n_vars, 0);
+		comp_done.assign(n_vars, false);
+		double expected=0;
+		for(int v0=0; v0<n_vars; v0++) {
+			int root=findRoot(v0);
+			if(comp_done[root]) continue;
+			comp_done[root]=true;
+
+			//constraint adjacent order prunes early
+			comp_order.clear();
+			for(int q=0; q<n_cons; q++) {
+				int e0=con_start[q];
+				if(findRoot(con_vars[e0])!=root) continue;
+				for(int e=e0; e<con_start[q+1]; e++) {
+					int v=con_vars[e];
+					if(!assign[v]) assign[v]=2, comp_order.push_back(v);
+				}
+			}
+			for(const auto& v:comp_order) assign[v]=0;
+
+			num_nodes=0;
+			double total=0;
+			if(enumerate(0, total)&&total>0) {
+				for(const auto& v:comp_order) probs[v]=mine_count[v]/total;
+			} else {
+				for(const auto& v:comp_order) {
+					float worst=0;
+					for(int e=var_start[v]; e<var_start[v+1]; e++) {
+						int c=cons[var_cons[e]];
+						worst=std::max(worst, float(remaining[c])/popCount(unknown_mask[c]));
+					}
+					probs[v]=worst;
+				}
+			}
+			for(const auto& v:comp_order) expected+=probs[v];
+		}
+
+		//certain ones count as deductions
+		bool found=false;
+		for(int v=0; v<n_vars; v++) {
+			if(probs[v]<=0) markSafe(vars[v]), found=true;
+			else if(probs[v]>=1) markMine(vars[v]), found=true;
+		}
+
+		int best=-1;
+		prob=2;
+		if(!found) {
+			for(int v=0; v<n_vars; v++) {
+				if(probs[v]<prob) prob=probs[v], best=vars[v];
+			}
+
+			//everything else shares whats left
+			int n_interior=num_cells-num_swept-num_mines_known-n_vars;
+			n_interior-=int(safe_queue.size()-safe_pos);
+			if(n_interior>0) {
+				//only an estimate, so never sure
+				float p=(num_bombs-num_mines_known-expected)/n_interior;
+				p=std::max(1e-3f, std::min(1.f, p));
+				if(p<prob) {
+					int c=findInterior();
+					if(c!=-1) prob=p, best=c;
+				}
+			}
+		}
+
+		for(const auto& v:vars) var_of[v]=-1;
+		return best;
+	}
+
+	void markBitsAsVars(int c, std::uint32_t m) {
+		for(; m; m&=m-1) {
+			int n=c+offsets[lowestBit(m)];
+			if(var_of[n]==-1) {
+				var_of[n]=vars.size();
+				vars.push_back(n);
+			}
+			con_vars.push_back(var_of[n]);
+		}
+	}
+
+	//unknown w/ no swept neighbors, random first
+	int findInterior() const {
+		auto isInterior=[&] (int c) {
+			if(status[c]!=UNKNOWN||var_of[c]!=-1) return false;
+			bool inside=true;
+			forEachNeighbor(c, [&] (int n, int) {
+				if(status[n]==SWEPT) inside=false;
+			});
+			return inside;
+		};
+		for(int t=0; t<64; t++) {
+			int c=cmn::Random::local().nextInt(0, num_cells-1);
+			if(isInterior(c)) return c;
+		}
+		for(int c=0; c<num_cells; c++) {
+			if(isInterior(c)) return c;
+		}
+		return -1;
+	}
+#pragma endregion
+
+public:
+	struct Hint {
+		int i=0, j=0, k=0;
+		//0 if sure
+		float risk=0;
+	};
+
+	MinesweeperSolver() {
+		for(int i=0; i<125; i++) {
+			int dx=i%5-2, dy=i/5%5-2, dz=i/25-2;
+			std::uint32_t m=0;
+			for(int b=0; b<27; b++) {
+				int x=b%3-1-dx, y=b/3%3-1-dy, z=b/9-1-dz;
+				if(x>=-1&&x<=1&&y>=-1&&y<=1&&z>=-1&&z<=1) m|=1u<<b;
+			}
+			shift_valid[i]=m;
+		}
+	}
+
+	void reset(const Minesweeper& game) {
+		width=game.getWidth();
+		height=game.getHeight();
+		depth=game.getDepth();
+		num_cells=game.getNumCells();
+		num_bombs=game.getNumBombs();
+		for(int b=0; b<27; b++) {
+			offsets[b]=(b%3-1)+width*(b/3%3-1)+width*height*(b/9-1);
+		}
+
+		status.assign(num_cells, UNKNOWN);
+		unknown_mask.assign(num_cells, 0);
+		remaining.assign(num_cells, 0);
+		in_work.assign(num_cells, false);
+		in_frontier.assign(num_cells, false);
+		var_of.assign(num_cells, -1);
+		work.clear(), frontier.clear();
+		safe_queue.clear(), safe_pos=0;
+		num_swept=0, num_mines_known=0;
+
+		log_pos=0;
+		generation=game.getGeneration();
+	}
+
+	//catch up on newly swept cells
+	void observe(const Minesweeper& game) {
+		if(game.getGeneration()!=generation||game.getNumCells()!=num_cells) reset(game);
+
+		const auto& log=game.getSweepLog();
+		for(; log_pos<log.size(); log_pos++) {
+			int c=log[log_pos];
+			reveal(c, game.cells[c].bomb?-1:game.cells[c].num_bombs);
+		}
+		propagate();
+	}
+
+	bool isKnownMine(int i, int j, int k) const {
+		return status[i+width*j+width*height*k]==MINE;
+	}
+
+	int getNumSwept() const { return num_swept; }
+
+	//a sure safe cell if there is one, else the least risky.
+	//  false once theres nothing left to sweep.
+	bool getHint(Hint& h) {
+		if(!num_cells) return false;
+
+		//sure safe cells can get swept by a flood in the meantime
+		for(; safe_pos<safe_queue.size(); safe_pos++) {
+			int c=safe_queue[safe_pos];
+			if(status[c]==SAFE) {
+				coords(c, h.i, h.j, h.k);
+				h.risk=0;
+				return true;
+			}
+		}
+
+		if(num_swept==0) {
+			h.i=width/2, h.j=height/2, h.k=depth/2;
+			h.risk=float(num_bombs)/num_cells;
+			return true;
+		}
+		if(num_swept+num_bombs>=num_cells) return false;
+
+		float prob;
+		int c=pickGuess(prob);
+		propagate();
+		//enumeration settled something
+		if(safe_pos<safe_queue.size()) return getHint(h);
+		if(c==-1) return false;
+
+		coords(c, h.i, h.j, h.k);
+		h.risk=prob;
+		return true;
+	}
+};
+#endif
\ No newline at end of file
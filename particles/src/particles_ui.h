@@ -4,6 +4,7 @@
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -14,6 +15,10 @@
 
 #include "solver.h"
 
+#include "cmn/stopwatch.h"
+
+#include <iostream>
+
 //for uint32_t
 #include <cstdint>
 
@@ -109,7 +114,7 @@ public:
 	void setupLineRender() {
 		//instanced tristrip pipeline
 		sg_pipeline_desc pip_desc{};
-		pip_desc.shader=sg_make_shader(line_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(line_shader_desc(getBackend()));
 		pip_desc.layout.attrs[ATTR_line_i_t].format=SG_VERTEXFORMAT_FLOAT;
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_LINES;
 		line_render.pip=sg_make_pipeline(pip_desc);
@@ -124,7 +129,7 @@ public:
 	void setupParticleRender() {
 		//instanced tristrip pipeline
 		sg_pipeline_desc pip_desc{};
-		pip_desc.shader=sg_make_shader(quad_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(quad_shader_desc(getBackend()));
 		pip_desc.layout.buffers[1].step_func=SG_VERTEXSTEP_PER_INSTANCE;
 		pip_desc.layout.attrs[ATTR_quad_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
 		pip_desc.layout.attrs[ATTR_quad_i_uv].buffer_index=0;
@@ -270,15 +275,19 @@ public:
 	void handleParticleAddition() {
 		adding=GetKey(SAPP_KEYCODE_A).held;
 		if(adding) {
+			//dist, angle, rad, r, g, b per particle
+			float rnd[6*100];
+			cmn::Random::local().fill(rnd, 6*100);
 			for(int i=0; i<100; i++) {
-				float dist=cmn::randFloat(selection_radius);
-				float angle=cmn::randFloat(2*cmn::Pi);
+				const float* r=rnd+6*i;
+				float dist=selection_radius*r[0];
+				float angle=2*cmn::Pi*r[1];
 				vf2d offset=cmn::polar<vf2d>(dist, angle);
-				float rad=cmn::randFloat(2, 4);
+				float rad=2+2*r[2];
 				Particle p(scr2wld(mouse_scr+offset), rad);
-				p.r=cmn::randFloat();
-				p.g=cmn::randFloat();
-				p.b=cmn::randFloat();
+				p.r=r[3];
+				p.g=r[4];
+				p.b=r[5];
 				solver.addParticle(p);
 			}
 		}
@@ -402,12 +411,79 @@ public:
 
 		//constraint render toggle
 		if(GetKey(SAPP_KEYCODE_C).pressed) render_constraints^=true;
+
+		if(GetKey(SAPP_KEYCODE_B).pressed) benchmarkCollisions();
+	}
+
+	//times collision passes on the current scene w/ 1..N threads
+	void benchmarkCollisions() {
+		const int num_steps=60;
+		int max_threads=std::thread::hardware_concurrency();
+		if(max_threads<1) max_threads=1;
+
+		std::cout<<"collisions: "<<solver.getNumParticles()<<" particles, "<<num_steps<<" passes\n";
+		double base_ms=0;
+		for(int n=1; n<=max_threads; n++) {
+			cmn::ThreadPool p(n);
+			Solver test=solver;
+			test.pool=&p;
+			test.updateSizing();
+
+			cmn::Stopwatch watch;
+			watch.start();
+			for(int i=0; i<num_steps; i++) test.solveCollisions();
+			watch.stop();
+
+			//should match for every thread count
+			double checksum=0;
+			for(int i=0; i<test.getNumParticles(); i++) {
+				checksum+=test.particles[i].pos.x+test.particles[i].pos.y;
+			}
+
+			double ms=watch.getMicros()/1000.;
+			if(n==1) base_ms=ms;
+			std::cout<<"  "<<n<<" threads: "<<ms<<" ms, "
+				<<base_ms/ms<<"x, checksum "<<checksum<<'\n';
+		}
+
+		checkDeterministicDraws(max_threads);
+	}
+
+	//deterministic pools should give every chunk
+	//  the same random numbers run after run
+	void checkDeterministicDraws(int max_threads) {
+		const int num=1<<14, grain=64;
+		std::vector<std::uint32_t> draws(num);
+
+		bool same=true;
+		for(int n=1; n<=max_threads; n++) {
+			std::uint64_t hashes[2];
+			for(int run=0; run<2; run++) {
+				//before the pool, so workers take their streams from it
+				cmn::Random::seedAll(cmn::Random::default_seed);
+				cmn::ThreadPool p(n);
+				p.deterministic=true;
+				p.parallelFor(0, num, grain, [&] (int i0, int i1) {
+					for(int i=i0; i<i1; i++) draws[i]=cmn::Random::local().next();
+				});
+
+				//fnv-1a
+				std::uint64_t h=14695981039346656037ull;
+				for(const auto& d:draws) h=(h^d)*1099511628211ull;
+				hashes[run]=h;
+			}
+			if(hashes[0]!=hashes[1]) same=false;
+		}
+		std::cout<<"deterministic draws: "<<(same?"same":"different")
+			<<" across runs w/ 1.."<<max_threads<<" threads\n";
 	}
 
 	void handlePhysics(float dt) {
 		//ensure similar update across multiple framerates
 		update_timer+=dt;
 		while(update_timer>time_step) {
+			CMN_PROFILE_ZONE("physics step");
+
 			solver.updateSizing();
 
 			solver.accelerate(gravity);
@@ -580,6 +656,7 @@ public:
 		ImGui::Text("Drag E to add an empty rect");
 		ImGui::Text("Drag LMB to grab particles");
 		ImGui::Text("Use SPACE to play/pause");
+		ImGui::Text("Press B to benchmark collisions");
 		ImGui::End();
 
 		ImGui::Begin("Graphics");
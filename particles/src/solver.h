@@ -4,6 +4,10 @@
 
 #include "particle.h"
 
+#include "cmn/profiler.h"
+
+#include "cmn/thread_pool.h"
+
 #include <list>
 
 #include <vector>
@@ -25,10 +29,7 @@ struct Constraint {
 //fisher-yates shuffle
 template<typename T>
 void shuffle(std::vector<T>& vec) {
-	for(int i=vec.size()-1; i>=1; i--) {
-		int j=std::rand()%(i+1);
-		std::swap(vec[i], vec[j]);
-	}
+	cmn::Random::local().shuffle(vec.data(), vec.size());
 }
 
 class Solver {
@@ -51,10 +52,15 @@ class Solver {
 
 	void collideCells(int, int, int, int);
 
+	void collideStrip(int);
+
 public:
 	Particle* particles=nullptr;
 	std::list<Constraint> constraints;
 
+	//null uses the shared pool
+	cmn::ThreadPool* pool=nullptr;
+
 	Solver() {}
 
 	Solver(int m, const cmn::vf2d& n, const cmn::vf2d& x) {
@@ -105,6 +111,9 @@ public:
 
 	int ix(int i, int j) const { return i+num_x*j; }
 
+	//columns per collision task
+	static const int strip_width=2;
+
 	//index of insertion
 	int addParticle(const Particle& p) {
 		//not enough space?
@@ -262,6 +271,8 @@ public:
 	}
 
 	void updateConsraints() {
+		CMN_PROFILE_ZONE("Solver::updateConstraints");
+
 		for(const auto& c:constraints) {
 			auto& a=particles[c.a];
 			auto& b=particles[c.b];
@@ -310,27 +321,26 @@ public:
 	}
 
 	void solveCollisions() {
-		fillCells();
+		CMN_PROFILE_ZONE("Solver::solveCollisions");
 
-		//check self & half of neighbors to avoid redundancy
-		const int di[5]{0, 1, -1, 0, 1};
-		const int dj[5]{0, 0, 1, 1, 1};
-
-		//for each cell
-		for(int i=0; i<num_x; i++) {
-			for(int j=0; j<num_y; j++) {
-				for(int d=0; d<5; d++) {
-					//skip if out of range
-					int ci=i+di[d], cj=j+dj[d];
-					if(!inRangeX(ci)||!inRangeY(cj)) continue;
+		fillCells();
 
-					collideCells(i, j, ci, cj);
-				}
-			}
+		//strips of 2 columns only reach 1 column to each side,
+		//  so every other strip can run at the same time.
+		//  same result for any number of threads.
+		cmn::ThreadPool& p=pool?*pool:cmn::ThreadPool::shared();
+		const int num_strips=(num_x+strip_width-1)/strip_width;
+		for(int phase=0; phase<2; phase++) {
+			const int num_phase=(num_strips-phase+1)/2;
+			p.parallelFor(0, num_phase, 1, [&] (int s0, int s1) {
+				for(int s=s0; s<s1; s++) collideStrip(phase+2*s);
+			});
 		}
 	}
 
 	void accelerate(const cmn::vf2d& a) {
+		CMN_PROFILE_ZONE("Solver::accelerate");
+
 		for(int i=0; i<num_particles; i++) {
 			auto& p=particles[i];
 			p.applyForce(p.getMass()*a);
@@ -338,6 +348,8 @@ public:
 	}
 
 	void integrateParticles(float dt) {
+		CMN_PROFILE_ZONE("Solver::integrateParticles");
+
 		for(int i=0; i<num_particles; i++) {
 			auto& p=particles[i];
 
@@ -482,6 +494,7 @@ void Solver::copyFrom(const Solver& s) {
 	particles=new Particle[max_particles];
 	std::memcpy(particles, s.particles, sizeof(Particle)*num_particles);
 	constraints=s.constraints;
+	pool=s.pool;
 }
 
 void Solver::clear() {
@@ -492,6 +505,8 @@ void Solver::clear() {
 }
 
 void Solver::fillCells() {
+	CMN_PROFILE_ZONE("Solver::fillCells");
+
 	//reset grid heads
 	std::memset(grid_heads, -1, sizeof(int)*num_x*num_y);
 
@@ -511,6 +526,26 @@ void Solver::fillCells() {
 	}
 }
 
+void Solver::collideStrip(int s) {
+	//check self & half of neighbors to avoid redundancy
+	const int di[5]{0, 1, -1, 0, 1};
+	const int dj[5]{0, 0, 1, 1, 1};
+
+	//for each cell
+	const int i0=strip_width*s, i1=std::min(num_x, i0+strip_width);
+	for(int i=i0; i<i1; i++) {
+		for(int j=0; j<num_y; j++) {
+			for(int d=0; d<5; d++) {
+				//skip if out of range
+				int ci=i+di[d], cj=j+dj[d];
+				if(!inRangeX(ci)||!inRangeY(cj)) continue;
+
+				collideCells(i, j, ci, cj);
+			}
+		}
+	}
+}
+
 void Solver::collideCells(int i1, int j1, int i2, int j2) {
 	//nested linked list traversal
 	int s1=grid_heads[ix(i1, j1)], s2=grid_heads[ix(i2, j2)];
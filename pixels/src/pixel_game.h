@@ -23,6 +23,13 @@ struct PixelGame : olc::PixelGameEngine {
 	std::list<PixelSet*> pixelsets;
 	vf2d gravity;
 
+	//broadphase, sorted by min x
+	struct BroadEntry {
+		cmn::AABBf2 box;
+		PixelSet* set=nullptr;
+	};
+	std::vector<BroadEntry> broadphase;
+
 	//UI toggles
 	bool show_bounds=false;
 	bool show_wireframes=false;
@@ -76,6 +83,7 @@ struct PixelGame : olc::PixelGameEngine {
 
 	bool OnUserCreate() override {
 		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		std::cout<<"Press ESC for integrated console.\n"
 			"  then type help for help.\n";
@@ -275,6 +283,44 @@ struct PixelGame : olc::PixelGameEngine {
 		return true;
 	}
 
+	//random convex polygons scattered on screen
+	bool spawnCommand(int num) {
+		if(num<=0) {
+			std::cout<<"  invalid number. try using:\n  spawn <num>\n";
+
+			return false;
+		}
+
+		for(int n=0; n<num; n++) {
+			int sides=cmn::randInt(3, 8);
+			float rad=cmn::randFloat(15, 40);
+			std::vector<vf2d> pts;
+			for(int i=0; i<sides; i++) {
+				float angle=2*cmn::Pi*(i+cmn::randFloat(-.3f, .3f))/sides;
+				pts.emplace_back(cmn::polar<vf2d>(rad, angle));
+			}
+
+			float scale=cmn::randFloat(2, 5);
+			PixelSet* thing=new PixelSet(PixelSet::fromPolygon(pts, scale));
+			thing->col=olc::Pixel(std::rand()%256, std::rand()%256, std::rand()%256);
+
+			//same as placeAllRandomly
+			thing->rot=cmn::randFloat(2*cmn::Pi);
+			thing->old_rot=thing->rot;
+			thing->updateRot();
+			cmn::AABBf2 box=thing->getAABB();
+			thing->pos.x+=cmn::randFloat(-box.min.x, ScreenWidth()-box.max.x);
+			thing->pos.y+=cmn::randFloat(-box.min.y, ScreenHeight()-box.max.y);
+			thing->old_pos=thing->pos;
+
+			pixelsets.push_back(thing);
+		}
+
+		std::cout<<"  spawned "<<num<<" pixelsets\n";
+
+		return true;
+	}
+
 	bool importCommand(std::string& filename) {
 		if(filename.empty()) {
 			std::cout<<"  no filename. try using:\n  import <filename>\n";
@@ -387,6 +433,12 @@ struct PixelGame : olc::PixelGameEngine {
 			return importCommand(filename);
 		}
 
+		if(cmd=="spawn") {
+			int num=0;
+			line_str>>num;
+			return spawnCommand(num);
+		}
+
 		if(cmd=="keybinds") {
 			std::cout<<
 				"  A      drag polygon to add new pixelset\n"
@@ -425,6 +477,7 @@ struct PixelGame : olc::PixelGameEngine {
 				"  usage        % space used for all allocated pixelsets\n"
 				"  time         times next update and render loop\n"
 				"  cast         casts ray from chosen position to mouse\n"
+				"  spawn        adds specified number of random pixelsets\n"
 				"  export       exports pixelsets to specified file\n"
 				"  import       imports pixelsets from specified file\n"
 				"  keybinds     which keys to press for this program?\n"
@@ -634,6 +687,39 @@ struct PixelGame : olc::PixelGameEngine {
 		if(GetKey(olc::Key::T).bPressed) show_ticks^=true;
 	}
 
+	//sort & sweep on aabbs, then obbs, then pixels
+	void handleCollisions() {
+		broadphase.clear();
+		for(const auto& p:pixelsets) {
+			broadphase.push_back({p->getAABB(), p});
+		}
+		std::sort(broadphase.begin(), broadphase.end(), [] (const BroadEntry& a, const BroadEntry& b) {
+			return a.box.min.x<b.box.min.x;
+		});
+
+		for(int a=0; a<broadphase.size(); a++) {
+			const auto& ea=broadphase[a];
+			for(int b=a+1; b<broadphase.size(); b++) {
+				const auto& eb=broadphase[b];
+				//past the sweep
+				if(eb.box.min.x>ea.box.max.x) break;
+
+				if(!ea.box.overlaps(eb.box)) continue;
+
+				if(!PixelSet::overlapsOBB(*ea.set, *eb.set)) continue;
+
+				cmn::AABBf2 overlap{
+					{std::max(ea.box.min.x, eb.box.min.x), std::max(ea.box.min.y, eb.box.min.y)},
+					{std::min(ea.box.max.x, eb.box.max.x), std::min(ea.box.max.y, eb.box.max.y)}
+				};
+
+				//each checks its edges against the other
+				ea.set->collide(*eb.set, overlap);
+				eb.set->collide(*ea.set, overlap);
+			}
+		}
+	}
+
 	void handlePhysics(float dt) {
 		//dynamics
 		for(const auto& p:pixelsets) {
@@ -641,16 +727,7 @@ struct PixelGame : olc::PixelGameEngine {
 			p->update(dt);
 		}
 
-		//for every pixelset
-		for(const auto& p:pixelsets) {
-			//check every other
-			for(const auto& o:pixelsets) {
-				//dont check self
-				if(o==p) continue;
-
-				p->collide(*o);
-			}
-		}
+		handleCollisions();
 	}
 #pragma endregion
 
@@ -666,9 +743,7 @@ struct PixelGame : olc::PixelGameEngine {
 		if(!IsConsoleShowing()) handleUserInput(dt);
 
 		//clear colliding displays
-		for(const auto& p:pixelsets) {
-			std::memset(p->colliding, false, sizeof(bool)*p->getW()*p->getH());
-		}
+		for(const auto& p:pixelsets) p->clearColliding();
 
 		//after import, something looks wrong...
 		//are meshes not updated?
@@ -852,9 +927,9 @@ struct PixelGame : olc::PixelGameEngine {
 
 #pragma region EXPERIMENTAL
 			//render colliding pixels
-			for(int i=0; i<p->getW(); i++) {
+			if(p->anyColliding()) for(int i=0; i<p->getW(); i++) {
 				for(int j=0; j<p->getH(); j++) {
-					if(!p->colliding[p->ix(i, j)]) continue;
+					if(!p->isColliding(i, j)) continue;
 
 					vf2d pos=p->localToWorld(vf2d(i, j));
 					vf2d size(p->scale, p->scale);
@@ -16,20 +16,52 @@ typedef unsigned char byte;
 
 #include <stack>
 
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 //this is alr def in the lib
 //but i want it explicitly stated
 static vf2d perp(const vf2d& v) {
 	return {-v.y, v.x};
 }
 
+//index of lowest set bit, x!=0
+static int lowestBit(std::uint64_t x) {
+#ifdef _MSC_VER
+	unsigned long i;
+	_BitScanForward64(&i, x);
+	return i;
+#else
+	return __builtin_ctzll(x);
+#endif
+}
+
 class PixelSet {
 	int w, h;
 
+	//bit packed rows, 64 cells per word.
+	//  solid & edge are rebuilt by updateTypes,
+	//  so call it after editing grid.
+	int row_words=1;
+	std::vector<std::uint64_t> solid_bits, edge_bits;
+	std::vector<std::uint64_t> colliding_bits;
+	bool any_colliding=false;
+
 	void copyFrom(const PixelSet& p), clear();
 
+	void allocateBits() {
+		row_words=(w+63)/64;
+		solid_bits.assign(row_words*h, 0);
+		edge_bits.assign(row_words*h, 0);
+		colliding_bits.assign(row_words*h, 0);
+		any_colliding=false;
+	}
+
 public:
 	byte* grid=nullptr;
-	bool* colliding=nullptr;
 
 	enum {
 		Empty=0,
@@ -78,8 +110,7 @@ public:
 		grid=new byte[w*h];
 		std::memset(grid, false, sizeof(byte)*w*h);
 
-		colliding=new bool[w*h];
-		std::memset(colliding, false, sizeof(bool)*w*h);
+		allocateBits();
 
 		updateRot();
 	}
@@ -173,6 +204,32 @@ public:
 	const byte& operator()(int i, int j) const { return grid[ix(i, j)]; }
 	byte& operator()(int i, int j) { return grid[ix(i, j)]; }
 
+	int bit_ix(int i, int j) const { return (i>>6)+row_words*j; }
+
+	//as of last updateTypes
+	bool isSolid(int i, int j) const {
+		return (solid_bits[bit_ix(i, j)]>>(i&63))&1;
+	}
+
+	bool isColliding(int i, int j) const {
+		return (colliding_bits[bit_ix(i, j)]>>(i&63))&1;
+	}
+
+	bool anyColliding() const { return any_colliding; }
+
+	void setColliding(int i, int j) {
+		colliding_bits[bit_ix(i, j)]|=std::uint64_t(1)<<(i&63);
+		any_colliding=true;
+	}
+
+	//only touches memory if something collided
+	void clearColliding() {
+		if(!any_colliding) return;
+
+		std::fill(colliding_bits.begin(), colliding_bits.end(), 0);
+		any_colliding=false;
+	}
+
 	//helpers?
 	bool empty() const {
 		for(int i=0; i<w*h; i++) {
@@ -220,18 +277,43 @@ public:
 #pragma region DESTRUCTION
 	//edge detection for collision routine
 	void updateTypes() {
-		for(int i=0; i<w; i++) {
-			for(int j=0; j<h; j++) {
+		//pack occupancy
+		std::fill(solid_bits.begin(), solid_bits.end(), 0);
+		for(int j=0; j<h; j++) {
+			for(int i=0; i<w; i++) {
+				if(grid[ix(i, j)]==Empty) continue;
+
+				solid_bits[bit_ix(i, j)]|=std::uint64_t(1)<<(i&63);
+			}
+		}
+
+		//edge if any neighbor empty, 64 at a time.
+		//  out of range counts as empty, and
+		//  padding bits past w are always clear.
+		for(int j=0; j<h; j++) {
+			const std::uint64_t* row=&solid_bits[row_words*j];
+			const std::uint64_t* up=j>0?row-row_words:nullptr;
+			const std::uint64_t* down=j<h-1?row+row_words:nullptr;
+			for(int k=0; k<row_words; k++) {
+				std::uint64_t s=row[k];
+				std::uint64_t left=s<<1;
+				if(k>0) left|=row[k-1]>>63;
+				std::uint64_t right=s>>1;
+				if(k<row_words-1) right|=row[k+1]<<63;
+				std::uint64_t u=up?up[k]:0;
+				std::uint64_t d=down?down[k]:0;
+				edge_bits[k+row_words*j]=s&~(left&right&u&d);
+			}
+		}
+
+		//write back types
+		for(int j=0; j<h; j++) {
+			for(int i=0; i<w; i++) {
 				auto& t=grid[ix(i, j)];
 				if(t==Empty) continue;
 
-				//which neighbors are empty?
-				bool left=i==0||grid[ix(i-1, j)]==Empty;
-				bool right=i==w-1||grid[ix(i+1, j)]==Empty;
-				bool up=j==0||grid[ix(i, j-1)]==Empty;
-				bool down=j==h-1||grid[ix(i, j+1)]==Empty;
-				//if any neighbor empty, make edge else normal
-				t=left||right||up||down?Edge:Normal;
+				bool edge=(edge_bits[bit_ix(i, j)]>>(i&63))&1;
+				t=edge?Edge:Normal;
 			}
 		}
 	}
@@ -892,33 +974,94 @@ public:
 		return lin_vel+ang_vel;
 	}
 
+	//separating axis test on both local grid rectangles
+	static bool overlapsOBB(const PixelSet& a, const PixelSet& b) {
+		vf2d ca=a.localToWorld(.5f*vf2d(a.w, a.h));
+		vf2d cb=b.localToWorld(.5f*vf2d(b.w, b.h));
+		vf2d sub=cb-ca;
+
+		const vf2d axes[4]{
+			a.cossin, perp(a.cossin),
+			b.cossin, perp(b.cossin)
+		};
+		for(const auto& n:axes) {
+			//projected half extents
+			float ra=.5f*a.scale*(a.w*std::abs(a.cossin.dot(n))+a.h*std::abs(perp(a.cossin).dot(n)));
+			float rb=.5f*b.scale*(b.w*std::abs(b.cossin.dot(n))+b.h*std::abs(perp(b.cossin).dot(n)));
+			if(std::abs(sub.dot(n))>ra+rb) return false;
+		}
+		return true;
+	}
+
 	//check MY edges against THEIR everything
 	void collide(PixelSet& p) {
 		//check bounding boxes
-		if(!getAABB().overlaps(p.getAABB())) return;
+		cmn::AABBf2 a=getAABB(), b=p.getAABB();
+		if(!a.overlaps(b)) return;
 
-		//for each of MY blocks
-		for(int i=0; i<w; i++) {
-			for(int j=0; j<h; j++) {
-				//skip if not edge
-				if(grid[ix(i, j)]!=PixelSet::Edge) continue;
-
-				//center of MY block in world space
-				vf2d my_world=localToWorld(vf2d(.5f+i, .5f+j));
-
-				//my block in THEIR space
-				vf2d my_in_their=p.worldToLocal(my_world);
-
-				//is it a valid position?
-				int pi=std::floor(my_in_their.x), pj=std::floor(my_in_their.y);
-				if(!p.inRangeX(pi)||!p.inRangeY(pj)) continue;
-
-				//is there anything there?
-				if(p(pi, pj)==Empty) continue;
+		cmn::AABBf2 overlap{
+			{std::max(a.min.x, b.min.x), std::max(a.min.y, b.min.y)},
+			{std::min(a.max.x, b.max.x), std::min(a.max.y, b.max.y)}
+		};
+		collide(p, overlap);
+	}
 
-				//update flags
-				colliding[ix(i, j)]=true;
-				p.colliding[p.ix(pi, pj)]=true;
+	//only my edges whose centers can be in overlap are checked
+	void collide(PixelSet& p, const cmn::AABBf2& overlap) {
+		//overlap region in my space
+		const cmn::vf2d inf(1e30f, 1e30f);
+		cmn::AABBf2 local{inf, -inf};
+		const vf2d corners[4]{
+			{overlap.min.x, overlap.min.y},
+			{overlap.max.x, overlap.min.y},
+			{overlap.max.x, overlap.max.y},
+			{overlap.min.x, overlap.max.y}
+		};
+		for(const auto& c:corners) {
+			vf2d l=worldToLocal(c);
+			local.fitToEnclose({l.x, l.y});
+		}
+		int i0=std::max(0, int(std::floor(local.min.x)));
+		int j0=std::max(0, int(std::floor(local.min.y)));
+		int i1=std::min(w-1, int(std::floor(local.max.x)));
+		int j1=std::min(h-1, int(std::floor(local.max.y)));
+		if(i0>i1||j0>j1) return;
+
+		//MY space to THEIR space is affine,
+		//  so step block centers instead of transforming each
+		vf2d orig=p.worldToLocal(localToWorld(vf2d(.5f, .5f)));
+		vf2d step_i=p.worldToLocal(localToWorld(vf2d(1.5f, .5f)))-orig;
+		vf2d step_j=p.worldToLocal(localToWorld(vf2d(.5f, 1.5f)))-orig;
+
+		const int k0=i0>>6, k1=i1>>6;
+		const std::uint64_t lo_mask=~std::uint64_t(0)<<(i0&63);
+		const std::uint64_t hi_mask=~std::uint64_t(0)>>(63-(i1&63));
+		for(int j=j0; j<=j1; j++) {
+			const std::uint64_t* row=&edge_bits[row_words*j];
+			vf2d row_orig=orig+float(j)*step_j;
+			for(int k=k0; k<=k1; k++) {
+				//edges inside column range
+				std::uint64_t word=row[k];
+				if(k==k0) word&=lo_mask;
+				if(k==k1) word&=hi_mask;
+				while(word) {
+					int i=64*k+lowestBit(word);
+					word&=word-1;
+
+					//my block in THEIR space
+					vf2d my_in_their=row_orig+float(i)*step_i;
+
+					//is it a valid position?
+					int pi=std::floor(my_in_their.x), pj=std::floor(my_in_their.y);
+					if(!p.inRangeX(pi)||!p.inRangeY(pj)) continue;
+
+					//is there anything there?
+					if(!p.isSolid(pi, pj)) continue;
+
+					//update flags
+					setColliding(i, j);
+					p.setColliding(pi, pj);
+				}
 			}
 		}
 	}
@@ -930,8 +1073,11 @@ void PixelSet::copyFrom(const PixelSet& p) {
 	w=p.w, h=p.h;
 	grid=new byte[w*h];
 	std::memcpy(grid, p.grid, sizeof(byte)*w*h);
-	colliding=new bool[w*h];
-	std::memcpy(colliding, p.colliding, sizeof(bool)*w*h);
+	row_words=p.row_words;
+	solid_bits=p.solid_bits;
+	edge_bits=p.edge_bits;
+	colliding_bits=p.colliding_bits;
+	any_colliding=p.any_colliding;
 
 	//positions
 	pos=p.pos;
@@ -960,7 +1106,6 @@ void PixelSet::copyFrom(const PixelSet& p) {
 
 void PixelSet::clear() {
 	delete[] grid;
-	delete[] colliding;
 
 	clearMeshes();
 	clearOutlines();
@@ -122,6 +122,7 @@ struct RigidBodyUI : olc::PixelGameEngine {
 
 	bool OnUserCreate() override {
 		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		//init bounds
 		phys_bounds={{-4, -3}, {4, 3}};
@@ -0,0 +1,429 @@
+//https://kociemba.org/math/cubielevel.htm
+#pragma once
+#ifndef CUBIE_CUBE_STRUCT_H
+#define CUBIE_CUBE_STRUCT_H
+
+#include "rubiks_cube.h"
+
+//for uint8_t
+#include <cstdint>
+
+//for memcpy
+#include <cstring>
+
+//3x3 as permutation & orientation of its 8 corners & 12 edges.
+//  centers never move relative to each other, so theyre implied.
+struct CubieCube {
+	enum : int {
+		URF=0, UFL, ULB, UBR,
+		DFR, DLF, DBL, DRB
+	};
+
+	enum : int {
+		UR=0, UF, UL, UB,
+		DR, DF, DL, DB,
+		FR, FL, BL, BR
+	};
+
+	//face names, not colors
+	enum : int {
+		U=0, R, F, D, L, B
+	};
+
+	//face*3+power-1
+	static const int num_moves=18;
+
+	//cubie at each position & its twist or flip there
+	std::uint8_t cp[8], co[8];
+	std::uint8_t ep[12], eo[12];
+
+	CubieCube() {
+		for(int i=0; i<8; i++) cp[i]=i, co[i]=0;
+		for(int i=0; i<12; i++) ep[i]=i, eo[i]=0;
+	}
+
+	//out=a then b
+	static void multiply(const CubieCube& a, const CubieCube& b, CubieCube& out) {
+		for(int i=0; i<8; i++) {
+			out.cp[i]=a.cp[b.cp[i]];
+			out.co[i]=(a.co[b.cp[i]]+b.co[i])%3;
+		}
+		for(int i=0; i<12; i++) {
+			out.ep[i]=a.ep[b.ep[i]];
+			out.eo[i]=(a.eo[b.ep[i]]+b.eo[i])%2;
+		}
+	}
+
+	void move(int m) {
+		CubieCube tmp;
+		multiply(*this, getMove(m), tmp);
+		*this=tmp;
+	}
+
+	static const CubieCube& getMove(int m);
+
+	//the quarter turn face moves are built from
+	static Turn getFaceTurn(int f) {
+		static const Turn turns[6]{Turn::U, Turn::R, Turn::F, Turn::D, Turn::L, Turn::B};
+		return turns[f];
+	}
+
+	//1-3 quarter turns as cube turns
+	static void toTurns(int m, std::vector<Turn>& turns) {
+		Turn t=getFaceTurn(m/3);
+		switch(m%3) {
+			case 0: turns.push_back(t); break;
+			case 1: turns.push_back(t), turns.push_back(t); break;
+			case 2: t.ccw^=true, turns.push_back(t); break;
+		}
+	}
+
+#pragma region COORDINATES
+	static int choose(int n, int k) {
+		if(k<0||k>n) return 0;
+		int r=1;
+		for(int i=0; i<k; i++) r=r*(n-i)/(i+1);
+		return r;
+	}
+
+	template<typename T>
+	static void rotateLeft(T* a, int l, int r) {
+		T tmp=a[l];
+		for(int i=l; i<r; i++) a[i]=a[i+1];
+		a[r]=tmp;
+	}
+
+	template<typename T>
+	static void rotateRight(T* a, int l, int r) {
+		T tmp=a[r];
+		for(int i=r; i>l; i--) a[i]=a[i-1];
+		a[l]=tmp;
+	}
+
+	//corner orientations, 0-2186
+	int getTwist() const {
+		int r=0;
+		for(int i=URF; i<DRB; i++) r=3*r+co[i];
+		return r;
+	}
+
+	void setTwist(int t) {
+		int sum=0;
+		for(int i=DRB-1; i>=URF; i--) {
+			co[i]=t%3;
+			sum+=co[i];
+			t/=3;
+		}
+		co[DRB]=(3-sum%3)%3;
+	}
+
+	//edge orientations, 0-2047
+	int getFlip() const {
+		int r=0;
+		for(int i=UR; i<BR; i++) r=2*r+eo[i];
+		return r;
+	}
+
+	void setFlip(int f) {
+		int sum=0;
+		for(int i=BR-1; i>=UR; i--) {
+			eo[i]=f%2;
+			sum+=eo[i];
+			f/=2;
+		}
+		eo[BR]=sum%2;
+	}
+
+	//where & in what order the 4 slice edges are, 0-11879.
+	//  /24 is just where, which is 0 once theyre in the slice.
+	int getSliceSorted() const {
+		int a=0, x=0;
+		std::uint8_t edge4[4];
+		for(int j=BR; j>=UR; j--) {
+			if(ep[j]>=FR) {
+				a+=choose(11-j, x+1);
+				edge4[3-x]=ep[j];
+				x++;
+			}
+		}
+
+		int b=0;
+		for(int j=3; j>0; j--) {
+			int k=0;
+			while(edge4[j]!=j+FR) {
+				rotateLeft(edge4, 0, j);
+				k++;
+			}
+			b=(j+1)*b+k;
+		}
+		return 24*a+b;
+	}
+
+	void setSliceSorted(int idx) {
+		std::uint8_t slice_edge[4]{FR, FL, BL, BR};
+		const std::uint8_t other_edge[8]{UR, UF, UL, UB, DR, DF, DL, DB};
+		int b=idx%24, a=idx/24;
+		for(int j=1; j<4; j++) {
+			int k=b%(j+1);
+			b/=j+1;
+			for(; k>0; k--) rotateRight(slice_edge, 0, j);
+		}
+
+		for(int i=0; i<12; i++) ep[i]=255;
+		int x=4;
+		for(int j=UR; j<=BR; j++) {
+			if(a-choose(11-j, x)>=0) {
+				ep[j]=slice_edge[4-x];
+				a-=choose(11-j, x);
+				x--;
+			}
+		}
+		x=0;
+		for(int j=UR; j<=BR; j++) {
+			if(ep[j]==255) ep[j]=other_edge[x++];
+		}
+	}
+
+	//corner permutation, 0-40319
+	int getCorners() const {
+		std::uint8_t perm[8];
+		std::memcpy(perm, cp, 8);
+		int b=0;
+		for(int j=DRB; j>URF; j--) {
+			int k=0;
+			while(perm[j]!=j) {
+				rotateLeft(perm, 0, j);
+				k++;
+			}
+			b=(j+1)*b+k;
+		}
+		return b;
+	}
+
+	void setCorners(int idx) {
+		for(int i=0; i<8; i++) cp[i]=i;
+		for(int j=0; j<8; j++) {
+			int k=idx%(j+1);
+			idx/=j+1;
+			for(; k>0; k--) rotateRight(cp, 0, j);
+		}
+	}
+
+	//permutation of the 8 U & D edges once the slice is home, 0-40319
+	int getUDEdges() const {
+		std::uint8_t perm[8];
+		std::memcpy(perm, ep, 8);
+		int b=0;
+		for(int j=DB; j>UR; j--) {
+			int k=0;
+			while(perm[j]!=j) {
+				rotateLeft(perm, 0, j);
+				k++;
+			}
+			b=(j+1)*b+k;
+		}
+		return b;
+	}
+
+	void setUDEdges(int idx) {
+		for(int i=0; i<12; i++) ep[i]=i;
+		for(int j=0; j<8; j++) {
+			int k=idx%(j+1);
+			idx/=j+1;
+			for(; k>0; k--) rotateRight(ep, 0, j);
+		}
+	}
+#pragma endregion
+
+	//every cubie once, twist & flip sum to 0, & parities match
+	bool isSolvable() const {
+		bool c_seen[8]{}, e_seen[12]{};
+		int c_sum=0, e_sum=0;
+		for(int i=0; i<8; i++) {
+			if(cp[i]>=8||c_seen[cp[i]]) return false;
+			c_seen[cp[i]]=true;
+			c_sum+=co[i];
+		}
+		for(int i=0; i<12; i++) {
+			if(ep[i]>=12||e_seen[ep[i]]) return false;
+			e_seen[ep[i]]=true;
+			e_sum+=eo[i];
+		}
+		if(c_sum%3||e_sum%2) return false;
+
+		auto parity=[] (const std::uint8_t* p, int n) {
+			int s=0;
+			for(int i=0; i<n; i++) {
+				for(int j=i+1; j<n; j++) s+=p[i]>p[j];
+			}
+			return s%2;
+		};
+		return parity(cp, 8)==parity(ep, 12);
+	}
+
+#pragma region FACELETS
+private:
+	struct FaceletMap {
+		//grid index of each sticker, U/D or F/B first
+		int corners[8][3];
+		int edges[12][2];
+		//center of each named face
+		int centers[6];
+	};
+
+	//face names on each cubie in facelet order
+	static constexpr int corner_faces[8][3]{
+		{U, R, F}, {U, F, L}, {U, L, B}, {U, B, R},
+		{D, F, R}, {D, L, F}, {D, B, L}, {D, R, B}
+	};
+	static constexpr int edge_faces[12][2]{
+		{U, R}, {U, F}, {U, L}, {U, B},
+		{D, R}, {D, F}, {D, L}, {D, B},
+		{F, R}, {F, L}, {B, L}, {B, R}
+	};
+
+	static int toGridFace(int f) {
+		static const int faces[6]{
+			RubiksCube::Top, RubiksCube::Right, RubiksCube::Front,
+			RubiksCube::Bottom, RubiksCube::Left, RubiksCube::Back
+		};
+		return faces[f];
+	}
+
+	//find stickers by position so this follows the grid layout
+	static const FaceletMap& getFaceletMap() {
+		static const FaceletMap map=[] {
+			FaceletMap m;
+			RubiksCube rc(3);
+
+			//cubie coordinate a named face pins down
+			auto pin=[] (int f, int* xyz) {
+				switch(f) {
+					case U: xyz[1]=2; break;
+					case D: xyz[1]=0; break;
+					case R: xyz[0]=2; break;
+					case L: xyz[0]=0; break;
+					case F: xyz[2]=2; break;
+					case B: xyz[2]=0; break;
+				}
+			};
+			auto find=[&] (int f, const int* xyz) {
+				int gf=toGridFace(f);
+				for(int i=0; i<3; i++) {
+					for(int j=0; j<3; j++) {
+						int x, y, z;
+						rc.inv_ix(gf, i, j, x, y, z);
+						if(x==xyz[0]&&y==xyz[1]&&z==xyz[2]) return rc.ix(gf, i, j);
+					}
+				}
+				return -1;
+			};
+
+			for(int c=0; c<8; c++) {
+				int xyz[3]{1, 1, 1};
+				for(int k=0; k<3; k++) pin(corner_faces[c][k], xyz);
+				for(int k=0; k<3; k++) m.corners[c][k]=find(corner_faces[c][k], xyz);
+			}
+			for(int e=0; e<12; e++) {
+				int xyz[3]{1, 1, 1};
+				for(int k=0; k<2; k++) pin(edge_faces[e][k], xyz);
+				for(int k=0; k<2; k++) m.edges[e][k]=find(edge_faces[e][k], xyz);
+			}
+			for(int f=0; f<6; f++) m.centers[f]=rc.ix(toGridFace(f), 1, 1);
+			return m;
+		}();
+		return map;
+	}
+
+public:
+	//read a 3x3 grid.
+	//  centers say which color goes w/ which face,
+	//  so whole cube rotations are fine.
+	bool fromCube(const RubiksCube& rc) {
+		if(rc.getNum()!=3) return false;
+
+		const auto& map=getFaceletMap();
+		int col2face[6];
+		for(int i=0; i<6; i++) col2face[i]=-1;
+		for(int f=0; f<6; f++) {
+			int col=rc.grid[map.centers[f]];
+			if(col<0||col>=6||col2face[col]!=-1) return false;
+			col2face[col]=f;
+		}
+		auto faceAt=[&] (int g) { return col2face[rc.grid[g]]; };
+
+		for(int i=0; i<8; i++) {
+			int fs[3];
+			for(int k=0; k<3; k++) fs[k]=faceAt(map.corners[i][k]);
+			int ori=0;
+			while(ori<3&&fs[ori]!=U&&fs[ori]!=D) ori++;
+			if(ori==3) return false;
+
+			int f1=fs[(ori+1)%3], f2=fs[(ori+2)%3];
+			cp[i]=255;
+			for(int j=0; j<8; j++) {
+				if(corner_faces[j][1]==f1&&corner_faces[j][2]==f2) {
+					cp[i]=j;
+					co[i]=ori;
+					break;
+				}
+			}
+			if(cp[i]==255) return false;
+		}
+
+		for(int i=0; i<12; i++) {
+			int f0=faceAt(map.edges[i][0]), f1=faceAt(map.edges[i][1]);
+			ep[i]=255;
+			for(int j=0; j<12; j++) {
+				if(edge_faces[j][0]==f0&&edge_faces[j][1]==f1) {
+					ep[i]=j, eo[i]=0;
+					break;
+				}
+				if(edge_faces[j][0]==f1&&edge_faces[j][1]==f0) {
+					ep[i]=j, eo[i]=1;
+					break;
+				}
+			}
+			if(ep[i]==255) return false;
+		}
+
+		return isSolvable();
+	}
+
+	//write w/ the default color scheme
+	void toCube(RubiksCube& rc) const {
+		if(rc.getNum()!=3) rc=RubiksCube(3);
+
+		const auto& map=getFaceletMap();
+		for(int f=0; f<6; f++) rc.grid[map.centers[f]]=toGridFace(f);
+		for(int i=0; i<8; i++) {
+			for(int k=0; k<3; k++) {
+				rc.grid[map.corners[i][(k+co[i])%3]]=toGridFace(corner_faces[cp[i]][k]);
+			}
+		}
+		for(int i=0; i<12; i++) {
+			for(int k=0; k<2; k++) {
+				rc.grid[map.edges[i][(k+eo[i])%2]]=toGridFace(edge_faces[ep[i]][k]);
+			}
+		}
+	}
+#pragma endregion
+};
+
+//read each face turn off an actual grid,
+//  so moves always agree w/ RubiksCube::turn.
+const CubieCube& CubieCube::getMove(int m) {
+	static const std::vector<CubieCube> moves=[] {
+		std::vector<CubieCube> ms(num_moves);
+		for(int f=0; f<6; f++) {
+			RubiksCube rc(3);
+			for(int p=0; p<3; p++) {
+				rc.turn(getFaceTurn(f));
+				ms[3*f+p].fromCube(rc);
+			}
+		}
+		return ms;
+	}();
+	return moves[m];
+}
+#endif
\ No newline at end of file
@@ -1,58 +1,48 @@
-/*TODO:
-slice store index
-	reverse_idx
-	rotate_left_idx
-*/
 #pragma once
 #ifndef RUBIKS_CUBE_CLASS_H
 #define RUBIKS_CUBE_CLASS_H
 
-//for memcpy
-#include <string>
+//for memcpy, memset
+#include <cstring>
 
 #include <vector>
 
-#include "turn.h"
+//for reverse
+#include <algorithm>
 
-//reverse pointed-to elements
-template<typename T>
-static void reverse_ptr(T** a, int l, int r) {
-	T tmp;
-	while(l<r) {
-		tmp=*a[l];
-		*a[l]=*a[r];
-		*a[r]=tmp;
-		l++, r--;
-	}
-}
+//for uint8_t
+#include <cstdint>
 
-//rotate pointed-to elements
-template<typename T>
-void rotate_left_ptr(T** a, int n, int k) {
-	k%=n;
-	if(k==0) return;
+#include "turn.h"
 
-	reverse_ptr(a, 0, k-1);
-	reverse_ptr(a, k, n-1);
-	reverse_ptr(a, 0, n-1);
-}
+#ifdef _MSC_VER
+#define RC_RESTRICT __restrict
+#else
+#define RC_RESTRICT __restrict__
+#endif
 
 class RubiksCube {
 	int num;
 
 	void copyFrom(const RubiksCube&), clear();
 
-	int** slice=nullptr;
-	int* face=nullptr;
+	//a row or column of stickers around a slice
+	struct Strip {
+		int base, stride;
+	};
+
+	void getStrips(int, int, Strip*) const;
 
-	void spinFace(int, bool);
+	//q: quarter turns, 1-3
+	void cycleStrips(const Strip*, int), spinFace(int, int);
 
-	void turnX(int, bool), turnY(int, bool), turnZ(int, bool);
+	void turnAxis(int, int, int);
 
-	void rotateX(bool), rotateY(bool), rotateZ(bool);
+	void rotateAxis(int, int);
 
 public:
-	int* grid=nullptr;
+	//one byte per sticker
+	std::uint8_t* grid=nullptr;
 
 	enum : int {
 		Right=0, Top, Front,
@@ -68,9 +58,7 @@ public:
 
 	RubiksCube(int n) {
 		num=n;
-		grid=new int[6*num*num];
-		slice=new int* [4*num];
-		face=new int[num*num];
+		grid=new std::uint8_t[6*num*num];
 		reset();
 	}
 
@@ -106,35 +94,43 @@ public:
 			case Front: x=i, y=num-1-j, z=num-1; break;
 			case Left: x=0, y=num-1-j, z=i; break;
 			case Bottom: x=i, y=0, z=num-1-j; break;
-			case Back: x=num-1-i, y=num-1-j, z=0; break; 
+			case Back: x=num-1-i, y=num-1-j, z=0; break;
+			//not a face
+			default: x=-1, y=-1, z=-1; break;
 		}
 	}
 
 	void reset() {
 		for(int f=0; f<6; f++) {
-			for(int i=0; i<num; i++) {
-				for(int j=0; j<num; j++) {
-					grid[ix(f, i, j)]=f;
-				}
-			}
+			std::memset(grid+num*num*f, f, num*num);
 		}
 	}
 
 	void turn(const Turn& t) {
-		if(t.slice==0) switch(t.axis) {
-			case Turn::XAxis: rotateX(t.ccw); return;
-			case Turn::YAxis: rotateY(t.ccw); return;
-			case Turn::ZAxis: rotateZ(t.ccw); return;
-		}
-			
-		int slice=t.slice<0?num+t.slice:t.slice-1;
-		switch(t.axis) {
-			case Turn::XAxis: turnX(slice, t.ccw); break;
-			case Turn::YAxis: turnY(slice, t.ccw); break;
-			case Turn::ZAxis: turnZ(slice, t.ccw); break;
+		turnAxis(t.axis, t.slice, t.ccw?3:1);
+	}
+
+	//merges runs on the same slice, so
+	//  U U' is nothing & U U is one half turn.
+	void turn(const Turn* turns, std::size_t n) {
+		for(std::size_t i=0; i<n;) {
+			const Turn& t=turns[i];
+			int q=0;
+			for(; i<n; i++) {
+				const Turn& u=turns[i];
+				if(u.axis!=t.axis||u.slice!=t.slice) break;
+
+				q+=u.ccw?3:1;
+			}
+			q%=4;
+			if(q) turnAxis(t.axis, t.slice, q);
 		}
 	}
 
+	void turn(const std::vector<Turn>& turns) {
+		turn(turns.data(), turns.size());
+	}
+
 	std::vector<Turn> getScramble() const {
 		std::vector<Turn> turns;
 		int num_turns=(9+std::rand()%5)*num;
@@ -150,99 +146,140 @@ public:
 void RubiksCube::copyFrom(const RubiksCube& r) {
 	num=r.num;
 
-	grid=new int[6*num*num];
-	std::memcpy(grid, r.grid, sizeof(int)*6*num*num);
-
-	slice=new int* [4*num];
-	std::memcpy(slice, r.slice, sizeof(int*)*4*num);
-
-	face=new int[num*num];
-	std::memcpy(face, r.face, sizeof(int)*num*num);
+	grid=new std::uint8_t[6*num*num];
+	std::memcpy(grid, r.grid, 6*num*num);
 }
 
 void RubiksCube::clear() {
 	delete[] grid;
-	delete[] slice;
-	delete[] face;
 }
 
-//helper for the turn methods
-void RubiksCube::spinFace(int f, bool opp) {
-	for(int i=0; i<num; i++) {
-		for(int j=0; j<num; j++) {
-			face[ix(0, i, j)]=grid[ix(f, i, j)];
-		}
+//4 strips going the same way around a slice,
+//  turning moves each into the one before it.
+void RubiksCube::getStrips(int axis, int s, Strip* strips) const {
+	const int n=num, r=num-1-s;
+	switch(axis) {
+		case Turn::XAxis:
+			strips[0]={ix(Top, s, 0), n};
+			strips[1]={ix(Front, s, 0), n};
+			strips[2]={ix(Bottom, s, 0), n};
+			strips[3]={ix(Back, r, n-1), -n};
+			break;
+		case Turn::YAxis:
+			strips[0]={ix(Front, 0, r), 1};
+			strips[1]={ix(Right, 0, r), 1};
+			strips[2]={ix(Back, 0, r), 1};
+			strips[3]={ix(Left, 0, r), 1};
+			break;
+		case Turn::ZAxis:
+			strips[0]={ix(Top, n-1, s), -1};
+			strips[1]={ix(Left, s, 0), n};
+			strips[2]={ix(Bottom, 0, r), 1};
+			strips[3]={ix(Right, r, n-1), -n};
+			break;
 	}
+}
 
-	for(int i=0; i<num; i++) {
-		for(int j=0; j<num; j++) {
-			int ri=opp?num-1-j:j;
-			int rj=opp?i:num-1-i;
-			grid[ix(f, ri, rj)]=face[ix(0, i, j)];
-		}
+//a<-b<-c<-d<-a
+static void cycle4(std::uint8_t* RC_RESTRICT a, std::uint8_t* RC_RESTRICT b, std::uint8_t* RC_RESTRICT c, std::uint8_t* RC_RESTRICT d, int n) {
+	for(int k=0; k<n; k++) {
+		std::uint8_t tmp=a[k];
+		a[k]=b[k], b[k]=c[k], c[k]=d[k], d[k]=tmp;
 	}
 }
 
-void RubiksCube::turnX(int x, bool ccw) {
-	if(x<0||x>=num) return;
-
-	for(int i=0; i<num; i++) {
-		slice[i]=&grid[ix(Top, x, i)];
-		slice[num+i]=&grid[ix(Front, x, i)];
-		slice[2*num+i]=&grid[ix(Bottom, x, i)];
-		slice[3*num+i]=&grid[ix(Back, num-1-x, num-1-i)];
+static void swap2(std::uint8_t* RC_RESTRICT a, std::uint8_t* RC_RESTRICT b, int n) {
+	for(int k=0; k<n; k++) {
+		std::uint8_t tmp=a[k];
+		a[k]=b[k], b[k]=tmp;
 	}
-
-	int amt=ccw?3*num:num;
-	rotate_left_ptr(slice, 4*num, amt);
-
-	if(x==0) spinFace(Left, ccw);
-	else if(x==num-1) spinFace(Right, !ccw);
 }
 
-void RubiksCube::turnY(int y, bool ccw) {
-	if(y<0||y>=num) return;
+//same as cycle4 w/ strides
+static void cycle4(std::uint8_t* a, int sa, std::uint8_t* b, int sb, std::uint8_t* c, int sc, std::uint8_t* d, int sd, int n) {
+	for(int k=0; k<n; k++) {
+		std::uint8_t tmp=*a;
+		*a=*b, *b=*c, *c=*d, *d=tmp;
+		a+=sa, b+=sb, c+=sc, d+=sd;
+	}
+}
 
-	for(int i=0; i<num; i++) {
-		slice[i]=&grid[ix(Front, i, num-1-y)];
-		slice[num+i]=&grid[ix(Right, i, num-1-y)];
-		slice[2*num+i]=&grid[ix(Back, i, num-1-y)];
-		slice[3*num+i]=&grid[ix(Left, i, num-1-y)];
+static void swap2(std::uint8_t* a, int sa, std::uint8_t* b, int sb, int n) {
+	for(int k=0; k<n; k++) {
+		std::uint8_t tmp=*a;
+		*a=*b, *b=tmp;
+		a+=sa, b+=sb;
 	}
+}
 
-	int amt=ccw?3*num:num;
-	rotate_left_ptr(slice, 4*num, amt);
+void RubiksCube::cycleStrips(const Strip* st, int q) {
+	std::uint8_t* p[4];
+	for(int k=0; k<4; k++) p[k]=grid+st[k].base;
+
+	//y slices are contiguous rows
+	bool unit=true;
+	for(int k=0; k<4; k++) unit&=st[k].stride==1;
+	if(unit) {
+		switch(q) {
+			case 1: cycle4(p[0], p[1], p[2], p[3], num); break;
+			case 2: swap2(p[0], p[2], num), swap2(p[1], p[3], num); break;
+			case 3: cycle4(p[0], p[3], p[2], p[1], num); break;
+		}
+		return;
+	}
 
-	if(y==0) spinFace(Bottom, ccw);
-	if(y==num-1) spinFace(Top, !ccw);
+	const int s0=st[0].stride, s1=st[1].stride;
+	const int s2=st[2].stride, s3=st[3].stride;
+	switch(q) {
+		case 1: cycle4(p[0], s0, p[1], s1, p[2], s2, p[3], s3, num); break;
+		case 2: swap2(p[0], s0, p[2], s2, num), swap2(p[1], s1, p[3], s3, num); break;
+		case 3: cycle4(p[0], s0, p[3], s3, p[2], s2, p[1], s1, num); break;
+	}
 }
 
-void RubiksCube::turnZ(int z, bool ccw) {
-	if(z<0||z>=num) return;
+//(i, j) goes to (j, n-1-i) q times, in place.
+//  half turns are just reversing the face.
+void RubiksCube::spinFace(int f, int q) {
+	std::uint8_t* g=grid+num*num*f;
+	const int n=num, m=num-1;
+	if(q==2) {
+		std::reverse(g, g+n*n);
+		return;
+	}
 
-	for(int i=0; i<num; i++) {
-		slice[i]=&grid[ix(Top, num-1-i, z)];
-		slice[num+i]=&grid[ix(Left, z, i)];
-		slice[2*num+i]=&grid[ix(Bottom, i, num-1-z)];
-		slice[3*num+i]=&grid[ix(Right, num-1-z, num-1-i)];
+	//each ring of 4 stickers
+	for(int j=0; j<(n+1)/2; j++) {
+		std::uint8_t* p0=g+n*j;
+		std::uint8_t* p1=g+j+n*m;
+		std::uint8_t* p2=g+m+n*(m-j);
+		std::uint8_t* p3=g+m-j;
+		if(q==1) cycle4(p0, 1, p3, n, p2, -1, p1, -n, n/2);
+		else cycle4(p0, 1, p1, -n, p2, -1, p3, n, n/2);
 	}
+}
 
-	int amt=ccw?3*num:num;
-	rotate_left_ptr(slice, 4*num, amt);
+//slice: see Turn
+void RubiksCube::turnAxis(int axis, int slice, int q) {
+	if(slice==0) {
+		rotateAxis(axis, q);
+		return;
+	}
 
-	if(z==0) spinFace(Back, ccw);
-	else if(z==num-1) spinFace(Front, !ccw);
-}
+	int s=slice<0?num+slice:slice-1;
+	if(s<0||s>=num) return;
 
-void RubiksCube::rotateX(bool ccw) {
-	for(int i=0; i<num; i++) turnX(i, ccw);
-}
+	Strip strips[4];
+	getStrips(axis, s, strips);
+	cycleStrips(strips, q);
 
-void RubiksCube::rotateY(bool ccw) {
-	for(int i=0; i<num; i++) turnY(i, ccw);
+	//low face turns w/ the slice, high face against it
+	static const int low[3]{Left, Bottom, Back};
+	static const int high[3]{Right, Top, Front};
+	if(s==0) spinFace(low[axis], q);
+	if(s==num-1) spinFace(high[axis], 4-q);
 }
 
-void RubiksCube::rotateZ(bool ccw) {
-	for(int i=0; i<num; i++) turnZ(i, ccw);
+void RubiksCube::rotateAxis(int axis, int q) {
+	for(int i=1; i<=num; i++) turnAxis(axis, i, q);
 }
 #endif
\ No newline at end of file
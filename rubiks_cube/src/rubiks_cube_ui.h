@@ -1,5 +1,4 @@
 /*todo:
-beginner 3x3 solver
 varying turn speeds:
 	fast scramble
 	slow solve
@@ -14,6 +13,7 @@ selectable sizes
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -31,6 +31,8 @@ selectable sizes
 
 #include "rubiks_cube.h"
 
+#include "solver.h"
+
 #include "cmn/math/v3d.h"
 #include "cmn/math/mat4.h"
 
@@ -38,8 +40,12 @@ selectable sizes
 
 #include "cmn/easing.h"
 
+#include "cmn/stopwatch.h"
+
 #include <deque>
 
+#include <iostream>
+
 using cmn::vf3d;
 using cmn::mat4;
 
@@ -124,6 +130,9 @@ class RubiksCubeUI : public cmn::SokolEngine {
 		};
 	} cube;
 
+	//tables load on first solve
+	TwoPhaseSolver solver;
+
 	struct {
 		sg_pipeline pip{};
 
@@ -177,7 +186,7 @@ public:
 		sg_pipeline_desc pip_desc{};
 		pip_desc.layout.attrs[ATTR_skybox_v_pos].format=SG_VERTEXFORMAT_FLOAT3;
 		pip_desc.layout.attrs[ATTR_skybox_v_uv].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(skybox_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(skybox_shader_desc(getBackend()));
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 		skybox.pip=sg_make_pipeline(pip_desc);
 
@@ -235,7 +244,7 @@ public:
 			pip_desc.layout.attrs[ATTR_cube_i_pos].format=SG_VERTEXFORMAT_FLOAT3;
 			pip_desc.layout.attrs[ATTR_cube_i_norm].format=SG_VERTEXFORMAT_FLOAT3;
 			pip_desc.layout.attrs[ATTR_cube_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
-			pip_desc.shader=sg_make_shader(cube_shader_desc(sg_query_backend()));
+			pip_desc.shader=sg_make_shader(cube_shader_desc(getBackend()));
 			pip_desc.index_type=SG_INDEXTYPE_UINT32;
 			pip_desc.cull_mode=SG_CULLMODE_FRONT;
 			pip_desc.depth.write_enabled=true;
@@ -295,7 +304,7 @@ public:
 		sg_pipeline_desc pip_desc{};
 		pip_desc.layout.attrs[ATTR_colorview_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
 		pip_desc.layout.attrs[ATTR_colorview_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(colorview_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(colorview_shader_desc(getBackend()));
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 		//with alpha blending
 		pip_desc.colors[0].blend.enabled=true;
@@ -362,6 +371,7 @@ public:
 		app_title="Rubiks Cube";
 		
 		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		setupSamplers();
 
@@ -422,6 +432,60 @@ public:
 		cam.pos=-1.8f*rad*cam.dir;
 	}
 
+	//random slice turns one at a time & batched
+	void benchmarkTurns() {
+		cmn::Stopwatch watch;
+		std::cout<<"turn throughput:\n";
+		for(int n:{3, 4, 5, 7, 10, 17, 25, 50, 75, 100}) {
+			RubiksCube rc(n);
+			std::vector<Turn> turns;
+			int num_turns=std::max(10000, 20000000/(n*n));
+			while((int)turns.size()<num_turns) {
+				auto scramble=rc.getScramble();
+				turns.insert(turns.end(), scramble.begin(), scramble.end());
+			}
+
+			watch.start();
+			for(const auto& t:turns) rc.turn(t);
+			watch.stop();
+			auto single_us=watch.getMicros();
+
+			watch.start();
+			rc.turn(turns);
+			watch.stop();
+			auto batch_us=watch.getMicros();
+
+			//per us is millions per s
+			auto rate=[&] (long long us) { return float(turns.size())/std::max(1ll, us); };
+			std::cout<<"  N="<<n<<": "<<rate(single_us)<<"M moves/s, batched "<<rate(batch_us)<<"M moves/s\n";
+		}
+	}
+
+	void solveCube() {
+		if(cube.rubiks.getNum()!=3) {
+			std::cout<<"solver only handles 3x3s\n";
+			return;
+		}
+
+		RubiksCube end=cube.rubiks;
+		for(const auto& t:cube.turn_queue) end.turn(t);
+
+		cmn::Stopwatch watch;
+		watch.start();
+		std::vector<Turn> turns;
+		bool solved=solver.solve(end, turns);
+		watch.stop();
+		if(!solved) {
+			std::cout<<"cube is unsolvable\n";
+			return;
+		}
+
+		std::cout<<"solved in "<<turns.size()<<" quarter turns ("<<watch.getMicros()<<" us)\n";
+		cube.turn_queue.insert(cube.turn_queue.end(),
+			turns.begin(), turns.end()
+		);
+	}
+
 	void handleCubeControls() {
 		//reset
 		if(GetKey(SAPP_KEYCODE_HOME).pressed) {
@@ -441,15 +505,19 @@ public:
 		if(GetKey(SAPP_KEYCODE_Y).pressed) cube.turn_queue.push_back(ccw?Turn::y:Turn::Y);
 		if(GetKey(SAPP_KEYCODE_Z).pressed) cube.turn_queue.push_back(ccw?Turn::z:Turn::Z);
 
-		//scramble
+		//scramble, shift skips the animation
 		if(GetKey(SAPP_KEYCODE_S).pressed) {
 			cube.turn_queue.clear();
 			auto scramble=cube.rubiks.getScramble();
-			cube.turn_queue.insert(cube.turn_queue.end(),
+			if(ccw) cube.rubiks.turn(scramble);
+			else cube.turn_queue.insert(cube.turn_queue.end(),
 				scramble.begin(), scramble.end()
 			);
 		}
 
+		//solve from wherever the queue leaves it
+		if(GetKey(SAPP_KEYCODE_ENTER).pressed) solveCube();
+
 		//change cube size
 		for(int i=1; i<=9; i++) {
 			auto key=(sapp_keycode)(i+SAPP_KEYCODE_0);
@@ -471,6 +539,8 @@ public:
 
 		//toggle turn queue render
 		if(GetKey(SAPP_KEYCODE_T).pressed) cube.render_turn_queue^=true;
+
+		if(GetKey(SAPP_KEYCODE_M).pressed) benchmarkTurns();
 	}
 
 	void updateCameraMatrixes() {
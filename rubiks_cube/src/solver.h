@@ -0,0 +1,352 @@
+//https://kociemba.org/math/twophase.htm
+#pragma once
+#ifndef TWO_PHASE_SOLVER_CLASS_H
+#define TWO_PHASE_SOLVER_CLASS_H
+
+#include "cubie_cube.h"
+
+#include <fstream>
+
+#include <chrono>
+
+//phase 1: any cube => <U, D, R2, L2, F2, B2>
+//  orient everything & bring the slice edges home.
+//phase 2: solve w/ only those moves.
+//  keep looking for longer phase 1s w/ shorter totals
+//  until short enough or out of time.
+class TwoPhaseSolver {
+	static const int N_TWIST=2187;
+	static const int N_FLIP=2048;
+	static const int N_SLICE=495;
+	static const int N_SLICE_SORTED=11880;
+	static const int N_PERM=40320;
+	static const int N_SLICE_PERM=24;
+
+	static const int N_MOVE=CubieCube::num_moves;
+	static const int N_MOVE2=10;
+
+	//phase 2 can take 18, but a longer phase 1
+	//  w/ a short phase 2 usually wins sooner.
+	static constexpr int max_depth1=20;
+	static constexpr int max_depth2=12;
+
+	//bump whenever a coordinate or table layout changes
+	static const std::uint32_t file_version=1;
+
+	//phase 2 only allows U, D & half turns
+	static constexpr int moves2[N_MOVE2]{0, 1, 2, 4, 7, 9, 10, 11, 13, 16};
+
+	//coordinate*N_MOVE+move
+	std::vector<std::uint16_t> twist_move, flip_move;
+	std::vector<std::uint16_t> slice_sorted_move;
+	std::vector<std::uint16_t> corners_move, ud_edges_move;
+
+	//lower bounds on moves left, index is slice*N+other
+	std::vector<std::uint8_t> twist_slice_prune, flip_slice_prune;
+	std::vector<std::uint8_t> twist_flip_prune;
+	std::vector<std::uint8_t> corners_slice_prune, ud_edges_slice_prune;
+
+	bool initialized=false;
+
+	//search state
+	CubieCube start;
+	int path[max_depth1+max_depth2];
+	int depth1=0;
+	std::vector<int> best;
+	int target_len=0;
+	std::chrono::steady_clock::time_point deadline;
+	bool timed_out=false;
+	long long num_nodes=0;
+
+	//same face twice or opposite faces out of order is redundant
+	static bool skipAfter(int last, int m) {
+		if(last<0) return false;
+		int lf=last/3, mf=m/3;
+		return mf==lf||mf==lf-3;
+	}
+
+	static bool isPhase2Move(int m) {
+		int f=m/3;
+		return f==CubieCube::U||f==CubieCube::D||m%3==1;
+	}
+
+#pragma region TABLES
+	void buildMoveTables() {
+		CubieCube c;
+		for(int i=0; i<N_TWIST; i++) {
+			for(int m=0; m<N_MOVE; m++) {
+				c=CubieCube(), c.setTwist(i), c.move(m);
+				twist_move[N_MOVE*i+m]=c.getTwist();
+			}
+		}
+		for(int i=0; i<N_FLIP; i++) {
+			for(int m=0; m<N_MOVE; m++) {
+				c=CubieCube(), c.setFlip(i), c.move(m);
+				flip_move[N_MOVE*i+m]=c.getFlip();
+			}
+		}
+		for(int i=0; i<N_SLICE_SORTED; i++) {
+			for(int m=0; m<N_MOVE; m++) {
+				c=CubieCube(), c.setSliceSorted(i), c.move(m);
+				slice_sorted_move[N_MOVE*i+m]=c.getSliceSorted();
+			}
+		}
+		for(int i=0; i<N_PERM; i++) {
+			for(int m=0; m<N_MOVE; m++) {
+				c=CubieCube(), c.setCorners(i), c.move(m);
+				corners_move[N_MOVE*i+m]=c.getCorners();
+			}
+		}
+		//other moves would mix in slice edges
+		for(int i=0; i<N_PERM; i++) {
+			for(int m:moves2) {
+				c=CubieCube(), c.setUDEdges(i), c.move(m);
+				ud_edges_move[N_MOVE*i+m]=c.getUDEdges();
+			}
+		}
+	}
+
+	//breadth first, one depth at a time over the whole table
+	template<typename F>
+	static void fillPrune(std::vector<std::uint8_t>& prune, int n_other, int n_slice, const int* moves, int n_moves, F next) {
+		prune.assign(n_other*n_slice, 0xff);
+		prune[0]=0;
+		int filled=1;
+		for(int d=0; filled<(int)prune.size(); d++) {
+			int found=0;
+			for(int i=0; i<(int)prune.size(); i++) {
+				if(prune[i]!=d) continue;
+
+				int s=i/n_other, o=i%n_other;
+				for(int k=0; k<n_moves; k++) {
+					int j=next(s, o, moves[k]);
+					if(prune[j]==0xff) prune[j]=d+1, found++;
+				}
+			}
+			if(!found) break;
+			filled+=found;
+		}
+	}
+
+	void buildPruneTables() {
+		int all[N_MOVE];
+		for(int m=0; m<N_MOVE; m++) all[m]=m;
+
+		fillPrune(twist_slice_prune, N_TWIST, N_SLICE, all, N_MOVE, [&] (int s, int o, int m) {
+			int s_=slice_sorted_move[N_MOVE*24*s+m]/24;
+			return N_TWIST*s_+twist_move[N_MOVE*o+m];
+		});
+		fillPrune(flip_slice_prune, N_FLIP, N_SLICE, all, N_MOVE, [&] (int s, int o, int m) {
+			int s_=slice_sorted_move[N_MOVE*24*s+m]/24;
+			return N_FLIP*s_+flip_move[N_MOVE*o+m];
+		});
+		//"slice" is twist here, ignores the slice but cuts a lot more
+		fillPrune(twist_flip_prune, N_FLIP, N_TWIST, all, N_MOVE, [&] (int s, int o, int m) {
+			return N_FLIP*twist_move[N_MOVE*s+m]+flip_move[N_MOVE*o+m];
+		});
+		fillPrune(corners_slice_prune, N_PERM, N_SLICE_PERM, moves2, N_MOVE2, [&] (int s, int o, int m) {
+			return N_PERM*slice_sorted_move[N_MOVE*s+m]+corners_move[N_MOVE*o+m];
+		});
+		fillPrune(ud_edges_slice_prune, N_PERM, N_SLICE_PERM, moves2, N_MOVE2, [&] (int s, int o, int m) {
+			return N_PERM*slice_sorted_move[N_MOVE*s+m]+ud_edges_move[N_MOVE*o+m];
+		});
+	}
+
+	void allocTables() {
+		twist_move.resize(N_TWIST*N_MOVE);
+		flip_move.resize(N_FLIP*N_MOVE);
+		slice_sorted_move.resize(N_SLICE_SORTED*N_MOVE);
+		corners_move.resize(N_PERM*N_MOVE);
+		ud_edges_move.resize(N_PERM*N_MOVE);
+
+		twist_slice_prune.resize(N_TWIST*N_SLICE);
+		flip_slice_prune.resize(N_FLIP*N_SLICE);
+		twist_flip_prune.resize(N_TWIST*N_FLIP);
+		corners_slice_prune.resize(N_PERM*N_SLICE_PERM);
+		ud_edges_slice_prune.resize(N_PERM*N_SLICE_PERM);
+	}
+
+	//f(data, bytes) in file order
+	template<typename F>
+	void forEachTable(F f) {
+		for(auto* t:{&twist_move, &flip_move, &slice_sorted_move, &corners_move, &ud_edges_move}) {
+			f((char*)t->data(), sizeof(std::uint16_t)*t->size());
+		}
+		for(auto* t:{&twist_slice_prune, &flip_slice_prune, &twist_flip_prune, &corners_slice_prune, &ud_edges_slice_prune}) {
+			f((char*)t->data(), t->size());
+		}
+	}
+
+	bool loadTables(const std::string& filename) {
+		std::ifstream file(filename, std::ios::binary);
+		if(file.fail()) return false;
+
+		std::uint32_t version=0;
+		file.read((char*)&version, sizeof(version));
+		if(!file||version!=file_version) return false;
+
+		bool ok=true;
+		forEachTable([&] (char* data, std::size_t bytes) {
+			if(ok) ok=(bool)file.read(data, bytes);
+		});
+
+		//trailing data means a different layout
+		return ok&&file.peek()==EOF;
+	}
+
+	bool saveTables(const std::string& filename) {
+		std::ofstream file(filename, std::ios::binary);
+		if(file.fail()) return false;
+
+		std::uint32_t version=file_version;
+		file.write((const char*)&version, sizeof(version));
+		forEachTable([&] (char* data, std::size_t bytes) {
+			file.write(data, bytes);
+		});
+		return !file.fail();
+	}
+#pragma endregion
+
+#pragma region SEARCH
+	int phase1Bound(int twist, int flip, int slice) const {
+		return std::max({
+			twist_slice_prune[N_TWIST*slice+twist],
+			flip_slice_prune[N_FLIP*slice+flip],
+			twist_flip_prune[N_FLIP*twist+flip]
+		});
+	}
+
+	int phase2Bound(int corners, int ud_edges, int slice_perm) const {
+		return std::max(
+			corners_slice_prune[N_PERM*slice_perm+corners],
+			ud_edges_slice_prune[N_PERM*slice_perm+ud_edges]
+		);
+	}
+
+	//true once short enough or out of time
+	bool searchPhase1(int twist, int flip, int slice_sorted, int depth, int togo) {
+		if(togo==0) {
+			//ending on a phase 2 move means a shorter phase 1 found this already
+			if(depth>0&&isPhase2Move(path[depth-1])) return false;
+
+			return startPhase2(slice_sorted);
+		}
+
+		if((++num_nodes&1023)==0&&!best.empty()) {
+			if(std::chrono::steady_clock::now()>deadline) {
+				timed_out=true;
+				return true;
+			}
+		}
+
+		int last=depth>0?path[depth-1]:-1;
+		for(int m=0; m<N_MOVE; m++) {
+			if(skipAfter(last, m)) continue;
+
+			int tw=twist_move[N_MOVE*twist+m];
+			int fl=flip_move[N_MOVE*flip+m];
+			int ss=slice_sorted_move[N_MOVE*slice_sorted+m];
+			if(phase1Bound(tw, fl, ss/24)>togo-1) continue;
+
+			path[depth]=m;
+			if(searchPhase1(tw, fl, ss, depth+1, togo-1)) return true;
+		}
+		return false;
+	}
+
+	bool startPhase2(int slice_sorted) {
+		//phase 2 coordinates dont survive phase 1 moves,
+		//  so replay them on the cubies instead.
+		CubieCube c=start;
+		for(int i=0; i<depth1; i++) c.move(path[i]);
+		int corners=c.getCorners();
+		int ud_edges=c.getUDEdges();
+
+		int max_len=std::min(max_depth2, (best.empty()?max_depth1+max_depth2:(int)best.size()-1)-depth1);
+		for(int d2=phase2Bound(corners, ud_edges, slice_sorted); d2<=max_len; d2++) {
+			if(searchPhase2(corners, ud_edges, slice_sorted, depth1, d2)) {
+				best.assign(path, path+depth1+d2);
+				return (int)best.size()<=target_len;
+			}
+		}
+		return false;
+	}
+
+	bool searchPhase2(int corners, int ud_edges, int slice_perm, int depth, int togo) {
+		if(togo==0) return true;
+
+		int last=depth>0?path[depth-1]:-1;
+		for(int m:moves2) {
+			if(skipAfter(last, m)) continue;
+
+			int co=corners_move[N_MOVE*corners+m];
+			int ud=ud_edges_move[N_MOVE*ud_edges+m];
+			int sp=slice_sorted_move[N_MOVE*slice_perm+m];
+			if(phase2Bound(co, ud, sp)>togo-1) continue;
+
+			path[depth]=m;
+			if(searchPhase2(co, ud, sp, depth+1, togo-1)) return true;
+		}
+		return false;
+	}
+#pragma endregion
+
+public:
+	//tables from disk, else built & saved
+	void init(const std::string& filename="assets/twophase.bin") {
+		if(initialized) return;
+
+		allocTables();
+		if(!loadTables(filename)) {
+			buildMoveTables();
+			buildPruneTables();
+			saveTables(filename);
+		}
+		initialized=true;
+	}
+
+	bool isInitialized() const { return initialized; }
+
+	//face moves as face*3+power-1.
+	//  stops at the first solution w/in max_len, or at the
+	//  best one once time runs out. empty if unsolvable.
+	bool solve(const CubieCube& c, std::vector<int>& moves, int max_len=21, float timeout_ms=50) {
+		moves.clear();
+		if(!c.isSolvable()) return false;
+
+		init();
+
+		start=c;
+		best.clear();
+		target_len=max_len;
+		timed_out=false;
+		num_nodes=0;
+		deadline=std::chrono::steady_clock::now()+std::chrono::microseconds((long long)(1000*timeout_ms));
+
+		int twist=c.getTwist(), flip=c.getFlip();
+		int slice_sorted=c.getSliceSorted();
+		for(depth1=phase1Bound(twist, flip, slice_sorted/24); depth1<=max_depth1; depth1++) {
+			if(searchPhase1(twist, flip, slice_sorted, 0, depth1)) break;
+
+			//cant beat what we have
+			if(!best.empty()&&depth1>=(int)best.size()-1) break;
+		}
+
+		moves=best;
+		return true;
+	}
+
+	//read the grid & turn the answer into queueable turns
+	bool solve(const RubiksCube& rc, std::vector<Turn>& turns, int max_len=21, float timeout_ms=50) {
+		turns.clear();
+		CubieCube c;
+		if(!c.fromCube(rc)) return false;
+
+		std::vector<int> moves;
+		if(!solve(c, moves, max_len, timeout_ms)) return false;
+
+		for(const auto& m:moves) CubieCube::toTurns(m, turns);
+		return true;
+	}
+};
+#endif
\ No newline at end of file
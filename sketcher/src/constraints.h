@@ -64,14 +64,15 @@ namespace constrain {
 	}
 };
 
+//indexes into the point array
 struct DistConstraint {
-	cmn::vf2d* a, * b;
+	int a, b;
 	float len;
 	float rgb[3];
 };
 
 struct AngleConstraint {
-	cmn::vf2d* a, * b, * c, * d;
+	int a, b, c, d;
 	float angle;
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,434 @@
+#pragma once
+#ifndef LM_SOLVER_CLASS_H
+#define LM_SOLVER_CLASS_H
+
+//every constraint solved at once.
+//  levenberg-marquardt steps on the sparse constraint jacobian.
+//  the damped normal equations are factored w/ an envelope cholesky,
+//  after a reverse cuthill-mckee ordering keeps the envelope narrow.
+//  angle rows are scaled by their segment lengths so
+//  every residual is roughly in pixels.
+
+#include "cmn/math/v2d.h"
+
+//for Pi
+#include "cmn/utils.h"
+
+#include <vector>
+
+#include <cmath>
+
+//for max
+#include <algorithm>
+
+//for FLT_EPSILON
+#include <cfloat>
+
+class LMSolver {
+	enum RowType {
+		DIST,
+		MIN_DIST,
+		ANGLE
+	};
+
+	struct Row {
+		RowType type;
+		int ids[4];
+		double target;
+
+		//angles are in radians, so this puts them in pixels
+		double weight=1;
+	};
+
+	//at most 4 points, 2 coords each
+	static const int max_row_entries=8;
+
+	struct Entry {
+		int col;
+		double val;
+	};
+
+	std::vector<Row> _rows;
+
+	//entries of row r are [max_row_entries*r, +_row_len[r])
+	std::vector<Entry> _entries;
+	std::vector<int> _row_len;
+
+	//coords, & the ones being tried
+	std::vector<double> _x, _x_try;
+	std::vector<double> _res, _res_try;
+
+	std::vector<double> _grad, _step;
+
+	//point ordering, new to old & old to new
+	std::vector<int> _perm, _inv;
+	std::vector<int> _adj_start, _adj_ids, _adj_slot;
+	std::vector<int> _by_degree;
+
+	//permuted coord row i keeps columns [_first[i], i],
+	//  starting at _row_off[i] in _jtj & _chol
+	std::vector<int> _first, _row_off;
+	std::vector<double> _jtj, _chol;
+	std::vector<double> _rhs;
+
+	double _lambda=1e-3;
+
+	//half sum of squares
+	double evaluate(const std::vector<double>& x, std::vector<double>& res) const {
+		double cost=0;
+		for(int r=0; r<_rows.size(); r++) {
+			const auto& row=_rows[r];
+			const int* id=row.ids;
+			double f=0;
+			switch(row.type) {
+				case DIST: case MIN_DIST: {
+					double dx=x[2*id[1]]-x[2*id[0]];
+					double dy=x[1+2*id[1]]-x[1+2*id[0]];
+					f=std::sqrt(dx*dx+dy*dy)-row.target;
+
+					//only pushes
+					if(row.type==MIN_DIST&&f>0) f=0;
+					break;
+				}
+				case ANGLE: {
+					double ux=x[2*id[1]]-x[2*id[0]], uy=x[1+2*id[1]]-x[1+2*id[0]];
+					double vx=x[2*id[3]]-x[2*id[2]], vy=x[1+2*id[3]]-x[1+2*id[2]];
+					double curr=std::atan2(ux*vy-uy*vx, ux*vx+uy*vy);
+					f=row.weight*std::remainder(curr-row.target, 2*cmn::Pi);
+					break;
+				}
+			}
+			res[r]=f;
+			cost+=f*f/2;
+		}
+		return cost;
+	}
+
+	//merges repeats, skips the pinned point
+	void addEntry(int r, int pt, double dx, double dy, int pinned) {
+		if(pt==pinned) return;
+
+		Entry* e=&_entries[max_row_entries*r];
+		int& len=_row_len[r];
+		for(int k=0; k<len; k++) {
+			if(e[k].col==2*pt) {
+				e[k].val+=dx, e[k+1].val+=dy;
+				return;
+			}
+		}
+		e[len++]={2*pt, dx};
+		e[len++]={2*pt+1, dy};
+	}
+
+	void buildJacobian(const std::vector<double>& x, int pinned) {
+		_entries.resize(max_row_entries*_rows.size());
+		_row_len.assign(_rows.size(), 0);
+		for(int r=0; r<_rows.size(); r++) {
+			const auto& row=_rows[r];
+			const int* id=row.ids;
+			switch(row.type) {
+				case DIST: case MIN_DIST: {
+					//inactive
+					if(row.type==MIN_DIST&&_res[r]==0) break;
+
+					double dx=x[2*id[1]]-x[2*id[0]];
+					double dy=x[1+2*id[1]]-x[1+2*id[0]];
+					double len=std::sqrt(dx*dx+dy*dy);
+
+					//safe norm
+					double nx=1, ny=0;
+					if(len>1e-9) nx=dx/len, ny=dy/len;
+					addEntry(r, id[0], -nx, -ny, pinned);
+					addEntry(r, id[1], nx, ny, pinned);
+					break;
+				}
+				case ANGLE: {
+					double ux=x[2*id[1]]-x[2*id[0]], uy=x[1+2*id[1]]-x[1+2*id[0]];
+					double vx=x[2*id[3]]-x[2*id[2]], vy=x[1+2*id[3]]-x[1+2*id[2]];
+					double uu=ux*ux+uy*uy, vv=vx*vx+vy*vy;
+					if(uu<1e-12||vv<1e-12) break;
+
+					//angle from u to v is angle(v)-angle(u)
+					double w=row.weight;
+					double gux=w*uy/uu, guy=-w*ux/uu;
+					double gvx=-w*vy/vv, gvy=w*vx/vv;
+					addEntry(r, id[0], -gux, -guy, pinned);
+					addEntry(r, id[1], gux, guy, pinned);
+					addEntry(r, id[2], -gvx, -gvy, pinned);
+					addEntry(r, id[3], gvx, gvy, pinned);
+					break;
+				}
+			}
+		}
+	}
+
+	//reverse cuthill-mckee over points, then the envelope
+	void analyze(int num_pts) {
+		//points sharing a row, both ways
+		_adj_start.assign(num_pts+1, 0);
+		auto forPairs=[&] (auto f) {
+			for(const auto& row:_rows) {
+				const int num=row.type==ANGLE?4:2;
+				for(int i=0; i<num; i++) {
+					for(int j=0; j<num; j++) {
+						if(row.ids[i]!=row.ids[j]) f(row.ids[i], row.ids[j]);
+					}
+				}
+			}
+		};
+		forPairs([&] (int p, int) { _adj_start[1+p]++; });
+		for(int i=0; i<num_pts; i++) _adj_start[i+1]+=_adj_start[i];
+		_adj_ids.resize(_adj_start[num_pts]);
+		_adj_slot.assign(_adj_start.begin(), _adj_start.end()-1);
+		forPairs([&] (int p, int q) { _adj_ids[_adj_slot[p]++]=q; });
+
+		auto degree=[&] (int p) { return _adj_start[p+1]-_adj_start[p]; };
+
+		_by_degree.resize(num_pts);
+		for(int p=0; p<num_pts; p++) _by_degree[p]=p;
+		std::stable_sort(_by_degree.begin(), _by_degree.end(), [&] (int a, int b) {
+			return degree(a)<degree(b);
+		});
+
+		//bfs from the lowest degree point left, neighbors by degree
+		_perm.clear();
+		_inv.assign(num_pts, -1);
+		for(const auto& start:_by_degree) {
+			if(_inv[start]!=-1) continue;
+
+			_inv[start]=_perm.size();
+			_perm.push_back(start);
+			for(int k=_inv[start]; k<_perm.size(); k++) {
+				const int p=_perm[k];
+				const int first=_perm.size();
+				for(int a=_adj_start[p]; a<_adj_start[p+1]; a++) {
+					const int q=_adj_ids[a];
+					if(_inv[q]!=-1) continue;
+
+					_inv[q]=_perm.size();
+					_perm.push_back(q);
+				}
+				std::sort(_perm.begin()+first, _perm.end(), [&] (int a, int b) {
+					return degree(a)<degree(b);
+				});
+				for(int i=first; i<_perm.size(); i++) _inv[_perm[i]]=i;
+			}
+		}
+		std::reverse(_perm.begin(), _perm.end());
+		for(int i=0; i<num_pts; i++) _inv[_perm[i]]=i;
+
+		//leftmost column each coord row touches
+		const int n=2*num_pts;
+		_first.resize(n);
+		_row_off.resize(n+1);
+		_row_off[0]=0;
+		for(int i=0; i<num_pts; i++) {
+			const int p=_perm[i];
+			int lo=i;
+			for(int a=_adj_start[p]; a<_adj_start[p+1]; a++) {
+				lo=std::min(lo, _inv[_adj_ids[a]]);
+			}
+			_first[2*i]=_first[1+2*i]=2*lo;
+			_row_off[1+2*i]=_row_off[2*i]+2*i-2*lo+1;
+			_row_off[2+2*i]=_row_off[1+2*i]+2*i-2*lo+2;
+		}
+	}
+
+	//permuted coord
+	int newCol(int col) const {
+		return 2*_inv[col/2]+col%2;
+	}
+
+	double& envAt(std::vector<double>& env, int i, int j) {
+		return env[_row_off[i]+j-_first[i]];
+	}
+
+	//J^T*J & the gradient
+	void assemble() {
+		const int n=_first.size();
+		_jtj.assign(_row_off[n], 0);
+		_grad.assign(n, 0);
+		for(int r=0; r<_rows.size(); r++) {
+			const Entry* e=&_entries[max_row_entries*r];
+			const int len=_row_len[r];
+			for(int k=0; k<len; k++) {
+				const int ck=newCol(e[k].col);
+				_grad[ck]+=e[k].val*_res[r];
+				for(int l=0; l<=k; l++) {
+					const int cl=newCol(e[l].col);
+					double v=e[k].val*e[l].val;
+					if(ck>=cl) envAt(_jtj, ck, cl)+=v;
+					else envAt(_jtj, cl, ck)+=v;
+				}
+			}
+		}
+	}
+
+	//step=-(J^T*J+lambda)^-1*grad, back in original coords
+	void solveStep() {
+		const int n=_first.size();
+		_chol=_jtj;
+		for(int i=0; i<n; i++) envAt(_chol, i, i)+=_lambda;
+
+		//row by row, only inside the envelope
+		for(int i=0; i<n; i++) {
+			const int fi=_first[i];
+			double* li=&_chol[_row_off[i]-fi];
+			for(int j=fi; j<=i; j++) {
+				const int fj=_first[j];
+				const double* lj=&_chol[_row_off[j]-fj];
+				double s=li[j];
+				for(int k=std::max(fi, fj); k<j; k++) s-=li[k]*lj[k];
+				if(j<i) li[j]=s/lj[j];
+				else li[i]=std::sqrt(std::max(s, 1e-300));
+			}
+		}
+
+		//forward, then backward
+		_rhs.resize(n);
+		for(int i=0; i<n; i++) {
+			const int fi=_first[i];
+			const double* li=&_chol[_row_off[i]-fi];
+			double s=-_grad[i];
+			for(int k=fi; k<i; k++) s-=li[k]*_rhs[k];
+			_rhs[i]=s/li[i];
+		}
+		for(int i=n-1; i>=0; i--) {
+			const int fi=_first[i];
+			const double* li=&_chol[_row_off[i]-fi];
+			_rhs[i]/=li[i];
+			for(int k=fi; k<i; k++) _rhs[k]-=li[k]*_rhs[i];
+		}
+
+		_step.resize(n);
+		for(int c=0; c<n; c++) _step[c]=_rhs[newCol(c)];
+	}
+
+	//also sets angle weights from the current lengths
+	void loadPoints(const std::vector<cmn::vf2d>& pts) {
+		_x.resize(2*pts.size());
+		for(int i=0; i<pts.size(); i++) {
+			_x[2*i]=pts[i].x;
+			_x[1+2*i]=pts[i].y;
+		}
+
+		for(auto& row:_rows) {
+			if(row.type!=ANGLE) continue;
+
+			const int* id=row.ids;
+			double u=(pts[id[1]]-pts[id[0]]).mag();
+			double v=(pts[id[3]]-pts[id[2]]).mag();
+			row.weight=std::sqrt(u*v);
+		}
+	}
+
+	static double maxAbs(const std::vector<double>& v) {
+		double m=0;
+		for(const auto& f:v) m=std::max(m, std::abs(f));
+		return m;
+	}
+
+public:
+	int max_iterations=10;
+
+	//largest residual allowed, in pixels
+	double tolerance=1e-3;
+
+	//points are floats, so far from the origin they cant
+	//  get closer than a few ulps of their largest coord.
+	double rel_tolerance=4*FLT_EPSILON;
+
+	//from the last solve
+	double residual=0;
+	int iterations=0;
+
+	void clear() {
+		_rows.clear();
+	}
+
+	int getNumRows() const { return _rows.size(); }
+
+	void addDist(int a, int b, float len) {
+		_rows.push_back({DIST, {a, b, 0, 0}, len});
+	}
+
+	//only keeps a & b from getting closer than len
+	void addMinDist(int a, int b, float len) {
+		_rows.push_back({MIN_DIST, {a, b, 0, 0}, len});
+	}
+
+	//from b-a to d-c
+	void addAngle(int a, int b, int c, int d, float angle) {
+		_rows.push_back({ANGLE, {a, b, c, d}, angle});
+	}
+
+	//what pts can actually be solved to
+	double getTolerance(const std::vector<cmn::vf2d>& pts) const {
+		double m=0;
+		for(const auto& p:pts) m=std::max({m, std::abs(double(p.x)), std::abs(double(p.y))});
+		return std::max(tolerance, rel_tolerance*m);
+	}
+
+	//largest residual of the rows so far
+	double measure(const std::vector<cmn::vf2d>& pts) {
+		loadPoints(pts);
+		_res.resize(_rows.size());
+		evaluate(_x, _res);
+		return maxAbs(_res);
+	}
+
+	//pinned stays put. returns whether getTolerance was reached.
+	//  residual is measured on pts after the write back.
+	bool solve(std::vector<cmn::vf2d>& pts, int pinned=-1) {
+		loadPoints(pts);
+		const int n=_x.size();
+		_res.resize(_rows.size());
+		_res_try.resize(_rows.size());
+		double cost=evaluate(_x, _res);
+		residual=maxAbs(_res);
+		iterations=0;
+
+		const double tol=getTolerance(pts);
+		if(residual<=tol) return true;
+
+		//leave room for rounding to float
+		const double inner_tol=tol-2*FLT_EPSILON*maxAbs(_x);
+		analyze(pts.size());
+		while(residual>inner_tol&&iterations<max_iterations) {
+			iterations++;
+
+			buildJacobian(_x, pinned);
+			assemble();
+
+			//damp more until the cost goes down
+			bool accepted=false;
+			for(int tries=0; tries<8&&!accepted; tries++) {
+				solveStep();
+
+				_x_try.resize(n);
+				for(int i=0; i<n; i++) _x_try[i]=_x[i]+_step[i];
+				double cost_try=evaluate(_x_try, _res_try);
+				if(cost_try<cost) {
+					accepted=true;
+					std::swap(_x, _x_try);
+					std::swap(_res, _res_try);
+					cost=cost_try;
+					_lambda=std::max(1e-9, _lambda/10);
+				} else _lambda=std::min(1e9, 4*_lambda);
+			}
+			if(!accepted) break;
+
+			residual=maxAbs(_res);
+		}
+
+		for(int i=0; i<pts.size(); i++) {
+			pts[i].x=_x[2*i];
+			pts[i].y=_x[1+2*i];
+		}
+
+		residual=measure(pts);
+		return residual<=tol;
+	}
+
+};
+#endif
\ No newline at end of file
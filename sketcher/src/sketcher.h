@@ -4,6 +4,7 @@
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -12,19 +13,33 @@
 
 #include "shd.glsl.h"
 
-#include <list>
 #include <vector>
 #include <string>
 
 //for time
 #include <ctime>
 
+//for uint32_t
+#include <cstdint>
+
+#include <iostream>
+
 #include "cmn/math/v2d.h"
 
 #include "constraints.h"
 
+#include "lm_solver.h"
+
 #include "cmn/utils.h"
 
+#include "cmn/random.h"
+
+#include "cmn/thread_pool.h"
+
+#include "cmn/edge_coloring.h"
+
+#include "cmn/stopwatch.h"
+
 #include "sokol/render_utils.h"
 
 #include "imgui/include/imgui_singleheader.h"
@@ -59,10 +74,7 @@ static void hsv2rgb(
 //fisher-yates shuffle
 template<typename T>
 void shuffle(std::vector<T>& vec) {
-	for(int i=vec.size()-1; i>=1; i--) {
-		int j=std::rand()%(i+1);
-		std::swap(vec[i], vec[j]);
-	}
+	cmn::Random::local().shuffle(vec.data(), vec.size());
 }
 
 class Sketcher : public cmn::SokolEngine {
@@ -79,13 +91,39 @@ class Sketcher : public cmn::SokolEngine {
 	} outline_render;
 
 	//scene stuff
-	std::list<vf2d> points;
-	vf2d* held_pt=nullptr;
+	std::vector<vf2d> points;
+	int held_ix=-1;
 	float point_rad=7.5f;
 	bool push_pts_apart=true;
 
-	std::list<DistConstraint> dist_constraints;
-	std::list<AngleConstraint> angle_constraints;
+	std::vector<DistConstraint> dist_constraints;
+	std::vector<AngleConstraint> angle_constraints;
+
+	//solve orders, reshuffled once per frame
+	std::vector<int> point_order;
+	std::vector<int> angle_order;
+
+	//dist constraint ids grouped by color, no two in a color share
+	//  a point. color c spans [dist_color_start[c], dist_color_start[c+1])
+	std::vector<int> dist_order;
+	std::vector<int> dist_color_start;
+	std::vector<int> dist_color_order;
+
+	//point ids sorted by hashed cell, bucket h spans
+	//  [cell_start[h], cell_start[h+1])
+	std::vector<int> point_cell;
+	std::vector<int> cell_start, cell_slot;
+	std::vector<int> cell_ids;
+
+	//null uses the shared pool
+	cmn::ThreadPool* pool=nullptr;
+
+	static const int dist_grain=256;
+	static const int num_iterations=25;
+
+	//everything at once instead of projections
+	bool use_global_solver=false;
+	LMSolver lm_solver;
 
 	//graphics stuff
 	bool render_grid=true;
@@ -118,7 +156,7 @@ public:
 	void setupOutlineRender() {
 		sg_pipeline_desc pip_desc{};
 		pip_desc.layout.attrs[ATTR_outline_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(outline_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(outline_shader_desc(getBackend()));
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 		outline_render.pip=sg_make_pipeline(pip_desc);
 
@@ -130,7 +168,7 @@ public:
 
 	//generalized hoberman linkage construction
 	void makeHobermanLinkage(int num, float len) {
-		held_pt=nullptr;
+		held_ix=-1;
 
 		if(num<3) return;
 
@@ -145,9 +183,8 @@ public:
 		//starting dist from ctr
 		const float rad=len*std::sin(alpha/4)/std::sin(beta/2);
 
-		//allocate and insert into lookup
+		//point i, j is at 3*i+j
 		points.clear();
-		vf2d** grid=new vf2d*[3*num];
 		auto ix=[] (int i, int j) { return 3*i+j; };
 		for(int i=0; i<num; i++) {
 			float angle1=2*cmn::Pi*i/num;
@@ -157,10 +194,7 @@ public:
 			p[0]=ctr+vf2d::polar({rad, angle1});
 			p[1]=p[0]+vf2d::polar({len, angle2});
 			p[2]=p[1]+vf2d::polar({len, angle3});
-			for(int j=0; j<3; j++) {
-				points.push_back(p[j]);
-				grid[ix(i, j)]=&points.back();
-			}
+			for(int j=0; j<3; j++) points.push_back(p[j]);
 		}
 
 		auto randCol=[&] (float& r, float& g, float& b) {
@@ -171,22 +205,22 @@ public:
 		};
 
 		//branch out
-		std::list<DistConstraint> dist_top, dist_btm;
+		std::vector<DistConstraint> dist_top, dist_btm;
 		angle_constraints.clear();
 		float r, g, b;
 		for(int i=0; i<num; i++) {
-			auto& c=grid[ix(i, 0)];
+			int c=ix(i, 0);
 			//next 2
-			auto& n1=grid[ix(i, 1)];
-			auto& n2=grid[ix(i, 2)];
+			int n1=ix(i, 1);
+			int n2=ix(i, 2);
 			randCol(r, g, b);
 			dist_top.push_back({c, n1, len, {r, g, b}});
 			dist_top.push_back({n1, n2, len, {r, g, b}});
 			angle_constraints.push_back({c, n1, n1, n2, delta});
 
 			//previous 2
-			auto& p1=grid[ix((i+num-1)%num, 1)];
-			auto& p2=grid[ix((i+num-2)%num, 2)];
+			int p1=ix((i+num-1)%num, 1);
+			int p2=ix((i+num-2)%num, 2);
 			randCol(r, g, b);
 			dist_btm.push_back({c, p1, len, {r, g, b}});
 			dist_btm.push_back({p1, p2, len, {r, g, b}});
@@ -198,7 +232,7 @@ public:
 		for(const auto& t:dist_top) dist_constraints.push_back(t);
 		for(const auto& b:dist_btm) dist_constraints.push_back(b);
 
-		delete[] grid;
+		buildSolveOrders();
 	}
 
 	void setupScene() {
@@ -236,6 +270,7 @@ public:
 		app_title="Sketcher";
 
 		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		setupSampler();
 
@@ -262,76 +297,260 @@ public:
 
 		const auto action=GetMouse(SAPP_MOUSEBUTTON_LEFT);
 		if(action.pressed) {
-			held_pt=nullptr;
+			held_ix=-1;
 
 			float record=-1;
-			for(auto& p:points) {
-				float d=(p-mouse_pos).mag();
+			for(int i=0; i<points.size(); i++) {
+				float d=(points[i]-mouse_pos).mag();
 				if(d<10) {
 					if(record<0||d<record) {
-						held_pt=&p;
+						held_ix=i;
 					}
 				}
 			}
 		}
-		if(action.held&&held_pt) *held_pt=mouse_pos;
-		if(action.released) held_pt=nullptr;
+		if(action.held&&held_ix!=-1) points[held_ix]=mouse_pos;
+		if(action.released) held_ix=-1;
 	}
 
-	//keep from overlapping
-	void pushPointsApart() {
-		//accumulate references
-		std::vector<vf2d*> pts_ref;
-		for(auto& p:points) pts_ref.push_back(&p);
+	//linear in i, so cells i-1, i & i+1 land in buckets h-1, h & h+1 mod size.
+	//  size is a power of 2, so 32 bit wrapping keeps that true across 0.
+	//  w/ at least min_buckets, the 9 cells around a point never share one.
+	static int hashCell(int i, int j, int size) {
+		std::uint32_t h=std::uint32_t(i)+1619u*std::uint32_t(j);
+		return h&(size-1);
+	}
 
-		shuffle(pts_ref);
+	static const int min_buckets=3+2*1619;
 
-		//check against every other
-		float min_dist=2*point_rad;
-		for(int i=0; i<pts_ref.size(); i++) {
-			auto& a=*pts_ref[i];
-			for(int j=1+i; j<pts_ref.size(); j++) {
-				auto& b=*pts_ref[j];
-
-				//push apart if too close
-				float mag_sq=(b-a).mag_sq();
-				if(mag_sq<min_dist*min_dist) {
-					constrain::dist(a, b, min_dist);
+	//counting sort of points by hashed cell
+	void fillCells(float cell_sz) {
+		const int num=points.size();
+		int size=1;
+		while(size<std::max(2*num, int(min_buckets))) size*=2;
+		point_cell.resize(num);
+		for(int i=0; i<num; i++) {
+			int cx=std::floor(points[i].x/cell_sz);
+			int cy=std::floor(points[i].y/cell_sz);
+			point_cell[i]=hashCell(cx, cy, size);
+		}
+
+		cell_start.assign(size+1, 0);
+		for(int i=0; i<num; i++) cell_start[1+point_cell[i]]++;
+		for(int h=0; h<size; h++) cell_start[h+1]+=cell_start[h];
+
+		cell_ids.resize(num);
+		cell_slot.assign(cell_start.begin(), cell_start.end()-1);
+		for(int i=0; i<num; i++) cell_ids[cell_slot[point_cell[i]]++]=i;
+	}
+
+	//f(i, j) for every pair that might be closer than min_dist
+	template<typename Func>
+	void forEachNearbyPair(float min_dist, Func f) {
+		//cells as big as the min dist, so only neighbors can touch
+		fillCells(min_dist);
+
+		const int size=cell_start.size()-1;
+		for(const auto& i:point_order) {
+			const auto& a=points[i];
+			auto scan=[&] (int k0, int k1) {
+				for(int k=k0; k<k1; k++) {
+					//each pair once
+					const int j=cell_ids[k];
+					if(j>i) f(i, j);
+				}
+			};
+
+			int cx=std::floor(a.x/min_dist);
+			int cy=std::floor(a.y/min_dist);
+			for(int dy=-1; dy<=1; dy++) {
+				//cells cx-1 to cx+1 are one run, unless it wraps
+				int h=hashCell(cx-1, cy+dy, size);
+				if(h+3<=size) scan(cell_start[h], cell_start[h+3]);
+				else {
+					scan(cell_start[h], cell_start[size]);
+					scan(cell_start[0], cell_start[h+3-size]);
 				}
 			}
 		}
 	}
 
-	void updateDistConstraints() {
-		//randomize order
-		std::vector<DistConstraint*> dist_refs;
-		for(auto& d:dist_constraints) dist_refs.push_back(&d);
-		shuffle(dist_refs);
+	//keep from overlapping
+	void pushPointsApart() {
+		float min_dist=2*point_rad;
+		forEachNearbyPair(min_dist, [&] (int i, int j) {
+			auto& a=points[i], & b=points[j];
+
+			//push apart if too close
+			float mag_sq=(b-a).mag_sq();
+			if(mag_sq<min_dist*min_dist) {
+				constrain::dist(a, b, min_dist);
+			}
+		});
+	}
+
+	//greedy dist constraint coloring, & fresh solve orders
+	void buildSolveOrders() {
+		const int num_pts=points.size();
+		const int num_dist=dist_constraints.size();
+
+		cmn::colorEdges(num_pts, num_dist, [&] (int c) {
+			const auto& d=dist_constraints[c];
+			return std::make_pair(d.a, d.b);
+		}, dist_order, dist_color_start);
+		const int num_colors=dist_color_start.size()-1;
+
+		dist_color_order.resize(num_colors);
+		for(int i=0; i<num_colors; i++) dist_color_order[i]=i;
 
-		for(const auto& d:dist_refs) {
-			constrain::dist(*d->a, *d->b, d->len);
+		point_order.resize(num_pts);
+		for(int i=0; i<num_pts; i++) point_order[i]=i;
+
+		angle_order.resize(angle_constraints.size());
+		for(int i=0; i<angle_order.size(); i++) angle_order[i]=i;
+	}
+
+	//instead of every iteration
+	void shuffleSolveOrders() {
+		shuffle(point_order);
+		shuffle(dist_color_order);
+		shuffle(angle_order);
+	}
+
+	void updateDistConstraints() {
+		cmn::ThreadPool& p=pool?*pool:cmn::ThreadPool::shared();
+
+		//a color never shares a point, so it can go in parallel
+		for(const auto& c:dist_color_order) {
+			p.parallelFor(dist_color_start[c], dist_color_start[c+1], dist_grain, [&] (int k0, int k1) {
+				for(int k=k0; k<k1; k++) {
+					const auto& d=dist_constraints[dist_order[k]];
+					constrain::dist(points[d.a], points[d.b], d.len);
+				}
+			});
 		}
 	}
 
 	void updateAngleConstraints() {
-		//randomize order
-		std::vector<AngleConstraint*> angle_refs;
-		for(auto& a:angle_constraints) angle_refs.push_back(&a);
-		shuffle(angle_refs);
+		for(const auto& i:angle_order) {
+			const auto& a=angle_constraints[i];
+			constrain::angle(points[a.a], points[a.b], points[a.c], points[a.d], a.angle);
+		}
+	}
 
-		for(const auto& a:angle_refs) {
-			constrain::angle(*a->a, *a->b, *a->c, *a->d, a->angle);
+	void solveIteration() {
+		if(push_pts_apart) pushPointsApart();
+		updateDistConstraints();
+		updateAngleConstraints();
+	}
+
+	//every constraint as a row, & overlaps as one sided rows
+	void buildGlobalRows() {
+		lm_solver.clear();
+		for(const auto& d:dist_constraints) {
+			lm_solver.addDist(d.a, d.b, d.len);
 		}
+		for(const auto& a:angle_constraints) {
+			lm_solver.addAngle(a.a, a.b, a.c, a.d, a.angle);
+		}
+
+		if(push_pts_apart) {
+			float min_dist=2*point_rad;
+			forEachNearbyPair(min_dist, [&] (int i, int j) {
+				if((points[j]-points[i]).mag_sq()<min_dist*min_dist) {
+					lm_solver.addMinDist(i, j, min_dist);
+				}
+			});
+		}
+	}
+
+	void solveGlobal() {
+		buildGlobalRows();
+		lm_solver.solve(points, held_ix);
+	}
+
+	//big linkages timed over a few frames, then the scene is reset
+	void benchmarkSolver() {
+		const int num_frames=20;
+		std::cout<<"solver benchmark, "<<num_iterations<<" iterations/frame:\n";
+		for(const auto& num:{100, 1000, 3400}) {
+			makeHobermanLinkage(num, 40);
+
+			cmn::Stopwatch watch;
+			watch.start();
+			for(int f=0; f<num_frames; f++) {
+				shuffleSolveOrders();
+				for(int i=0; i<num_iterations; i++) solveIteration();
+			}
+			watch.stop();
+
+			std::cout<<"  "<<points.size()<<" points: "<<watch.getMicros()/1000.f/num_frames<<" ms/frame\n";
+		}
+
+		benchmarkConvergence();
+
+		setupScene();
+	}
+
+	//cpu time for both solvers to fix the same jostled linkages.
+	//  both are measured on the float points, to a tolerance they can hold.
+	void benchmarkConvergence() {
+		const int max_frames=400;
+		const bool push=push_pts_apart;
+		push_pts_apart=false;
+
+		std::cout<<"convergence, max residual of the float points:\n";
+		for(const auto& num:{100, 1000, 3400}) {
+			makeHobermanLinkage(num, 40);
+			for(auto& p:points) p+=vf2d(cmn::randFloat(-5, 5), cmn::randFloat(-5, 5));
+			const std::vector<vf2d> start=points;
+			buildGlobalRows();
+			const double tol=lm_solver.getTolerance(points);
+			std::cout<<"  "<<points.size()<<" points, to "<<tol<<" px:\n";
+
+			//projection loop, a frame at a time
+			cmn::Stopwatch watch;
+			watch.start();
+			int frames=0;
+			double res=lm_solver.measure(points);
+			while(res>tol&&frames<max_frames) {
+				shuffleSolveOrders();
+				for(int i=0; i<num_iterations; i++) solveIteration();
+				frames++;
+				res=lm_solver.measure(points);
+			}
+			watch.stop();
+			std::cout<<"    projection: "
+				<<frames<<" frames, residual "<<res<<", "
+				<<watch.getMicros()/1000.f<<" ms\n";
+
+			points=start;
+			watch.start();
+			lm_solver.solve(points);
+			watch.stop();
+			std::cout<<"    levenberg-marquardt: "
+				<<lm_solver.iterations<<" iterations, residual "<<lm_solver.residual<<", "
+				<<watch.getMicros()/1000.f<<" ms\n";
+		}
+
+		push_pts_apart=push;
 	}
 #pragma endregion
 
 	bool user_update(float dt) override {
-		for(int i=0; i<25; i++) {
+		if(GetKey(SAPP_KEYCODE_B).pressed) benchmarkSolver();
+
+		if(use_global_solver) {
 			handlePointMovement();
 
-			if(push_pts_apart) pushPointsApart();
-			updateDistConstraints();
-			updateAngleConstraints();
+			solveGlobal();
+		} else {
+			shuffleSolveOrders();
+			for(int i=0; i<num_iterations; i++) {
+				handlePointMovement();
+
+				solveIteration();
+			}
 		}
 
 		return true;
@@ -407,8 +626,9 @@ public:
 		//alpha=1 = foreground(outlines)
 
 		for(const auto& d:dist_constraints) {
+			const auto& a=points[d.a], & b=points[d.b];
 			cmn::draw_thick_line(
-				d.a->x, d.a->y, d.b->x, d.b->y,
+				a.x, a.y, b.x, b.y,
 				2*point_rad,
 				d.rgb[0], d.rgb[1], d.rgb[2], 1
 			);
@@ -478,6 +698,10 @@ public:
 			static int num=5;
 			
 			ImGui::Checkbox("Push Points Apart", &push_pts_apart);
+			ImGui::Checkbox("Global Solver", &use_global_solver);
+			if(use_global_solver) {
+				ImGui::Text("residual: %.5f px in %d iterations", lm_solver.residual, lm_solver.iterations);
+			}
 			ImGui::SetNextItemWidth(100);
 			ImGui::SliderFloat("Point Radius", &point_rad, 5, 15);
 			ImGui::SetNextItemWidth(100);
@@ -489,6 +713,7 @@ public:
 				float len=min_len+t*(max_len-min_len);
 				makeHobermanLinkage(num, len);
 			}
+			ImGui::Text("Press B to benchmark the solver");
 			imguiing|=ImGui::GetIO().WantCaptureMouse;
 		}
 		ImGui::End();
@@ -8,6 +8,8 @@
 
 #include "prism.h"
 
+#include "cmn/math/mat4_batch.h"
+
 //for memset & memcpy
 #include <cstring>
 
@@ -17,10 +19,9 @@ VoxelSet meshToVoxels(const Mesh& m, cmn::vf3d res) {
 	//get global mesh dimensions
 	const cmn::vf3d inf(1e300, 1e300, 1e300);
 	cmn::AABBf3 box{inf, -inf};
-	for(const auto& v:m.verts) {
-		float w=1;
-		box.fitToEnclose(matMulVec(m.model, v, w));
-	}
+	cmn::forEachTransformedPoint(m.model, m.verts.data(), m.verts.size(), [&] (const cmn::vf3d& v) {
+		box.fitToEnclose(v);
+	});
 
 	//determine sizing
 	cmn::vf3d size=box.max-box.min;
@@ -16,6 +16,8 @@
 
 #include <sstream>
 
+#include "cmn/obj_loader.h"
+
 struct IndexTriangle {
 	int a=0, b=0, c=0;
 };
@@ -126,40 +128,19 @@ struct Mesh {
 	}
 
 	static bool loadFromOBJ(Mesh& m, const std::string& filename) {
-		std::ifstream file(filename);
-		if(file.fail()) return false;
-		
+		cmn::OBJMesh obj;
+		if(!cmn::loadOBJCached(obj, filename)) return false;
+
 		m={};
 
-		//parse file line by line
-		std::string line;
-		while(std::getline(file, line)) {
-			std::stringstream line_str(line);
-			std::string type; line_str>>type;
-			if(type=="v") {
-				cmn::vf3d v;
-				line_str>>v.x>>v.y>>v.z;
-				m.verts.push_back(v);
-			} else if(type=="f") {
-				std::vector<int> v_ixs;
-
-				//parse v/t/n until fail
-				int num=0;
-				for(std::string vtn; line_str>>vtn; num++) {
-					std::stringstream vtn_str(vtn);
-					int v_ix;
-					if(vtn_str>>v_ix) v_ixs.push_back(v_ix-1);
-				}
-
-				//triangulate
-				for(int i=2; i<num; i++) {
-					m.tris.push_back({
-						v_ixs[0],
-						v_ixs[i-1],
-						v_ixs[i]
-						});
-				}
-			}
+		m.verts=std::move(obj.positions);
+		m.tris.reserve(obj.getNumTris());
+		for(int i=0; i<obj.corners.size(); i+=3) {
+			m.tris.push_back({
+				obj.corners[i].v,
+				obj.corners[i+1].v,
+				obj.corners[i+2].v
+				});
 		}
 
 		m.updateMatrixes();
@@ -18,6 +18,7 @@ instructions
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -139,7 +140,7 @@ public:
 	bool user_create() override {
 		app_title="Slicer";
 
-		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		if(!setupModel()) return false;
 
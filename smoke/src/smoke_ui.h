@@ -4,6 +4,7 @@
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -12,9 +13,9 @@
 
 #include "sokol/render_utils.h"
 
-#include "smoke.h"
+#include "cmn/math/v2d.h"
 
-#include <list>
+#include "cmn/particle_pool.h"
 
 #include "cmn/utils.h"
 
@@ -28,7 +29,7 @@ using cmn::vf2d;
 
 class SmokeUI : public cmn::SokolEngine {
 	//scene
-	std::list<Smoke> smokes;
+	cmn::ParticlePool smokes{8192};
 	vf2d buoyancy{0, -120};
 	bool update_emitter=false;
 	bool update_physics=true;
@@ -56,6 +57,10 @@ public:
 #pragma region SETUP_HELPERS
 	void setupSGL() {
 		sgl_desc_t sgl_desc{};
+		//full pool of quads w/ outlines: 6 per quad & 10 per outline.
+		//  the emitter & anything else go in the headroom.
+		const int per_smoke=6+10, headroom=1<<12;
+		sgl_desc.max_vertices=per_smoke*smokes.getCapacity()+headroom;
 		sgl_setup(sgl_desc);
 	}
 
@@ -98,10 +103,15 @@ public:
 	bool user_create() override {
 		app_title="Smoke";
 		
-		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		emitter_pos=vf2d(.2f*sapp_widthf(), .75f*sapp_heightf());
 
+		smokes.acc_x=buoyancy.x, smokes.acc_y=buoyancy.y;
+		smokes.drag=.85f;
+		smokes.rot_drag=.55f;
+		smokes.size_drag=.25f;
+
 		setupSGL();
 
 		setupPipeline();
@@ -121,24 +131,30 @@ public:
 		emitter_b=cmn::randFloat();
 	}
 
+	//rest of the smoke defaults, -1 when full
+	int spawnSmoke(const vf2d& pos, const vf2d& vel, float r, float g, float b) {
+		//fades out over 4 seconds
+		int i=smokes.spawn(pos.x, pos.y, vel.x, vel.y, 4);
+		if(i==-1) return -1;
+
+		smokes.rot[i]=cmn::randFloat(2*cmn::Pi);
+		smokes.rot_vel[i]=cmn::randFloat(-1.5f, 1.5f);
+		smokes.size[i]=cmn::randFloat(10, 20);
+		smokes.size_vel[i]=cmn::randFloat(15, 25);
+		smokes.r[i]=r;
+		smokes.g[i]=g;
+		smokes.b[i]=b;
+		return i;
+	}
+
 	//add particles at mouse
 	void handleEmitUpdate() {
-		Smoke smoke;
-		smoke.pos=emitter_pos;
 		vf2d sub=mouse_pos-emitter_pos;
 		float dist=sub.mag();
 		vf2d dir;
 		if(dist!=0) dir=sub/dist;
 		float speed=std::max(0.f, dist+cmn::randFloat(-100, 100));
-		smoke.vel=speed*dir;
-		smoke.rot=cmn::randFloat(2*cmn::Pi);
-		smoke.rot_vel=cmn::randFloat(-1.5f, 1.5f);
-		smoke.size=cmn::randFloat(10, 20);
-		smoke.size_vel=cmn::randFloat(15, 25);
-		smoke.r=emitter_r;
-		smoke.g=emitter_g;
-		smoke.b=emitter_b;
-		smokes.push_back(smoke);
+		spawnSmoke(emitter_pos, speed*dir, emitter_r, emitter_g, emitter_b);
 	}
 
 	void handleParticleBomb() {
@@ -150,18 +166,9 @@ public:
 		//spawn a random number
 		int num=cmn::randInt(20, 40);
 		for(int i=0; i<num; i++) {
-			Smoke smoke;
-			smoke.pos=mouse_pos;
 			float speed=cmn::randFloat(30, 70);
-			smoke.vel=cmn::polar<vf2d>(speed, cmn::randFloat(2*cmn::Pi));
-			smoke.rot=cmn::randFloat(2*cmn::Pi);
-			smoke.rot_vel=cmn::randFloat(-1.5f, 1.5f);
-			smoke.size=cmn::randFloat(10, 20);
-			smoke.size_vel=cmn::randFloat(15, 25);
-			smoke.r=smoke_r;
-			smoke.g=smoke_g;
-			smoke.b=smoke_b;
-			smokes.push_back(smoke);
+			vf2d vel=cmn::polar<vf2d>(speed, cmn::randFloat(2*cmn::Pi));
+			if(spawnSmoke(mouse_pos, vel, smoke_r, smoke_g, smoke_b)==-1) break;
 		}
 	}
 
@@ -193,28 +200,10 @@ public:
 
 		handleUserInput(dt);
 
-		//update smokes
+		//update smokes & remove dead ones
 		if(update_physics) {
-			for(auto& p:smokes) {
-				//drag
-				p.vel*=1-.85f*dt;
-				p.rot_vel*=1-.55f*dt;
-				p.size_vel*=1-.25f*dt;
-
-				//kinematics
-				p.accelerate(buoyancy);
-				p.update(dt);
-
-				//aging?
-				p.life-=.25f*dt;
-			}
-		}
-
-		//remove offscreen smokes
-		for(auto it=smokes.begin(); it!=smokes.end();) {
-			if(it->isDead()) {
-				it=smokes.erase(it);
-			} else it++;
+			smokes.integrate(dt);
+			smokes.updateAges(dt);
 		}
 
 		return true;
@@ -238,52 +227,39 @@ public:
 		sgl_end();
 	}
 
-	void renderSmoke(const Smoke& sm) {
-		//precompute rotation matrix
-		float c=std::cos(sm.rot), s=std::sin(sm.rot);
-
-		//for each corner
-		vf2d corners[4]{{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
-		for(int i=0; i<4; i++) {
-			//rotate, scale, & translate
-			corners[i]=sm.pos+sm.size/2*vf2d(
-				c*corners[i].x-s*corners[i].y,
-				s*corners[i].x+c*corners[i].y
-			);
-		}
-		
+	//one batch for every smoke
+	void renderSmokes() {
+		const int num_verts=smokes.fillQuads();
+		const cmn::ParticleVertex* verts=smokes.getVertices();
+
 		if(show_sprites) {
 			sgl_enable_texture();
 			sgl_texture(tex, smp);
 		}
-		
-		//tint
-		sgl_c4f(sm.r, sm.g, sm.b, sm.life);
 
 		sgl_begin_quads();
-
-		sgl_v2f_t2f(corners[0].x, corners[0].y, 0, 0);
-		sgl_v2f_t2f(corners[1].x, corners[1].y, 1, 0);
-		sgl_v2f_t2f(corners[2].x, corners[2].y, 1, 1);
-		sgl_v2f_t2f(corners[3].x, corners[3].y, 0, 1);
-
+		for(int i=0; i<num_verts; i++) {
+			const auto& v=verts[i];
+			sgl_v2f_t2f_c4f(v.x, v.y, v.u, v.v, v.r, v.g, v.b, v.a);
+		}
 		sgl_end();
 
 		sgl_disable_texture();
 
 		if(show_outlines) {
 			sgl_begin_lines();
+			for(int i=0; i<num_verts; i+=4) {
+				const cmn::ParticleVertex* q=verts+i;
 
-			//alpha based on smoke "age"
-			sgl_c4f(1, 1, 1, sm.life);
-
-			//draw box w/ diagonal
-			sgl_v2f(corners[0].x, corners[0].y), sgl_v2f(corners[1].x, corners[1].y);
-			sgl_v2f(corners[1].x, corners[1].y), sgl_v2f(corners[2].x, corners[2].y);
-			sgl_v2f(corners[2].x, corners[2].y), sgl_v2f(corners[3].x, corners[3].y);
-			sgl_v2f(corners[3].x, corners[3].y), sgl_v2f(corners[0].x, corners[0].y);
-			sgl_v2f(corners[0].x, corners[0].y), sgl_v2f(corners[2].x, corners[2].y);
+				//alpha based on smoke "age"
+				sgl_c4f(1, 1, 1, q[0].a);
 
+				//draw box w/ diagonal
+				for(int j=0; j<4; j++) {
+					sgl_v2f(q[j].x, q[j].y), sgl_v2f(q[(j+1)%4].x, q[(j+1)%4].y);
+				}
+				sgl_v2f(q[0].x, q[0].y), sgl_v2f(q[2].x, q[2].y);
+			}
 			sgl_end();
 		}
 	}
@@ -305,9 +281,7 @@ public:
 
 		if(!update_emitter) renderEmitter();
 
-		for(const auto& p:smokes) {
-			renderSmoke(p);
-		}
+		renderSmokes();
 
 		sgl_draw();
 
@@ -4,6 +4,7 @@
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -210,7 +211,7 @@ public:
 		pip_desc.layout.attrs[ATTR_mesh_i_pos].format=SG_VERTEXFORMAT_FLOAT3;
 		pip_desc.layout.attrs[ATTR_mesh_i_norm].format=SG_VERTEXFORMAT_FLOAT3;
 		pip_desc.layout.attrs[ATTR_mesh_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(mesh_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(mesh_shader_desc(getBackend()));
 		pip_desc.index_type=SG_INDEXTYPE_UINT32;
 		pip_desc.cull_mode=SG_CULLMODE_FRONT;
 		pip_desc.depth.write_enabled=true;
@@ -225,7 +226,7 @@ public:
 		pip_desc.layout.attrs[ATTR_shaded_i_pos].format=SG_VERTEXFORMAT_FLOAT3;
 		pip_desc.layout.attrs[ATTR_shaded_i_norm].format=SG_VERTEXFORMAT_FLOAT3;
 		pip_desc.layout.attrs[ATTR_shaded_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(shaded_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(shaded_shader_desc(getBackend()));
 		pip_desc.index_type=SG_INDEXTYPE_UINT32;
 		pip_desc.cull_mode=SG_CULLMODE_FRONT;
 		pip_desc.depth.write_enabled=true;
@@ -239,7 +240,7 @@ public:
 		sg_pipeline_desc pip_desc{};
 		pip_desc.layout.attrs[ATTR_line_i_pos].format=SG_VERTEXFORMAT_FLOAT3;
 		pip_desc.layout.attrs[ATTR_line_i_col].format=SG_VERTEXFORMAT_FLOAT4;
-		pip_desc.shader=sg_make_shader(line_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(line_shader_desc(getBackend()));
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_LINES;
 		pip_desc.index_type=SG_INDEXTYPE_UINT32;
 		pip_desc.depth.write_enabled=true;
@@ -253,7 +254,7 @@ public:
 		sg_pipeline_desc pip_desc{};
 		pip_desc.layout.attrs[ATTR_colorview_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
 		pip_desc.layout.attrs[ATTR_colorview_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(colorview_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(colorview_shader_desc(getBackend()));
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 		//with alpha blending
 		pip_desc.colors[0].blend.enabled=true;
@@ -317,7 +318,7 @@ public:
 			pip_desc.layout.attrs[ATTR_shadow_map_i_pos].format=SG_VERTEXFORMAT_FLOAT3;
 			pip_desc.layout.attrs[ATTR_shadow_map_i_norm].format=SG_VERTEXFORMAT_FLOAT3;
 			pip_desc.layout.attrs[ATTR_shadow_map_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
-			pip_desc.shader=sg_make_shader(shadow_map_shader_desc(sg_query_backend()));
+			pip_desc.shader=sg_make_shader(shadow_map_shader_desc(getBackend()));
 			pip_desc.index_type=SG_INDEXTYPE_UINT32;
 			pip_desc.face_winding=SG_FACEWINDING_CCW;
 			pip_desc.cull_mode=SG_CULLMODE_BACK;
@@ -426,7 +427,7 @@ public:
 		sg_pipeline_desc pip_desc{};
 		pip_desc.layout.attrs[ATTR_skybox_i_pos].format=SG_VERTEXFORMAT_FLOAT3;
 		pip_desc.layout.attrs[ATTR_skybox_i_uv].format=SG_VERTEXFORMAT_FLOAT2;
-		pip_desc.shader=sg_make_shader(skybox_shader_desc(sg_query_backend()));
+		pip_desc.shader=sg_make_shader(skybox_shader_desc(getBackend()));
 		pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 		pip_desc.depth.write_enabled=true;
 		pip_desc.depth.compare=SG_COMPAREFUNC_LESS_EQUAL;
@@ -578,7 +579,7 @@ public:
 		{//identity
 			sg_pipeline_desc pip_desc{};
 			pip_desc.layout.attrs[ATTR_identity_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
-			pip_desc.shader=sg_make_shader(identity_shader_desc(sg_query_backend()));
+			pip_desc.shader=sg_make_shader(identity_shader_desc(getBackend()));
 			pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 			post_process.pips.push_back(sg_make_pipeline(pip_desc));
 		}
@@ -586,7 +587,7 @@ public:
 		{//crt
 			sg_pipeline_desc pip_desc{};
 			pip_desc.layout.attrs[ATTR_crt_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
-			pip_desc.shader=sg_make_shader(crt_shader_desc(sg_query_backend()));
+			pip_desc.shader=sg_make_shader(crt_shader_desc(getBackend()));
 			pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 			post_process.pips.push_back(sg_make_pipeline(pip_desc));
 		}
@@ -594,7 +595,7 @@ public:
 		{//halftone
 			sg_pipeline_desc pip_desc{};
 			pip_desc.layout.attrs[ATTR_halftone_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
-			pip_desc.shader=sg_make_shader(halftone_shader_desc(sg_query_backend()));
+			pip_desc.shader=sg_make_shader(halftone_shader_desc(getBackend()));
 			pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 			post_process.pips.push_back(sg_make_pipeline(pip_desc));
 			//default to this
@@ -604,7 +605,7 @@ public:
 		{//crosshatch
 			sg_pipeline_desc pip_desc{};
 			pip_desc.layout.attrs[ATTR_crosshatch_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
-			pip_desc.shader=sg_make_shader(crosshatch_shader_desc(sg_query_backend()));
+			pip_desc.shader=sg_make_shader(crosshatch_shader_desc(getBackend()));
 			pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 			post_process.pips.push_back(sg_make_pipeline(pip_desc));
 		}
@@ -612,7 +613,7 @@ public:
 		{//ascii
 			sg_pipeline_desc pip_desc{};
 			pip_desc.layout.attrs[ATTR_ascii_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
-			pip_desc.shader=sg_make_shader(ascii_shader_desc(sg_query_backend()));
+			pip_desc.shader=sg_make_shader(ascii_shader_desc(getBackend()));
 			pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 			post_process.pips.push_back(sg_make_pipeline(pip_desc));
 		}
@@ -620,7 +621,7 @@ public:
 		{//kuwahara
 			sg_pipeline_desc pip_desc{};
 			pip_desc.layout.attrs[ATTR_kuwahara_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
-			pip_desc.shader=sg_make_shader(kuwahara_shader_desc(sg_query_backend()));
+			pip_desc.shader=sg_make_shader(kuwahara_shader_desc(getBackend()));
 			pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 			post_process.pips.push_back(sg_make_pipeline(pip_desc));
 		}
@@ -628,7 +629,7 @@ public:
 		{//mean of least variance
 			sg_pipeline_desc pip_desc{};
 			pip_desc.layout.attrs[ATTR_mlv_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
-			pip_desc.shader=sg_make_shader(mlv_shader_desc(sg_query_backend()));
+			pip_desc.shader=sg_make_shader(mlv_shader_desc(getBackend()));
 			pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 			post_process.pips.push_back(sg_make_pipeline(pip_desc));
 		}
@@ -636,7 +637,7 @@ public:
 		{//quantize
 			sg_pipeline_desc pip_desc{};
 			pip_desc.layout.attrs[ATTR_quantize_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
-			pip_desc.shader=sg_make_shader(quantize_shader_desc(sg_query_backend()));
+			pip_desc.shader=sg_make_shader(quantize_shader_desc(getBackend()));
 			pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 			post_process.pips.push_back(sg_make_pipeline(pip_desc));
 		}
@@ -644,7 +645,7 @@ public:
 		{//squiggle
 			sg_pipeline_desc pip_desc{};
 			pip_desc.layout.attrs[ATTR_squiggle_i_pos].format=SG_VERTEXFORMAT_FLOAT2;
-			pip_desc.shader=sg_make_shader(squiggle_shader_desc(sg_query_backend()));
+			pip_desc.shader=sg_make_shader(squiggle_shader_desc(getBackend()));
 			pip_desc.primitive_type=SG_PRIMITIVETYPE_TRIANGLE_STRIP;
 			post_process.pips.push_back(sg_make_pipeline(pip_desc));
 		}
@@ -678,6 +679,7 @@ public:
 		app_title="Post Processing Demo";
 		
 		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		setupSamplers();
 
@@ -22,6 +22,8 @@
 
 #include <sstream>
 
+#include "cmn/obj_loader.h"
+
 struct Mesh {
 	struct v2d_t { float u=0, v=0; };
 
@@ -354,12 +356,18 @@ struct Mesh {
 	[[nodiscard]] static ReturnCode loadFromOBJ(Mesh& m, const std::string& filename) {
 		m=Mesh{};
 
-		std::ifstream file(filename);
-		if(file.fail()) return ReturnCode::Filename;
+		cmn::OBJMesh obj;
+		cmn::OBJStatus status;
+		if(!cmn::loadOBJCached(obj, filename, status)) {
+			switch(status) {
+				case cmn::OBJStatus::Filename: return ReturnCode::Filename;
+				case cmn::OBJStatus::Normal: return ReturnCode::Normal;
+				default: return ReturnCode::Vertex;
+			}
+		}
 
-		std::vector<cmn::vf3d> vertex_pos;
-		std::vector<cmn::vf3d> vertex_norm;
-		std::vector<v2d_t> vertex_tex{{0, 0}};
+		//ensure unit
+		for(auto& n:obj.normals) n=n.norm();
 
 		struct vtn_t {
 			int v=0, t=0, n=0;
@@ -380,90 +388,32 @@ struct Mesh {
 
 		std::unordered_map<vtn_t, int, vtn_t_hash> vtn2ix;
 
-		for(std::string line_str; std::getline(file, line_str);) {
-			std::stringstream line_ss(line_str);
-
-			std::string type; line_ss>>type;
-			if(type=="v") {
-				cmn::vf3d v;
-				line_ss>>v.x>>v.y>>v.z;
-
-				vertex_pos.push_back(v);
-			} else if(type=="vn") {
-				cmn::vf3d n;
-				line_ss>>n.x>>n.y>>n.z;
-
-				//ensure unit
-				vertex_norm.push_back(n.norm());
-			} else if(type=="vt") {
-				v2d_t t;
-				line_ss>>t.u>>t.v;
-
-				vertex_tex.push_back(t);
-			} else if(type=="f") {
-				//parse vtns until fail
-				std::vector<vtn_t> vtns;
-				for(std::string vtn_str; line_ss>>vtn_str;) {
-					std::stringstream vtn_ss(vtn_str);
-
-					int v=-1, t=0, n=-1;
-
-					std::string v_str;
-					std::getline(vtn_ss, v_str, '/');
-					std::stringstream v_ss(v_str);
-					if(!(v_ss>>v)) v=-1;
-
-					std::string t_str;
-					if(std::getline(vtn_ss, t_str, '/')) {
-						std::stringstream t_ss(t_str);
-						if(!(t_ss>>t)) t=0;
-					}
-
-					std::string n_str;
-					if(std::getline(vtn_ss, n_str, '/')) {
-						std::stringstream n_ss(n_str);
-						if(!(n_ss>>n)) n=-1;
-					}
-
-					if(v==-1) return ReturnCode::Vertex;
-					if(n==-1) return ReturnCode::Normal;
-
-					//obj 1-based indexing
-					vtns.push_back({v-1, t, n-1});
-				}
-
-				//add vertexes
-				std::vector<int> indexes;
-				for(const auto& vtn:vtns) {
-					//use vertex if it exists
-					int ix=0;
-					auto it=vtn2ix.find(vtn);
-					if(it!=vtn2ix.end()) ix=it->second;
-					//otherwise, make new one.
-					else {
-						ix=m.verts.size();
-						vtn2ix.insert({vtn, ix});
-						m.verts.push_back({
-							vertex_pos[vtn.v],
-							vertex_norm[vtn.n],
-							vertex_tex[vtn.t]
-							});
-					}
-					indexes.push_back(ix);
-				}
-
-				//triangulate polygon
-				for(int i=2; i<indexes.size(); i++) {
-					m.tris.push_back({
-						indexes[0],
-						indexes[i-1],
-						indexes[i]
-						});
-				}
+		//add vertexes, 3 corners at a time
+		m.tris.reserve(obj.getNumTris());
+		int indexes[3];
+		for(int i=0; i<obj.corners.size(); i++) {
+			const auto& c=obj.corners[i];
+			if(c.n==-1) return ReturnCode::Normal;
+
+			//use vertex if it exists
+			vtn_t vtn{c.v, c.t, c.n};
+			auto it=vtn2ix.find(vtn);
+			if(it!=vtn2ix.end()) indexes[i%3]=it->second;
+			//otherwise, make new one.
+			else {
+				v2d_t tex;
+				if(c.t!=-1) tex={obj.texcoords[2*c.t], obj.texcoords[1+2*c.t]};
+				indexes[i%3]=m.verts.size();
+				vtn2ix.insert({vtn, indexes[i%3]});
+				m.verts.push_back({
+					obj.positions[c.v],
+					obj.normals[c.n],
+					tex
+					});
 			}
-		}
 
-		file.close();
+			if(i%3==2) m.tris.push_back({indexes[0], indexes[1], indexes[2]});
+		}
 
 		m.updateVertexBuffer();
 		m.updateIndexBuffer();
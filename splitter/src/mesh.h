@@ -15,42 +15,47 @@
 //for swap
 #include <algorithm>
 
-#include <unordered_map>
-
-//for uint32_t & uint64_t
-#include <cstdint>
+#include "cmn/edge_cache.h"
 
 #include <list>
 
-#include <queue>
+#include <numeric>
 
 struct IndexTriangle {
 	int ix[3]{-1, -1, -1};
 };
 
-//sorted edges
-struct IndexEdge {
-	int a, b;
+struct SplitIndex {
+	int pos_ix, neg_ix;
+};
 
-	IndexEdge(int v0, int v1) {
-		a=v0, b=v1;
-		if(a>b) std::swap(a, b);
-	}
+//disjoint set w/ path halving & union by size
+class UnionFind {
+	std::vector<int> parent, size;
 
-	bool operator==(const IndexEdge& e) const {
-		return e.a==a&&e.b==b;
+public:
+	void reset(int num) {
+		parent.resize(num);
+		std::iota(parent.begin(), parent.end(), 0);
+		size.assign(num, 1);
 	}
-};
 
-struct IndexEdgeHash {
-	std::uint64_t operator()(const IndexEdge& e) const {
-		std::uint64_t a=e.a, b=e.b;
-		return (a<<32)|b;
+	int find(int i) {
+		while(parent[i]!=i) {
+			parent[i]=parent[parent[i]];
+			i=parent[i];
+		}
+		return i;
 	}
-};
 
-struct SplitIndex {
-	int pos_ix, neg_ix;
+	void merge(int a, int b) {
+		a=find(a), b=find(b);
+		if(a==b) return;
+
+		if(size[a]<size[b]) std::swap(a, b);
+		parent[b]=a;
+		size[a]+=size[b];
+	}
 };
 
 float cross(const cmn::vf2d& a, const cmn::vf2d& b) {
@@ -60,8 +65,37 @@ float cross(const cmn::vf2d& a, const cmn::vf2d& b) {
 class Mesh {
 	cmn::vf2d sc{0, 1};
 
+	//reused between calls
+	struct Scratch {
+		cmn::EdgeCache<SplitIndex> cache;
+		std::vector<bool> side;
+		std::vector<IndexTriangle> tris;
+
+		//vertex to triangle adjacency
+		std::vector<int> vert_start;
+		std::vector<int> vert_tris;
+		UnionFind islands;
+		std::vector<int> part_ix, local_ix;
+	};
+	static Scratch& getScratch() {
+		static thread_local Scratch scratch;
+		return scratch;
+	}
+
 	std::vector<Mesh> separate() const;
 
+	//give parts this meshes transform & random colors
+	void adoptParts(std::vector<Mesh>& parts) const {
+		for(auto& m:parts) {
+			m.pos=pos;
+			m.rot=rot;
+			m.sc=sc;
+			m.r=cmn::randFloat();
+			m.g=cmn::randFloat();
+			m.b=cmn::randFloat();
+		}
+	}
+
 public:
 	std::vector<cmn::vf2d> verts;
 	std::vector<IndexTriangle> tris;
@@ -69,6 +103,11 @@ public:
 	float rot=0;
 	float r=1, g=1, b=1;
 
+	//world space cut line
+	struct Cut {
+		cmn::vf2d ctr, norm;
+	};
+
 	//precompute sin & cos for rotation
 	void updateMatrix() {
 		sc.x=std::sin(rot);
@@ -91,130 +130,103 @@ public:
 		return unrotVec(w-pos);
 	}
 
-	std::vector<Mesh> split(cmn::vf2d ctr, cmn::vf2d norm) const {
-		//localize plane
-		ctr=wld2loc(ctr);
-		norm=unrotVec(norm);
-
-		//classify pts & make lookup
-		std::vector<int> i2pn;
-		auto i2p=[] (int i) { return 1+i; };
-		auto i2n=[] (int i) { return -1-i; };
-		auto p2i=[] (int p) { return p-1; };
-		auto n2i=[] (int n) { return -1-n; };
-		Mesh mesh_pos, mesh_neg;
-		for(const auto& v:verts) {
-			if(norm.dot(v-ctr)>0) {
-				i2pn.push_back(i2p(mesh_pos.verts.size()));
-				mesh_pos.verts.push_back(v);
-			} else {
-				i2pn.push_back(i2n(mesh_neg.verts.size()));
-				mesh_neg.verts.push_back(v);
-			}
+	//cut along local line w/o separating.
+	//  crossings get one vertex per side,
+	//  so each side ends up its own island.
+	//  returns if any triangle was cut.
+	bool slice(const cmn::vf2d& ctr, const cmn::vf2d& norm) {
+		auto& s=getScratch();
+
+		//classify pts
+		s.side.resize(verts.size());
+		int num_pos=0;
+		for(int i=0; i<verts.size(); i++) {
+			s.side[i]=norm.dot(verts[i]-ctr)>0;
+			if(s.side[i]) num_pos++;
 		}
 
 		//all on one side
-		if(mesh_pos.verts.empty()||mesh_neg.verts.empty()) return {};
+		if(num_pos==0||num_pos==verts.size()) return false;
 
 		//store intersections for reuse
-		std::unordered_map<IndexEdge, SplitIndex, IndexEdgeHash> cache;
+		s.cache.reset(3*tris.size());
 		auto getEdgeIndex=[&] (int i0, int i1) {
-			IndexEdge e(i0, i1);
-
-			auto it=cache.find(e);
-			if(it!=cache.end()) return it->second;
+			SplitIndex* is;
+			if(s.cache.findOrInsert(i0, i1, is)) return *is;
 
 			const cmn::vf2d& a=verts[i0], ab=verts[i1]-a;
 			float t=norm.dot(ctr-a)/norm.dot(ab);
 			cmn::vf2d ix=a+t*ab;
 
-			mesh_pos.verts.push_back(ix);
-			mesh_neg.verts.push_back(ix);
-
-			SplitIndex is;
-			is.pos_ix=mesh_pos.verts.size()-1;
-			is.neg_ix=mesh_neg.verts.size()-1;
-			cache[e]=is;
-			return is;
+			is->pos_ix=verts.size();
+			verts.push_back(ix);
+			is->neg_ix=verts.size();
+			verts.push_back(ix);
+			return *is;
 		};
 
+		s.tris.clear();
+		bool cut=false;
 		int ix_pos[3], ix_neg[3];
 		for(const auto& t:tris) {
 			int ct_pos=0, ct_neg=0;
 			for(int i=0; i<3; i++) {
 				const auto& ix=t.ix[i];
-				if(i2pn[ix]>0) ix_pos[ct_pos++]=ix;
+				if(s.side[ix]) ix_pos[ct_pos++]=ix;
 				else ix_neg[ct_neg++]=ix;
 			}
 			switch(ct_pos) {
-				case 0://send entire tri to neg
-					mesh_neg.tris.push_back({
-						n2i(i2pn[ix_neg[0]]),
-						n2i(i2pn[ix_neg[1]]),
-						n2i(i2pn[ix_neg[2]]),
-						});
+				case 0: case 3://untouched
+					s.tris.push_back(t);
 					break;
 				case 1: {//pos tri, neg quad
 					auto p0n0=getEdgeIndex(ix_pos[0], ix_neg[0]);
 					auto p0n1=getEdgeIndex(ix_pos[0], ix_neg[1]);
-					int p0=p2i(i2pn[ix_pos[0]]);
-					int n0=n2i(i2pn[ix_neg[0]]);
-					int n1=n2i(i2pn[ix_neg[1]]);
-					mesh_pos.tris.push_back({p0, p0n0.pos_ix, p0n1.pos_ix});
-					mesh_neg.tris.push_back({p0n0.neg_ix, n0, n1});
-					mesh_neg.tris.push_back({p0n0.neg_ix, n1, p0n1.neg_ix});
+					s.tris.push_back({ix_pos[0], p0n0.pos_ix, p0n1.pos_ix});
+					s.tris.push_back({p0n0.neg_ix, ix_neg[0], ix_neg[1]});
+					s.tris.push_back({p0n0.neg_ix, ix_neg[1], p0n1.neg_ix});
+					cut=true;
 					break;
 				}
 				case 2: {//pos quad, neg tri
 					auto p0n0=getEdgeIndex(ix_pos[0], ix_neg[0]);
 					auto p1n0=getEdgeIndex(ix_pos[1], ix_neg[0]);
-					int p0=p2i(i2pn[ix_pos[0]]);
-					int p1=p2i(i2pn[ix_pos[1]]);
-					int n0=n2i(i2pn[ix_neg[0]]);
-					mesh_pos.tris.push_back({p0, p1, p1n0.pos_ix});
-					mesh_pos.tris.push_back({p0, p1n0.pos_ix, p0n0.pos_ix});
-					mesh_neg.tris.push_back({p1n0.neg_ix, n0, p0n0.neg_ix});
+					s.tris.push_back({ix_pos[0], ix_pos[1], p1n0.pos_ix});
+					s.tris.push_back({ix_pos[0], p1n0.pos_ix, p0n0.pos_ix});
+					s.tris.push_back({p1n0.neg_ix, ix_neg[0], p0n0.neg_ix});
+					cut=true;
 					break;
 				}
-				case 3://send entire tri to pos
-					mesh_pos.tris.push_back({
-						p2i(i2pn[ix_pos[0]]),
-						p2i(i2pn[ix_pos[1]]),
-						p2i(i2pn[ix_pos[2]]),
-						});
-					break;
 			}
 		}
+		tris.swap(s.tris);
 
-		//seperate & conglomerate
-		std::vector<Mesh> meshes;
-		auto meshes_pos=mesh_pos.separate();
-		auto meshes_neg=mesh_neg.separate();
-		meshes.insert(
-			meshes.end(),
-			meshes_pos.begin(),
-			meshes_pos.end()
-		);
-		meshes.insert(
-			meshes.end(),
-			meshes_neg.begin(),
-			meshes_neg.end()
-		);
-
-		//apply transforms
-		for(int i=0; i<meshes.size(); i++) {
-			auto& m=meshes[i];
-			m.pos=pos;
-			m.rot=rot;
-			m.sc=sc;
-			m.r=cmn::randFloat();
-			m.g=cmn::randFloat();
-			m.b=cmn::randFloat();
+		return cut;
+	}
+
+	//apply every cut, then separate once.
+	//  returns nothing if no cut hit.
+	std::vector<Mesh> splitMulti(const std::vector<Cut>& cuts) const {
+		Mesh work;
+		work.verts=verts;
+		work.tris=tris;
+
+		bool any=false;
+		for(const auto& c:cuts) {
+			//localize plane
+			any|=work.slice(wld2loc(c.ctr), unrotVec(c.norm));
 		}
+		if(!any) return {};
 
+		auto meshes=work.separate();
+		adoptParts(meshes);
 		return meshes;
 	}
 
+	std::vector<Mesh> split(const cmn::vf2d& ctr, const cmn::vf2d& norm) const {
+		return splitMulti({{ctr, norm}});
+	}
+
 	static Mesh makeRect(float w, float h, cmn::vf2d p, float r, float g, float b) {
 		Mesh m;
 		//push order(CW) matters.
@@ -267,66 +279,65 @@ public:
 };
 
 //separate by loose parts.
+//  tris sharing a vertex are merged, then
+//  every vertex & tri is scattered in one pass.
 std::vector<Mesh> Mesh::separate() const {
-	//build adjacency list
-	std::vector<std::vector<int>> adj(verts.size());
+	auto& s=getScratch();
+	const int num_verts=verts.size();
+	const int num_tris=tris.size();
+
+	//count tris per vertex
+	s.vert_start.assign(num_verts+1, 0);
 	for(const auto& t:tris) {
-		adj[t.ix[0]].push_back(t.ix[1]); adj[t.ix[1]].push_back(t.ix[0]);
-		adj[t.ix[1]].push_back(t.ix[2]); adj[t.ix[2]].push_back(t.ix[1]);
-		adj[t.ix[2]].push_back(t.ix[0]); adj[t.ix[0]].push_back(t.ix[2]);
+		for(int i=0; i<3; i++) s.vert_start[1+t.ix[i]]++;
 	}
+	for(int v=0; v<num_verts; v++) s.vert_start[v+1]+=s.vert_start[v];
 
-	std::vector<Mesh> meshes;
-	//which component does ix belong to?
-	std::vector<int> ix2part(verts.size(), -1);
-	int curr_part=0;
-
-	for(int i=0; i<(int)verts.size(); i++) {
-		//skip if filled
-		if(ix2part[i]!=-1) continue;
-
-		//floodfill
-		std::vector<int> part;
-		std::queue<int> q; q.push(i);
-		ix2part[i]=curr_part;
-		while(!q.empty()) {
-			int nxt=q.front(); q.pop();
-			part.push_back(nxt);
-			for(int nbr:adj[nxt]) {
-				if(ix2part[nbr]==-1) {
-					ix2part[nbr]=curr_part;
-					q.push(nbr);
-				}
-			}
-		}
+	//scatter into csr
+	s.vert_tris.resize(s.vert_start[num_verts]);
+	s.local_ix.assign(s.vert_start.begin(), s.vert_start.end()-1);
+	for(int t=0; t<num_tris; t++) {
+		for(int i=0; i<3; i++) s.vert_tris[s.local_ix[tris[t].ix[i]]++]=t;
+	}
 
-		//add verts & init lookup
-		Mesh sub;
-		std::vector<int> remap(verts.size(), -1);
-		for(int j=0; j<part.size(); j++) {
-			int v=part[j];
-			remap[v]=j;
-			sub.verts.push_back(verts[v]);
+	//union all tris around each vertex
+	s.islands.reset(num_tris);
+	for(int v=0; v<num_verts; v++) {
+		for(int j=s.vert_start[v]+1; j<s.vert_start[v+1]; j++) {
+			s.islands.merge(s.vert_tris[s.vert_start[v]], s.vert_tris[j]);
 		}
+	}
 
-		//add remapped tris
-		for(const auto& t:tris) {
-			if(
-				ix2part[t.ix[0]]==curr_part&&
-				ix2part[t.ix[1]]==curr_part&&
-				ix2part[t.ix[2]]==curr_part
-				) {
-				sub.tris.push_back({
-					remap[t.ix[0]],
-					remap[t.ix[1]],
-					remap[t.ix[2]]
-					});
-			}
+	//number the roots
+	std::vector<Mesh> meshes;
+	s.part_ix.assign(num_tris, -1);
+	for(int t=0; t<num_tris; t++) {
+		int root=s.islands.find(t);
+		if(s.part_ix[root]==-1) {
+			s.part_ix[root]=meshes.size();
+			meshes.push_back(Mesh());
 		}
+		s.part_ix[t]=s.part_ix[root];
+	}
+
+	//verts go w/ any of their tris, unused ones are dropped
+	s.local_ix.assign(num_verts, -1);
+	for(int v=0; v<num_verts; v++) {
+		if(s.vert_start[v]==s.vert_start[v+1]) continue;
+
+		auto& m=meshes[s.part_ix[s.vert_tris[s.vert_start[v]]]];
+		s.local_ix[v]=m.verts.size();
+		m.verts.push_back(verts[v]);
+	}
 
-		//add the sucker
-		meshes.push_back(sub);
-		curr_part++;
+	//add remapped tris
+	for(int t=0; t<num_tris; t++) {
+		const auto& ix=tris[t].ix;
+		meshes[s.part_ix[t]].tris.push_back({
+			s.local_ix[ix[0]],
+			s.local_ix[ix[1]],
+			s.local_ix[ix[2]]
+			});
 	}
 
 	return meshes;
@@ -4,6 +4,7 @@
 #else
 #define SOKOL_GLCORE
 #endif
+#include "sokol/headless.h"
 #include "sokol/include/sokol_app.h"
 #include "sokol/include/sokol_gfx.h"
 #include "sokol/include/sokol_glue.h"
@@ -18,6 +19,10 @@
 
 #include <ctime>
 
+#include "cmn/stopwatch.h"
+
+#include <iostream>
+
 using cmn::vf2d;
 
 class Splitter : public cmn::SokolEngine {
@@ -63,11 +68,78 @@ public:
 		return true;
 	}
 
+#pragma region UPDATE_HELPERS
+	//replace every mesh a cut hits w/ its parts
+	void applyCuts(const std::vector<Mesh::Cut>& cuts) {
+		std::list<Mesh> next;
+		for(const auto& m:meshes) {
+			auto parts=m.splitMulti(cuts);
+			if(parts.empty()) next.push_back(m);
+			else next.insert(next.end(), parts.begin(), parts.end());
+		}
+		meshes.swap(next);
+	}
+
+	//random lines thru each meshes center
+	void shatterAll(int num) {
+		std::list<Mesh> next;
+		for(const auto& m:meshes) {
+			std::vector<Mesh::Cut> cuts;
+			for(int i=0; i<num; i++) {
+				cmn::vf2d off(cmn::randFloat(-20, 20), cmn::randFloat(-20, 20));
+				float angle=cmn::randFloat(2*cmn::Pi);
+				cuts.push_back({m.pos+off, cmn::polar<vf2d>(1.f, angle)});
+			}
+			auto parts=m.splitMulti(cuts);
+			if(parts.empty()) next.push_back(m);
+			else next.insert(next.end(), parts.begin(), parts.end());
+		}
+		meshes.swap(next);
+	}
+
+	//one cut at a time vs all at once on a dense torus
+	void benchmarkCuts() {
+		const Mesh dense=Mesh::makeTorus(100, 60, 8192, {0, 0}, 1, 1, 1);
+		const int num_cuts=32;
+		std::vector<Mesh::Cut> cuts;
+		for(int i=0; i<num_cuts; i++) {
+			float angle=cmn::Pi*i/num_cuts;
+			cuts.push_back({{0, 0}, cmn::polar<vf2d>(1.f, angle)});
+		}
+
+		cmn::Stopwatch watch;
+
+		//every cut splits then separates all the parts
+		watch.start();
+		std::vector<Mesh> seq{dense};
+		for(const auto& c:cuts) {
+			std::vector<Mesh> next;
+			for(const auto& m:seq) {
+				auto parts=m.split(c.ctr, c.norm);
+				if(parts.empty()) next.push_back(m);
+				else next.insert(next.end(), parts.begin(), parts.end());
+			}
+			seq.swap(next);
+		}
+		watch.stop();
+		auto seq_us=watch.getMicros();
+
+		watch.start();
+		auto multi=dense.splitMulti(cuts);
+		watch.stop();
+		auto multi_us=watch.getMicros();
+
+		std::cout<<"cut "<<dense.tris.size()<<" tris "<<num_cuts<<" times:\n"
+			<<"  sequential: "<<seq_us<<" us, "<<seq.size()<<" parts\n"
+			<<"  multi: "<<multi_us<<" us, "<<multi.size()<<" parts\n";
+	}
+#pragma endregion
+
 	bool user_update(float dt) override {
 		mouse_pos.x=GetMouseX();
 		mouse_pos.y=GetMouseY();
 		
-		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		const auto split_action=GetMouse(SAPP_MOUSEBUTTON_LEFT);
 		if(split_action.pressed) split_st=new vf2d(.1f+mouse_pos);
@@ -76,6 +148,16 @@ public:
 			split_st=nullptr;
 		}
 
+		//commit current cut
+		if(split_st&&GetKey(SAPP_KEYCODE_SPACE).pressed) {
+			vf2d tang=(*split_st-mouse_pos).norm();
+			applyCuts({{*split_st, {-tang.y, tang.x}}});
+		}
+
+		if(GetKey(SAPP_KEYCODE_M).pressed) shatterAll(8);
+
+		if(GetKey(SAPP_KEYCODE_B).pressed) benchmarkCuts();
+
 		if(GetKey(SAPP_KEYCODE_W).pressed) render_wireframes^=true;
 
 		return true;
@@ -12,6 +12,8 @@ using cmn::mat4;
 
 #include "cmn/utils.h"
 
+#include "cmn/stopwatch.h"
+
 struct Example : cmn::Engine3D {
 	Example() {
 		sAppName="targeting system";
@@ -207,6 +209,65 @@ struct Example : cmn::Engine3D {
 		scale_mesh->applyTransforms();
 		scale_mesh->colorNormals();
 	}
+
+	//per vertex matMulVec vs the batch kernels,
+	//  on every mesh vertex repeated to ~1M
+	void benchmarkTransforms() {
+		std::vector<vf3d> verts;
+		while(verts.size()<(1<<20)) {
+			std::size_t num=verts.size();
+			for(const auto& m:meshes) verts.insert(verts.end(), m.vertexes.begin(), m.vertexes.end());
+			if(verts.size()==num) break;
+		}
+		if(verts.empty()) return;
+
+		const int num=verts.size(), reps=10;
+		std::vector<vf3d> out(num), ref(num);
+		mat4 vp=mat4::mul(cam_proj, cam_view);
+
+		std::cout<<"transform benchmark: "<<num<<" verts, "<<reps<<" reps\n";
+		cmn::Stopwatch watch;
+		auto report=[&] (const char* name) {
+			float mvps=float(num)*reps/watch.getNanos()*1000;
+			float err=0;
+			for(int i=0; i<num; i++) err=std::max(err, (out[i]-ref[i]).mag());
+			std::cout<<"  "<<name<<": "<<mvps<<" Mverts/s, max err "<<err<<'\n';
+		};
+
+		//points
+		watch.start();
+		for(int r=0; r<reps; r++) {
+			for(int i=0; i<num; i++) {
+				float w=1;
+				ref[i]=matMulVec(vp, verts[i], w);
+			}
+		}
+		watch.stop();
+		out=ref;
+		report("scalar points");
+
+		watch.start();
+		for(int r=0; r<reps; r++) cmn::transformPoints(vp, verts.data(), out.data(), num);
+		watch.stop();
+		report("batch points");
+
+		//w/ perspective divide
+		watch.start();
+		for(int r=0; r<reps; r++) {
+			for(int i=0; i<num; i++) {
+				float w=1;
+				ref[i]=matMulVec(vp, verts[i], w)/w;
+			}
+		}
+		watch.stop();
+		out=ref;
+		report("scalar project");
+
+		watch.start();
+		for(int r=0; r<reps; r++) cmn::transformProject(vp, verts.data(), out.data(), num);
+		watch.stop();
+		report("batch project");
+	}
 #pragma endregion
 
 	bool user_update(float dt) override {
@@ -284,6 +345,8 @@ struct Example : cmn::Engine3D {
 		if(GetKey(olc::Key::B).bPressed) realize_bounds^=true;
 		if(GetKey(olc::Key::H).bPressed) help_menu^=true;
 
+		if(GetKey(olc::Key::P).bPressed) benchmarkTransforms();
+
 		return true;
 	}
 
@@ -393,6 +456,7 @@ struct Example : cmn::Engine3D {
 			DrawString(ScreenWidth()-8*13, 24, "R for rotate", rot_mesh?olc::WHITE:olc::RED);
 			DrawString(ScreenWidth()-8*13, 32, "E for extent", scale_mesh?olc::WHITE:olc::RED);
 			DrawString(ScreenWidth()-8*13, 40, "B for bounds", realize_bounds?olc::WHITE:olc::RED);
+			DrawString(ScreenWidth()-8*16, 48, "P for benchmark");
 
 			DrawString(cx-4*18, ScreenHeight()-8, "[Press H to close]");
 		} else {
@@ -6,6 +6,10 @@
 
 #include "return_code.h"
 
+#include "cmn/obj_loader.h"
+
+#include "cmn/math/mat4_batch.h"
+
 struct IndexTriangle {
 	int a=0, b=0, c=0;
 };
@@ -31,12 +35,8 @@ struct Mesh {
 	}
 
 	void applyTransforms() {
-		std::vector<vf3d> new_verts;
-		new_verts.reserve(vertexes.size());
-		for(const auto& v:vertexes) {
-			float w=1;
-			new_verts.push_back(matMulVec(model, v, w));
-		}
+		std::vector<vf3d> new_verts(vertexes.size());
+		cmn::transformPoints(model, vertexes.data(), new_verts.data(), vertexes.size());
 
 		tris.clear();
 		tris.reserve(index_tris.size());
@@ -63,10 +63,9 @@ struct Mesh {
 	cmn::AABBf3 getAABB() const {
 		const vf3d inf(1e300, 1e300, 1e300);
 		cmn::AABBf3 box;
-		for(const auto& v:vertexes) {
-			float w=1;
-			box.fitToEnclose(matMulVec(model, v, w));
-		}
+		cmn::forEachTransformedPoint(model, vertexes.data(), vertexes.size(), [&] (const vf3d& v) {
+			box.fitToEnclose(v);
+		});
 		return box;
 	}
 
@@ -85,44 +84,21 @@ struct Mesh {
 	}
 
 	static ReturnCode loadFromOBJ(Mesh& m, const std::string& filename) {
-		m={};
+		cmn::OBJMesh obj;
+		if(!cmn::loadOBJCached(obj, filename)) return {false, "invalid obj file"};
 
-		std::ifstream file(filename);
-		if(file.fail()) return {false, "invalid filename"};
-
-		//parse file line by line
-		std::string line;
-		while(std::getline(file, line)) {
-			std::stringstream line_str(line);
-			std::string type; line_str>>type;
-			if(type=="v") {
-				vf3d v;
-				line_str>>v.x>>v.y>>v.z;
-				m.vertexes.push_back(v);
-			} else if(type=="f") {
-				std::vector<int> v_ixs;
-
-				//parse v/t/n until fail
-				int num=0;
-				for(std::string vtn; line_str>>vtn; num++) {
-					std::stringstream vtn_str(vtn);
-					int v_ix;
-					if(vtn_str>>v_ix) v_ixs.push_back(v_ix-1);
-				}
+		m={};
 
-				//triangulate
-				for(int i=2; i<num; i++) {
-					m.index_tris.push_back({
-						v_ixs[0],
-						v_ixs[i-1],
-						v_ixs[i]
-						});
-				}
-			}
+		m.vertexes=std::move(obj.positions);
+		m.index_tris.reserve(obj.getNumTris());
+		for(int i=0; i<obj.corners.size(); i+=3) {
+			m.index_tris.push_back({
+				obj.corners[i].v,
+				obj.corners[i+1].v,
+				obj.corners[i+2].v
+				});
 		}
 
-		file.close();
-
 		return {true, "success"};
 	}
 };
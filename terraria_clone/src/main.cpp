@@ -94,7 +94,7 @@ struct Game : olc::PixelGameEngine {
 
 	void placeEntity(Entity& p) {
 		//random pos in world
-		p.pos.x=rand()%int(map->width-p.size.x);
+		p.pos.x=cmn::Random::local().nextInt(0, int(map->width-p.size.x)-1);
 
 		//find surface
 		int j;
@@ -110,7 +110,7 @@ struct Game : olc::PixelGameEngine {
 	}
 
 	bool OnUserCreate() override {
-		srand(time(0));
+		cmn::Random::seedAll(time(0));
 
 		//based on aspect ratio, setup world dimensions.
 		//change this later to be like 5000x1400 with chunking.
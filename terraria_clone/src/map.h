@@ -7,10 +7,10 @@
 #include "tile.h"
 #include "mesh.h"
 
-float randFloat(float a=1, float b=0) {
-	static const float rand_max=RAND_MAX;
+#include "cmn/random.h"
 
-	float t=rand()/rand_max;
+float randFloat(float a=1, float b=0) {
+	float t=cmn::Random::local().nextFloat();
 	return a+t*(b-a);
 }
 
@@ -203,6 +203,9 @@ struct Map {
 	//i can pass the surrounding chunks when i need to later.
 	//for the edges if there is no chunk assume it is a barrier.
 	bool moveDynamicTiles() {
+		//for tie-breaks
+		cmn::Random& rng=cmn::Random::local();
+
 		//from -> to
 		std::vector<olc::vi2d> swaps;
 		for(int i=0; i<width; i++) {
@@ -233,7 +236,7 @@ struct Map {
 					bool down_left=side_left&&!btm_edge&&(type-getType(tiles[ix(i-1, j+1)])>0);
 					bool down_right=side_right&&!btm_edge&&(type-getType(tiles[ix(i+1, j+1)])>0);
 					//choose random if both
-					if(down_left&&down_right) down_right=!(down_left=randFloat()<.5f);
+					if(down_left&&down_right) down_right=!(down_left=rng.next()>>31);
 					if(down_left) {
 						swaps.emplace_back(k, ix(i-1, j+1));
 						continue;
@@ -247,7 +250,7 @@ struct Map {
 				//THEN ADJACENT
 				if(props&TileProps::MoveSide) {
 					//choose random if both
-					if(side_left&&side_right) side_right=!(side_left=randFloat()<.5f);
+					if(side_left&&side_right) side_right=!(side_left=rng.next()>>31);
 					if(side_left) {
 						swaps.emplace_back(k, ix(i-1, j));
 						continue;
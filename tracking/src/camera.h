@@ -5,12 +5,82 @@
 //for memcpy
 #include <string>
 
+#include <vector>
+
+//for uint8_t, uint64_t
+#include <cstdint>
+
+//for fill, swap, min, max
+#include <algorithm>
+
+#if defined(__SSE2__)||defined(_M_X64)||(defined(_M_IX86_FP)&&_M_IX86_FP>=2)
+#define CAMERA_SSE2
+#include <emmintrin.h>
+#endif
+
+//world space triangle w/ lighting already applied,
+//  lit once per capture and shared by every camera.
+struct CaptureTri {
+	vf3d p[3];
+	vf3d norm;
+	olc::Pixel col;
+	std::uint8_t lum=0;
+};
+
+//same lighting as Engine3D::projectAndClip
+static void lightCaptureTris(const std::vector<cmn::Triangle>& tris, const std::vector<cmn::Light>& lights, float ambient, std::vector<CaptureTri>& out) {
+	out.resize(tris.size());
+	for(int i=0; i<tris.size(); i++) {
+		const auto& t=tris[i];
+		auto& c=out[i];
+		for(int j=0; j<3; j++) c.p[j]=t.p[j];
+		c.norm=t.getNorm();
+
+		vf3d light;
+		for(const auto& l:lights) {
+			vf3d light_dir=normalize(l.pos-t.getCtr());
+			float dp=std::max(0.f, dot(c.norm, light_dir));
+			light+=dp/255*vf3d(l.col.r, l.col.g, l.col.b);
+		}
+		light.x=std::clamp(light.x, ambient, 1.f);
+		light.y=std::clamp(light.y, ambient, 1.f);
+		light.z=std::clamp(light.z, ambient, 1.f);
+		c.col=t.col*olc::PixelF(light.x, light.y, light.z);
+
+		//.299, .587, .114 in 8 bits
+		c.lum=(77*c.col.r+150*c.col.g+29*c.col.b+128)>>8;
+	}
+}
+
 struct Camera {
 protected:
 	int width=0, height=0;
 
+	//per camera framebuffers so cameras can capture in parallel
+	std::vector<float> depth_buffer;
+	std::vector<std::uint8_t> curr_lum, prev_lum;
+
+	//for predicting where to look next
+	bool prev_guess_valid=false;
+	float prev_guess_x=0, prev_guess_y=0;
+
+	//extent of last movement, in pixels
+	int blob_x0=0, blob_y0=0;
+	int blob_x1=0, blob_y1=0;
+
+	int frames_since_full=0;
+
 	void copyFrom(const Camera&), clear();
 
+	void fillTriangle(vf3d, vf3d, vf3d, olc::Pixel, std::uint8_t);
+
+	struct Moments {
+		std::uint64_t w=0, x=0, y=0;
+		int x0=0, y0=0, x1=-1, y1=-1;
+	};
+
+	Moments accumulateMoments(int, int, int, int) const;
+
 public:
 	olc::Sprite* curr_spr=nullptr, * prev_spr=nullptr;
 
@@ -23,6 +93,16 @@ public:
 	bool guess_valid=false;
 	float guess_x=0, guess_y=0;
 
+	//search around predicted movement,
+	//  but check the whole frame every so often.
+	bool use_roi=true;
+	int full_scan_interval=8;
+	int num_full_scans=0, num_roi_scans=0;
+
+	//vertical fov of capture
+	float fov_deg=90;
+	float near_plane=.001f;
+
 	Camera() {}
 
 	Camera(
@@ -34,6 +114,10 @@ public:
 		curr_spr=new olc::Sprite(width, height);
 		prev_spr=new olc::Sprite(width, height);
 
+		depth_buffer.resize(width*height);
+		curr_lum.resize(width*height);
+		prev_lum.resize(width*height);
+
 		pos=p;
 		pseudo_up=u;
 
@@ -46,7 +130,7 @@ public:
 		copyFrom(c);
 	}
 
-	~Camera() {
+	virtual ~Camera() {
 		clear();
 	}
 
@@ -78,12 +162,39 @@ public:
 		return n.x*rgt+n.y*up+n.z*fwd;
 	}
 
-	void updateSprite(olc::Sprite* spr) {
-		for(int i=0; i<width; i++) {
-			for(int j=0; j<height; j++) {
-				float u=(.5f+i)/width;
-				float v=(.5f+j)/height;
-				curr_spr->SetPixel(i, j, spr->Sample(u, v));
+	//render straight into this cameras buffers
+	void capture(const std::vector<CaptureTri>& tris) {
+		olc::Pixel* col=curr_spr->GetData();
+		std::fill(col, col+width*height, olc::BLACK);
+		std::fill(depth_buffer.begin(), depth_buffer.end(), 0.f);
+		std::fill(curr_lum.begin(), curr_lum.end(), 0);
+
+		//pixels per unit at unit depth
+		const float f=.5f*height/std::tan(fov_deg/360*cmn::Pi);
+		const float cx=.5f*width, cy=.5f*height;
+		for(const auto& t:tris) {
+			//backface culling
+			if(dot(t.norm, t.p[0]-pos)>=0) continue;
+
+			//view space w/ z as depth
+			cmn::Triangle tri_view;
+			for(int i=0; i<3; i++) {
+				vf3d rel=t.p[i]-pos;
+				tri_view.p[i]={dot(rel, rgt), dot(rel, up), dot(rel, fwd)};
+			}
+
+			//clip against near plane
+			cmn::Triangle clipped[2];
+			int num=tri_view.clipAgainstPlane(vf3d(0, 0, near_plane), vf3d(0, 0, 1), clipped[0], clipped[1]);
+			for(int i=0; i<num; i++) {
+				//project, storing 1/depth
+				vf3d v[3];
+				for(int j=0; j<3; j++) {
+					const vf3d& p=clipped[i].p[j];
+					float inv_z=1/p.z;
+					v[j]={cx+f*p.x*inv_z, cy-f*p.y*inv_z, inv_z};
+				}
+				fillTriangle(v[0], v[1], v[2], t.col, t.lum);
 			}
 		}
 	}
@@ -95,34 +206,61 @@ public:
 	}
 
 	void updateGuess() {
-		const vf3d rgb_wgt(.299f, .587f, .114f);
+		//constant velocity guess
+		float dx=0, dy=0;
+		if(guess_valid&&prev_guess_valid) {
+			dx=guess_x-prev_guess_x;
+			dy=guess_y-prev_guess_y;
+		}
+		bool last_valid=guess_valid;
+		prev_guess_valid=guess_valid;
+		prev_guess_x=guess_x, prev_guess_y=guess_y;
 
 		guess_valid=false;
 
-		//luminance weighted average
-		const float pix_recip=1.f/255;
-		float x_sum=0, y_sum=0;
-		float w_sum=0;
-		for(int x=0; x<width; x++) {
-			for(int y=0; y<height; y++) {
-				olc::Pixel curr=curr_spr->GetPixel(x, y);
-				float curr_lum=dot(rgb_wgt, vf3d(curr.r, curr.g, curr.b));
-				
-				olc::Pixel prev=prev_spr->GetPixel(x, y);
-				float prev_lum=dot(rgb_wgt, vf3d(prev.r, prev.g, prev.b));
-
-				float lum_diff=pix_recip*std::abs(curr_lum-prev_lum);
-				x_sum+=lum_diff*x;
-				y_sum+=lum_diff*y;
-				w_sum+=lum_diff;
-			}
+		//search box around where movement should be
+		bool full=!use_roi||!last_valid||frames_since_full>=full_scan_interval;
+		int x0=0, y0=0, x1=width, y1=height;
+		if(!full) {
+			int mx=(blob_x1-blob_x0)/2+std::abs(int(dx))+16;
+			int my=(blob_y1-blob_y0)/2+std::abs(int(dy))+16;
+			x0=std::max(0, blob_x0+int(dx)-mx), x1=std::min(width, blob_x1+int(dx)+mx);
+			y0=std::max(0, blob_y0+int(dy)-my), y1=std::min(height, blob_y1+int(dy)+my);
+			if(x0>=x1||y0>=y1) full=true;
+		}
+
+		Moments m;
+		if(!full) {
+			m=accumulateMoments(x0, y0, x1, y1);
+			num_roi_scans++;
+
+			//nothing, or movement reaches the edge of the box:
+			//  it might go further, so look everywhere.
+			const int blk=16;
+			if(m.w==0||
+				(x0>0&&m.x0<x0+blk)||(x1<width&&m.x1>=x1-blk)||
+				(y0>0&&m.y0==y0)||(y1<height&&m.y1==y1-1)
+			) full=true;
 		}
-		if(w_sum<1e-6) return;
+		if(full) {
+			m=accumulateMoments(0, 0, width, height);
+			num_full_scans++;
+			frames_since_full=0;
+		} else frames_since_full++;
+		if(m.w==0) return;
 
 		//find position of movement
 		guess_valid=true;
-		guess_x=x_sum/w_sum;
-		guess_y=y_sum/w_sum;
+		guess_x=double(m.x)/m.w;
+		guess_y=double(m.y)/m.w;
+		blob_x0=m.x0, blob_x1=m.x1+1;
+		blob_y0=m.y0, blob_y1=m.y1+1;
+	}
+
+	//swap frames
+	void swapFrames() {
+		std::swap(curr_spr, prev_spr);
+		std::swap(curr_lum, prev_lum);
 	}
 };
 
@@ -136,6 +274,19 @@ void Camera::copyFrom(const Camera& c) {
 	prev_spr=new olc::Sprite(width, height);
 	std::memcpy(prev_spr->GetData(), c.prev_spr->GetData(), sizeof(olc::Pixel)*width*height);
 
+	depth_buffer=c.depth_buffer;
+	curr_lum=c.curr_lum;
+	prev_lum=c.prev_lum;
+
+	prev_guess_valid=c.prev_guess_valid;
+	prev_guess_x=c.prev_guess_x;
+	prev_guess_y=c.prev_guess_y;
+
+	blob_x0=c.blob_x0, blob_y0=c.blob_y0;
+	blob_x1=c.blob_x1, blob_y1=c.blob_y1;
+
+	frames_since_full=c.frames_since_full;
+
 	pos=c.pos;
 	pseudo_up=c.pseudo_up;
 
@@ -149,6 +300,14 @@ void Camera::copyFrom(const Camera& c) {
 	guess_valid=c.guess_valid;
 	guess_x=c.guess_x;
 	guess_y=c.guess_y;
+
+	use_roi=c.use_roi;
+	full_scan_interval=c.full_scan_interval;
+	num_full_scans=c.num_full_scans;
+	num_roi_scans=c.num_roi_scans;
+
+	fov_deg=c.fov_deg;
+	near_plane=c.near_plane;
 }
 
 void Camera::clear() {
@@ -157,4 +316,130 @@ void Camera::clear() {
 	delete prev_spr;
 	prev_spr=nullptr;
 }
+
+//xy=screen, z=1/depth.
+//  pixel centers inside [left, right) get filled.
+void Camera::fillTriangle(vf3d a, vf3d b, vf3d c, olc::Pixel col, std::uint8_t lum) {
+	//sort by y
+	if(b.y<a.y) std::swap(a, b);
+	if(c.y<a.y) std::swap(a, c);
+	if(c.y<b.y) std::swap(b, c);
+	if(c.y-a.y<1e-6f) return;
+
+	olc::Pixel* col_buf=curr_spr->GetData();
+
+	//first & last rows w/ centers inside
+	int j0=std::max(0, int(std::ceil(a.y-.5f)));
+	int j1=std::min(height, int(std::ceil(c.y-.5f)));
+	for(int j=j0; j<j1; j++) {
+		float y=.5f+j;
+
+		//long edge a-c & whichever short edge this row is on
+		float t=(y-a.y)/(c.y-a.y);
+		float xl=a.x+t*(c.x-a.x), zl=a.z+t*(c.z-a.z);
+		float xr, zr;
+		if(y<b.y) {
+			float s=(y-a.y)/(b.y-a.y);
+			xr=a.x+s*(b.x-a.x), zr=a.z+s*(b.z-a.z);
+		} else {
+			float s=c.y-b.y<1e-6f?1:(y-b.y)/(c.y-b.y);
+			xr=b.x+s*(c.x-b.x), zr=b.z+s*(c.z-b.z);
+		}
+		if(xr<xl) std::swap(xl, xr), std::swap(zl, zr);
+		if(xr-xl<1e-6f) continue;
+
+		int i0=std::max(0, int(std::ceil(xl-.5f)));
+		int i1=std::min(width, int(std::ceil(xr-.5f)));
+		float dz=(zr-zl)/(xr-xl);
+		float z=zl+dz*(.5f+i0-xl);
+		int ix=i0+width*j;
+		for(int i=i0; i<i1; i++, ix++, z+=dz) {
+			if(z>depth_buffer[ix]) {
+				depth_buffer[ix]=z;
+				col_buf[ix]=col;
+				curr_lum[ix]=lum;
+			}
+		}
+	}
+}
+
+//sum of |curr-prev|, weighted by x & y, over a box.
+//  also finds the extent of nonzero pixels, x to 16 pixels.
+Camera::Moments Camera::accumulateMoments(int x0, int y0, int x1, int y1) const {
+	Moments m;
+	m.x0=x1, m.y0=y1;
+	for(int y=y0; y<y1; y++) {
+		const std::uint8_t* a=curr_lum.data()+width*y;
+		const std::uint8_t* b=prev_lum.data()+width*y;
+
+		std::uint64_t row_w=0, row_x=0;
+		int first=-1, last=-1;
+		int x=x0;
+#ifdef CAMERA_SSE2
+		const __m128i zero=_mm_setzero_si128();
+		const __m128i lane_lo=_mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+		const __m128i lane_hi=_mm_setr_epi16(8, 9, 10, 11, 12, 13, 14, 15);
+
+		//chunks keep the 32 bit sums from overflowing
+		const int chunk=1024;
+		while(x+16<=x1) {
+			int cx=x;
+			int c_end=std::min(x1, cx+chunk);
+			__m128i w_acc=zero, x_acc=zero;
+			for(; x+16<=c_end; x+=16) {
+				__m128i va=_mm_loadu_si128((const __m128i*)(a+x));
+				__m128i vb=_mm_loadu_si128((const __m128i*)(b+x));
+				__m128i d=_mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+				if(_mm_movemask_epi8(_mm_cmpeq_epi8(d, zero))==0xFFFF) continue;
+
+				if(first<0) first=x;
+				last=x+15;
+
+				//horizontal byte sums
+				w_acc=_mm_add_epi64(w_acc, _mm_sad_epu8(d, zero));
+
+				//d*x in 16 bit pairs -> 32 bit
+				__m128i off=_mm_set1_epi16(short(x-cx));
+				__m128i d_lo=_mm_unpacklo_epi8(d, zero);
+				__m128i d_hi=_mm_unpackhi_epi8(d, zero);
+				x_acc=_mm_add_epi32(x_acc, _mm_madd_epi16(d_lo, _mm_add_epi16(off, lane_lo)));
+				x_acc=_mm_add_epi32(x_acc, _mm_madd_epi16(d_hi, _mm_add_epi16(off, lane_hi)));
+			}
+
+			std::uint64_t w2[2];
+			std::uint32_t x4[4];
+			_mm_storeu_si128((__m128i*)w2, w_acc);
+			_mm_storeu_si128((__m128i*)x4, x_acc);
+			std::uint64_t c_w=w2[0]+w2[1];
+			std::uint64_t c_x=std::uint64_t(x4[0])+x4[1]+x4[2]+x4[3];
+			row_w+=c_w;
+			row_x+=c_x+std::uint64_t(cx)*c_w;
+		}
+#endif
+		//leftovers
+		for(; x<x1; x++) {
+			int d=std::abs(int(a[x])-int(b[x]));
+			if(!d) continue;
+
+			if(first<0) first=x;
+			last=x;
+
+			row_w+=d;
+			row_x+=std::uint64_t(d)*x;
+		}
+		if(!row_w) continue;
+
+		m.w+=row_w;
+		m.x+=row_x;
+		m.y+=row_w*y;
+
+		//block bounds are only approximate, so clamp them
+		m.x0=std::min(m.x0, first);
+		m.x1=std::max(m.x1, std::min(last, x1-1));
+		m.y0=std::min(m.y0, y);
+		m.y1=std::max(m.y1, y);
+	}
+
+	return m;
+}
 #endif
\ No newline at end of file
@@ -5,6 +5,10 @@ using cmn::mat4;
 
 #include "cmn/utils.h"
 
+#include "cmn/stopwatch.h"
+
+#include "cmn/thread_pool.h"
+
 #include "mesh.h"
 
 #include "camera.h"
@@ -47,11 +51,14 @@ class TrackingUI : public cmn::Engine3D {
 
 	bool realize_renders=false;
 
-	//graphics stuff
-	olc::Sprite* render_spr=nullptr;
-
 	std::vector<Camera*> cams;
 
+	//null uses the shared pool
+	cmn::ThreadPool* pool=nullptr;
+
+	//scene each camera captures
+	std::vector<CaptureTri> capture_tris;
+
 	float track_timer=0;
 	struct Ray { vf3d orig, dir; };
 	std::vector<Ray> track_rays;
@@ -157,7 +164,9 @@ class TrackingUI : public cmn::Engine3D {
 		vf3d br=ctr-c_w/2*c.rgt-c_h/2*c.up;
 
 		//render billboard
-		handleCameraCapture(c, {{tl, br, tr}, {tl, bl, br}});
+		std::vector<CaptureTri> billboard;
+		lightCaptureTris({{tl, br, tr}, {tl, bl, br}}, {}, ambient_light, billboard);
+		c.capture(billboard);
 
 		//find bounding box of rendered pixels
 		int min_x=-1, min_y=-1;
@@ -187,7 +196,7 @@ class TrackingUI : public cmn::Engine3D {
 #pragma endregion
 
 	bool user_create() override {
-		std::srand(std::time(0));
+		cmn::seedRandom(std::time(0));
 
 		cam_pos={2.49f, 5.12f, 12.2f};
 		light_pos={3, 23, 11};
@@ -216,9 +225,6 @@ class TrackingUI : public cmn::Engine3D {
 			return false;
 		}
 
-		//setup render texture
-		render_spr=new olc::Sprite(ScreenWidth(), ScreenHeight());
-
 		placeCameras();
 
 		//get focal length of each camera
@@ -234,9 +240,6 @@ class TrackingUI : public cmn::Engine3D {
 	}
 
 	bool user_destroy() override {
-		delete render_spr;
-		render_spr=nullptr;
-
 		for(auto& c:cams) {
 			delete c;
 			c=nullptr;
@@ -246,38 +249,14 @@ class TrackingUI : public cmn::Engine3D {
 	}
 
 #pragma region UPDATE_HELPERS
-	void handleCameraCapture(Camera& c, const std::vector<cmn::Triangle> tris) {
-		//target tex & save pos
-		vf3d old_cam_pos=cam_pos;
-		vf3d old_cam_dir=cam_dir;
-		SetDrawTarget(render_spr);
-
-		//mini pipeline
-		cam_pos=c.pos;
-		cam_dir=c.fwd;
-		tris_to_project=tris;
-		projectAndClip();
-
-		//reset
-		resetBuffers();
-		Clear(olc::BLACK);
-
-		//rasterize
-		for(const auto& t:tris_to_draw) {
-			FillDepthTriangle(
-				t.p[0].x, t.p[0].y, t.t[0].z,
-				t.p[1].x, t.p[1].y, t.t[1].z,
-				t.p[2].x, t.p[2].y, t.t[2].z,
-				t.col, t.id
-			);
-		}
-
-		//reset target & pos
-		cam_pos=old_cam_pos;
-		cam_dir=old_cam_dir;
-		SetDrawTarget(nullptr);
-
-		c.updateSprite(render_spr);
+	//cameras only touch their own buffers,
+	//  so hand them out to threads one at a time.
+	template<typename F>
+	void forEachCamera(std::vector<Camera*>& list, const F& f) {
+		cmn::ThreadPool& p=pool?*pool:cmn::ThreadPool::shared();
+		p.parallelFor(0, list.size(), 1, [&] (int i0, int i1) {
+			for(int i=i0; i<i1; i++) f(*list[i]);
+		});
 	}
 
 	void handleCameraLooking(float dt) {
@@ -420,6 +399,8 @@ class TrackingUI : public cmn::Engine3D {
 		if(GetKey(olc::Key::F).bPressed) realize_frustums^=true;
 		if(GetKey(olc::Key::R).bPressed) realize_renders^=true;
 		if(GetKey(olc::Key::H).bPressed) help_menu^=true;
+
+		if(GetKey(olc::Key::B).bPressed) benchmarkTracking();
 	}
 
 	void handleModelMeshUpdate() {
@@ -458,15 +439,19 @@ class TrackingUI : public cmn::Engine3D {
 		realizeHouseMesh(mini_tris);
 		realizeModelMesh(mini_tris);
 
+		//light once for every camera
+		lightCaptureTris(mini_tris, {{light_pos, olc::WHITE}}, ambient_light, capture_tris);
+
+		//capture & compute motion
+		forEachCamera(cams, [&] (Camera& c) {
+			c.capture(capture_tris);
+			c.updateGuess();
+		});
+
+		//update rays
 		track_rays.clear();
 		for(const auto& c:cams) {
-			//capture & compute motion
-			handleCameraCapture(*c, mini_tris);
-			c->updateGuess();
-
-			//update rays
 			if(c->guess_valid) {
-				const float len=3.2f;
 				vf3d dir=c->getDir(c->guess_x, c->guess_y);
 				track_rays.push_back({c->pos, dir});
 			}
@@ -512,20 +497,89 @@ class TrackingUI : public cmn::Engine3D {
 			}
 		}
 
-		for(auto& c:cams) {
+		forEachCamera(cams, [&] (Camera& c) {
 			//for followers:
-			if(auto fc=dynamic_cast<FollowingCamera*>(c)) {
+			if(auto fc=dynamic_cast<FollowingCamera*>(&c)) {
 				//update angles
 				handleFollowing(*fc, dt);
 
 				//rerender to avoid tracking self movement
-				handleCameraCapture(*c, mini_tris);
-				c->updateGuess();
+				c.capture(capture_tris);
 			}
 
-			//swap frames
-			std::swap(c->curr_spr, c->prev_spr);
+			c.swapFrames();
+		});
+	}
+
+	//ring of high res cameras around the model,
+	//  capturing a few frames of it spinning.
+	void benchmarkTracking() {
+		const int num_cams=16, w=1280, h=960;
+		const int num_frames=12;
+
+		std::vector<cmn::Triangle> mini_tris;
+		realizeTerrainMesh(mini_tris);
+		realizeHouseMesh(mini_tris);
+		const std::size_t num_static=mini_tris.size();
+
+		struct Config { const char* name; bool roi; int threads; };
+		const Config configs[]{
+			{"full frame, 1 thread", false, 1},
+			{"roi, 1 thread", true, 1},
+			{"roi, all threads", true, 0}
+		};
+
+		std::cout<<"tracking benchmark: "<<num_cams<<" cameras at "<<w<<'x'<<h<<'\n';
+		const float old_rot=model.rotation.y;
+		cmn::ThreadPool* const old_pool=pool;
+		cmn::ThreadPool single(1);
+		cmn::Stopwatch watch;
+		for(const auto& cfg:configs) {
+			std::vector<Camera*> ring;
+			for(int i=0; i<num_cams; i++) {
+				float angle=2*cmn::Pi*i/num_cams;
+				vf3d p=model.translation+vf3d(7*std::cos(angle), 2.5f, 7*std::sin(angle));
+				ring.push_back(new Camera(w, h, p, {0, 1, 0}, normalize(model.translation-p)));
+				ring.back()->use_roi=cfg.roi;
+			}
+			pool=cfg.threads==1?&single:nullptr;
+
+			long long capture_us=0, guess_us=0;
+			model.rotation.y=old_rot;
+			for(int f=0; f<num_frames; f++) {
+				model.rotation.y+=.05f;
+				handleModelMeshUpdate();
+				mini_tris.resize(num_static);
+				realizeModelMesh(mini_tris);
+				lightCaptureTris(mini_tris, {{light_pos, olc::WHITE}}, ambient_light, capture_tris);
+
+				watch.start();
+				forEachCamera(ring, [&] (Camera& c) { c.capture(capture_tris); });
+				watch.stop();
+				capture_us+=watch.getMicros();
+
+				watch.start();
+				forEachCamera(ring, [&] (Camera& c) {
+					c.updateGuess();
+					c.swapFrames();
+				});
+				watch.stop();
+				guess_us+=watch.getMicros();
+			}
+
+			int roi_scans=0, full_scans=0;
+			for(auto& c:ring) {
+				roi_scans+=c->num_roi_scans;
+				full_scans+=c->num_full_scans;
+				delete c;
+			}
+			std::cout<<"  "<<cfg.name<<": capture "<<(capture_us/1000.f/num_frames)<<" ms, "
+				<<"guess "<<(guess_us/1000.f/num_frames)<<" ms per frame ("
+				<<roi_scans<<" roi scans, "<<full_scans<<" full scans)\n";
 		}
+		pool=old_pool;
+		model.rotation.y=old_rot;
+		handleModelMeshUpdate();
 	}
 #pragma endregion
 
@@ -793,6 +847,7 @@ class TrackingUI : public cmn::Engine3D {
 			DrawString(ScreenWidth()-8*18, 24, "G for model gizmo", use_gizmo?olc::WHITE:olc::RED);
 			DrawString(ScreenWidth()-8*18, 32, "R for render view", realize_renders?olc::WHITE:olc::RED);
 			DrawString(ScreenWidth()-8*19, 40, "F for frustum view", realize_frustums?olc::WHITE:olc::RED);
+			DrawString(ScreenWidth()-8*17, 48, "B for benchmark");
 
 			DrawString(cx-4*18, ScreenHeight()-8, "[Press H to close]");
 		} else {